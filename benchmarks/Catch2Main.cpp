@@ -21,3 +21,7 @@ int main (int argc, char* argv[])
 #include "catch2/catch_test_macros.hpp"
 
 #include "Benchmarks.cpp"
+#include "InterpolationBenchmarks.cpp"
+#include "PaintBenchmarks.cpp"
+#include "ProcessBlockBenchmarks.cpp"
+#include "SaturationBenchmarks.cpp"
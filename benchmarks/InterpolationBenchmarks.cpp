@@ -0,0 +1,104 @@
+// Tape head read cost per interpolation policy: all three heads on one channel of a
+// 512-sample slice at 48 kHz, default delay, wow and flutter at max so every fraction moves.
+// The sinc is meant for offline renders; the others are what a session can afford live.
+// The compact runs read a 16-bit tape, which adds the widening to the gather.
+
+namespace InterpolationBench
+{
+    constexpr int numSamples = 512;
+
+    struct Fixture
+    {
+        explicit Fixture(TapeRingBuffer<float>::Storage storage = TapeRingBuffer<float>::Storage::native)
+        {
+            tape.prepare(1, 48000 * 3, TapeInterpolation::maxTaps, storage);
+            juce::Random random(42);
+            for (int i = 0; i < tape.getCapacity(); ++i)
+                tape.write(0, i, (random.nextFloat() - 0.5f) * 0.5f);
+            tape.advance(12345);
+
+            kernel.prepare(numSamples);
+            for (int i = 0; i < numSamples; ++i)
+            {
+                kernel.getDelayArray()[i] = 300.0f * 48.0f;
+                kernel.getModulationArray()[i] = 50.0f * std::sin(0.002f * static_cast<float>(i)) + 5.0f * std::sin(0.09f * static_cast<float>(i));
+            }
+
+            kernel.computeHeadPositions({ { { 0.6f, 0.6f }, { 0.4f, 0.4f }, { 0.3f, 0.3f } } }, tape.getWritePosition(), tape.getMask(), numSamples);
+        }
+
+        template <typename Policy>
+        float read()
+        {
+            const float* echo = tape.isCompact() ? kernel.readHeads<Policy>(tape.getCompactReadPointer(0), 0, numSamples)
+                                                 : kernel.readHeads<Policy>(tape.getReadPointer(0), 0, numSamples);
+            return echo[numSamples - 1];
+        }
+
+        TapeRingBuffer<float> tape;
+        TapeReadKernel<float> kernel;
+    };
+}
+
+TEST_CASE ("Tape interpolation")
+{
+    InterpolationBench::Fixture fixture;
+
+    BENCHMARK ("Linear")
+    {
+        return fixture.read<TapeInterpolation::Linear>();
+    };
+
+    BENCHMARK ("Hermite")
+    {
+        return fixture.read<TapeInterpolation::Hermite>();
+    };
+
+    BENCHMARK ("Lagrange 4")
+    {
+        return fixture.read<TapeInterpolation::Lagrange<4>>();
+    };
+
+    BENCHMARK ("Lagrange 6")
+    {
+        return fixture.read<TapeInterpolation::Lagrange<6>>();
+    };
+
+    BENCHMARK ("Windowed sinc")
+    {
+        return fixture.read<TapeInterpolation::WindowedSinc>();
+    };
+}
+
+TEST_CASE ("Compact tape")
+{
+    InterpolationBench::Fixture native;
+    InterpolationBench::Fixture compact(TapeRingBuffer<float>::Storage::compact16);
+
+    std::vector<float> block(InterpolationBench::numSamples);
+    juce::Random random(7);
+    for (auto& sample : block)
+        sample = (random.nextFloat() - 0.5f) * 0.5f;
+
+    BENCHMARK ("Hermite read, native")
+    {
+        return native.read<TapeInterpolation::Hermite>();
+    };
+
+    BENCHMARK ("Hermite read, compact")
+    {
+        return compact.read<TapeInterpolation::Hermite>();
+    };
+
+    BENCHMARK ("Block write, native")
+    {
+        native.tape.write(0, native.tape.getWritePosition(), block.data(), InterpolationBench::numSamples);
+        return native.tape.read(0, native.tape.getWritePosition());
+    };
+
+    BENCHMARK ("Block write, compact")
+    {
+        compact.tape.write(0, compact.tape.getWritePosition(), block.data(), InterpolationBench::numSamples);
+        return compact.tape.read(0, compact.tape.getWritePosition());
+    };
+}
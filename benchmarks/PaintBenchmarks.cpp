@@ -0,0 +1,57 @@
+// Headless editor rendering: the whole component tree painted into an offscreen image,
+// with the cached chrome and knob bodies warm, cold (as after a resize), and at 2x scale.
+
+namespace PaintBench
+{
+    struct OpenEditor
+    {
+        explicit OpenEditor(PluginProcessor& p) : plugin(p), editor(p.createEditorIfNeeded()) {}
+
+        ~OpenEditor()
+        {
+            plugin.editorBeingDeleted(editor);
+            delete editor;
+        }
+
+        PluginEditor& get() { return *dynamic_cast<PluginEditor*>(editor); }
+
+        PluginProcessor& plugin;
+        juce::AudioProcessorEditor* editor;
+    };
+
+    inline int paintInto(juce::Component& component, juce::Image& canvas, float scale)
+    {
+        juce::Graphics g(canvas);
+        g.addTransform(juce::AffineTransform::scale(scale));
+        component.paintEntireComponent(g, true);
+        return canvas.getWidth();
+    }
+}
+
+TEST_CASE ("Editor paint")
+{
+    using namespace PaintBench;
+
+    PluginProcessor plugin;
+    OpenEditor open(plugin);
+    auto& editor = open.get();
+
+    juce::Image canvas(juce::Image::ARGB, editor.getWidth(), editor.getHeight(), true);
+    juce::Image canvas2x(juce::Image::ARGB, editor.getWidth() * 2, editor.getHeight() * 2, true);
+
+    BENCHMARK ("Full paint, warm caches")
+    {
+        return paintInto(editor, canvas, 1.0f);
+    };
+
+    BENCHMARK ("Full paint, cold caches")
+    {
+        editor.invalidateRenderCaches();
+        return paintInto(editor, canvas, 1.0f);
+    };
+
+    BENCHMARK ("Full paint at 2x, warm caches")
+    {
+        return paintInto(editor, canvas2x, 2.0f);
+    };
+}
@@ -0,0 +1,289 @@
+// processBlock throughput across block size, sample rate, channel count, sample
+// precision and the settings that change the cost of the audio path.
+//
+// Besides Catch2's own report for a few representative cases, the full matrix is
+// written to processBlock_benchmarks.csv / .json (in $CTD201_BENCHMARK_DIR, or the
+// working directory) so successive builds can be diffed.
+
+namespace ProcessBlockBench
+{
+    struct Config
+    {
+        int blockSize = 512;
+        double sampleRate = 48000.0;
+        int numChannels = 2;
+        bool headsOn = true;
+        bool reverbOn = true;
+        bool extremeModulation = false; // wow, flutter and saturation all at max
+        bool doublePrecision = false;
+
+        juce::String getName() const
+        {
+            return juce::String(blockSize) + " @ " + juce::String(sampleRate / 1000.0, 1) + "k "
+                   + (numChannels == 1 ? "mono" : numChannels == 2 ? "stereo" : juce::String(numChannels) + "ch")
+                   + (headsOn ? " heads" : " noheads")
+                   + (reverbOn ? " reverb" : " dry")
+                   + (extremeModulation ? " extreme" : " default")
+                   + (doublePrecision ? " double" : " float");
+        }
+    };
+
+    struct Result
+    {
+        Config config;
+        double nsPerSample = 0.0;
+        double realtimeFactor = 0.0;
+    };
+
+    inline void setParameter(PluginProcessor& plugin, const juce::String& id, float value)
+    {
+        if (auto* parameter = plugin.parameters.getParameter(id))
+            parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    }
+
+    template <typename SampleType>
+    void fillWithNoise(juce::AudioBuffer<SampleType>& buffer, juce::Random& random)
+    {
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        {
+            auto* data = buffer.getWritePointer(ch);
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                data[i] = static_cast<SampleType>((random.nextFloat() - 0.5f) * 0.5f);
+        }
+    }
+
+    inline void configure(PluginProcessor& plugin, const Config& config)
+    {
+        setParameter(plugin, "head1", config.headsOn ? 1.0f : 0.0f);
+        setParameter(plugin, "head2", config.headsOn ? 1.0f : 0.0f);
+        setParameter(plugin, "head3", config.headsOn ? 1.0f : 0.0f);
+        setParameter(plugin, "reverbMix", config.reverbOn ? 0.4f : 0.0f);
+
+        const float modulation = config.extremeModulation ? 1.0f : 0.1f;
+        setParameter(plugin, "wow", modulation);
+        setParameter(plugin, "flutter", modulation);
+        setParameter(plugin, "saturation", config.extremeModulation ? 1.0f : 0.2f);
+
+        // The host picks the precision before prepareToPlay
+        plugin.setProcessingPrecision(config.doublePrecision ? juce::AudioProcessor::doublePrecision
+                                                             : juce::AudioProcessor::singlePrecision);
+        plugin.setPlayConfigDetails(config.numChannels, config.numChannels, config.sampleRate, config.blockSize);
+        plugin.prepareToPlay(config.sampleRate, config.blockSize);
+    }
+
+    // The convolution engine loads its IR in the background; time it only once it is live
+    template <typename SampleType>
+    void waitForReverb(PluginProcessor& plugin, juce::AudioBuffer<SampleType>& buffer, juce::MidiBuffer& midi)
+    {
+        const auto deadline = juce::Time::getMillisecondCounter() + 2000;
+        while (plugin.reverbConvolver.getCurrentIRSize() == 0 && juce::Time::getMillisecondCounter() < deadline)
+        {
+            plugin.processBlock(buffer, midi);
+            juce::Thread::sleep(1);
+        }
+    }
+
+    // Renders at least `secondsOfAudio` and returns the cost per sample frame
+    template <typename SampleType>
+    Result measureWith(const Config& config, double secondsOfAudio)
+    {
+        PluginProcessor plugin;
+        configure(plugin, config);
+
+        juce::AudioBuffer<SampleType> buffer(config.numChannels, config.blockSize);
+        juce::MidiBuffer midi;
+        juce::Random random(42);
+        fillWithNoise(buffer, random);
+
+        waitForReverb(plugin, buffer, midi);
+
+        // Warm caches, smoothers and branch predictors
+        for (int i = 0; i < 8; ++i)
+            plugin.processBlock(buffer, midi);
+
+        const int numBlocks = juce::jmax(16, static_cast<int>(secondsOfAudio * config.sampleRate / config.blockSize));
+        double elapsedSeconds = 0.0;
+
+        for (int i = 0; i < numBlocks; ++i)
+        {
+            fillWithNoise(buffer, random);
+            const auto start = juce::Time::getHighResolutionTicks();
+            plugin.processBlock(buffer, midi);
+            elapsedSeconds += juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+        }
+
+        plugin.releaseResources();
+
+        const double numFrames = static_cast<double>(numBlocks) * config.blockSize;
+        Result result;
+        result.config = config;
+        result.nsPerSample = elapsedSeconds * 1.0e9 / numFrames;
+        result.realtimeFactor = elapsedSeconds > 0.0 ? (numFrames / config.sampleRate) / elapsedSeconds : 0.0;
+        return result;
+    }
+
+    inline Result measure(const Config& config, double secondsOfAudio = 0.25)
+    {
+        return config.doublePrecision ? measureWith<double>(config, secondsOfAudio)
+                                      : measureWith<float>(config, secondsOfAudio);
+    }
+
+    inline juce::File getOutputDirectory()
+    {
+        const auto dir = juce::SystemStats::getEnvironmentVariable("CTD201_BENCHMARK_DIR", {});
+        return dir.isEmpty() ? juce::File::getCurrentWorkingDirectory() : juce::File(dir);
+    }
+
+    // Writes <name>.csv and <name>.json next to each other
+    inline void writeResults(const juce::String& name, const std::vector<Result>& results)
+    {
+        const auto dir = getOutputDirectory();
+        dir.createDirectory();
+
+        juce::String csv = "block_size,sample_rate,channels,heads,reverb,modulation,precision,ns_per_sample,realtime_factor\n";
+        juce::Array<juce::var> rows;
+
+        for (const auto& r : results)
+        {
+            const auto& c = r.config;
+            csv << c.blockSize << "," << c.sampleRate << "," << c.numChannels << ","
+                << (c.headsOn ? "on" : "off") << "," << (c.reverbOn ? "on" : "off") << ","
+                << (c.extremeModulation ? "extreme" : "default") << ","
+                << (c.doublePrecision ? "double" : "float") << ","
+                << juce::String(r.nsPerSample, 3) << "," << juce::String(r.realtimeFactor, 2) << "\n";
+
+            auto* row = new juce::DynamicObject();
+            row->setProperty("name", c.getName());
+            row->setProperty("block_size", c.blockSize);
+            row->setProperty("sample_rate", c.sampleRate);
+            row->setProperty("channels", c.numChannels);
+            row->setProperty("heads", c.headsOn);
+            row->setProperty("reverb", c.reverbOn);
+            row->setProperty("extreme_modulation", c.extremeModulation);
+            row->setProperty("double_precision", c.doublePrecision);
+            row->setProperty("ns_per_sample", r.nsPerSample);
+            row->setProperty("realtime_factor", r.realtimeFactor);
+            rows.add(juce::var(row));
+        }
+
+        auto* root = new juce::DynamicObject();
+        root->setProperty("version", VERSION);
+        root->setProperty("build_type", CMAKE_BUILD_TYPE);
+        root->setProperty("results", rows);
+
+        dir.getChildFile(name + ".csv").replaceWithText(csv);
+        dir.getChildFile(name + ".json").replaceWithText(juce::JSON::toString(juce::var(root)));
+    }
+}
+
+TEST_CASE ("processBlock throughput")
+{
+    using namespace ProcessBlockBench;
+
+    // A few representative cases through Catch2's statistics
+    for (int blockSize : { 64, 512 })
+    {
+        Config config;
+        config.blockSize = blockSize;
+
+        BENCHMARK_ADVANCED ("processBlock " + config.getName().toStdString())
+        (Catch::Benchmark::Chronometer meter)
+        {
+            PluginProcessor plugin;
+            configure(plugin, config);
+
+            juce::AudioBuffer<float> buffer(config.numChannels, config.blockSize);
+            juce::MidiBuffer midi;
+            juce::Random random(42);
+            fillWithNoise(buffer, random);
+            waitForReverb(plugin, buffer, midi);
+
+            meter.measure([&] { plugin.processBlock(buffer, midi); });
+        };
+    }
+}
+
+TEST_CASE ("processBlock throughput matrix")
+{
+    using namespace ProcessBlockBench;
+
+    std::vector<Result> results;
+
+    for (int blockSize : { 32, 64, 128, 256, 512, 1024, 2048, 4096 })
+        for (double sampleRate : { 44100.0, 48000.0, 96000.0, 192000.0 })
+            for (int numChannels : { 1, 2, 6, 8 })
+                for (bool headsOn : { true, false })
+                    for (bool reverbOn : { false, true })
+                        for (bool extreme : { false, true })
+                        {
+                            Config config;
+                            config.blockSize = blockSize;
+                            config.sampleRate = sampleRate;
+                            config.numChannels = numChannels;
+                            config.headsOn = headsOn;
+                            config.reverbOn = reverbOn;
+                            config.extremeModulation = extreme;
+
+                            results.push_back(measure(config));
+                        }
+
+    writeResults("processBlock_benchmarks", results);
+
+    for (const auto& r : results)
+        CHECK(r.realtimeFactor > 0.0);
+}
+
+TEST_CASE ("processBlock float vs double")
+{
+    using namespace ProcessBlockBench;
+
+    // Same settings through both engines, side by side in Catch2's report
+    for (bool doublePrecision : { false, true })
+    {
+        Config config;
+        config.doublePrecision = doublePrecision;
+
+        BENCHMARK_ADVANCED ("processBlock " + config.getName().toStdString())
+        (Catch::Benchmark::Chronometer meter)
+        {
+            PluginProcessor plugin;
+            configure(plugin, config);
+
+            juce::AudioBuffer<double> doubleBuffer(config.numChannels, config.blockSize);
+            juce::AudioBuffer<float> floatBuffer(config.numChannels, config.blockSize);
+            juce::MidiBuffer midi;
+            juce::Random random(42);
+
+            if (doublePrecision)
+            {
+                fillWithNoise(doubleBuffer, random);
+                waitForReverb(plugin, doubleBuffer, midi);
+                meter.measure([&] { plugin.processBlock(doubleBuffer, midi); });
+            }
+            else
+            {
+                fillWithNoise(floatBuffer, random);
+                waitForReverb(plugin, floatBuffer, midi);
+                meter.measure([&] { plugin.processBlock(floatBuffer, midi); });
+            }
+        };
+    }
+
+    // And the per-sample cost at a few block sizes, for the CSV
+    std::vector<Result> results;
+    for (int blockSize : { 64, 512, 2048 })
+        for (int numChannels : { 2, 8 })
+            for (bool doublePrecision : { false, true })
+            {
+                Config config;
+                config.blockSize = blockSize;
+                config.numChannels = numChannels;
+                config.doublePrecision = doublePrecision;
+                results.push_back(measure(config));
+            }
+
+    writeResults("processBlock_precision", results);
+
+    for (const auto& r : results)
+        CHECK(r.realtimeFactor > 0.0);
+}
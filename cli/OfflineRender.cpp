@@ -0,0 +1,282 @@
+// Headless batch renderer: streams audio files through PluginProcessor without an editor.
+//
+//   CTD201Render [options] <input files...>
+//
+//   --out-dir <dir>        where rendered files go (default: next to each input)
+//   --suffix <text>        appended to the output file name (default: "_ctd201")
+//   --state <file>         state blob saved by the plugin (getStateInformation)
+//   --param <id>=<value>   parameter in its real units, e.g. --param feedback=0.6 (repeatable)
+//   --jobs <n>             worker threads, one processor each (default: number of cores)
+//   --block-size <n>       samples per processBlock call (default: 4096)
+//   --tail <seconds>       extra silence rendered after the input so echoes can ring out
+
+#include "PluginProcessor.h"
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+    struct RenderSettings
+    {
+        juce::File outputDirectory;
+        juce::String suffix = "_ctd201";
+        juce::MemoryBlock state;
+        juce::StringPairArray parameterValues;
+        int numJobs = juce::jmax(1, static_cast<int>(std::thread::hardware_concurrency()));
+        int blockSize = 4096;
+        double tailSeconds = 0.0;
+        juce::Array<juce::File> inputFiles;
+    };
+
+    std::mutex consoleLock;
+
+    void log(const juce::String& message)
+    {
+        const std::lock_guard<std::mutex> lock(consoleLock);
+        std::cout << message << std::endl;
+    }
+
+    void printUsage()
+    {
+        std::cout << "Usage: CTD201Render [--out-dir dir] [--suffix text] [--state file] [--param id=value ...]\n"
+                     "                    [--jobs n] [--block-size n] [--tail seconds] <input files...>"
+                  << std::endl;
+    }
+
+    bool parseArguments(int argc, char* argv[], RenderSettings& settings)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const juce::String arg(argv[i]);
+            auto next = [&]() -> juce::String { return ++i < argc ? juce::String(argv[i]) : juce::String(); };
+
+            if (arg == "--out-dir")
+                settings.outputDirectory = juce::File::getCurrentWorkingDirectory().getChildFile(next());
+            else if (arg == "--suffix")
+                settings.suffix = next();
+            else if (arg == "--state")
+            {
+                auto stateFile = juce::File::getCurrentWorkingDirectory().getChildFile(next());
+                if (!stateFile.loadFileAsData(settings.state))
+                {
+                    std::cerr << "Could not read state file " << stateFile.getFullPathName() << std::endl;
+                    return false;
+                }
+            }
+            else if (arg == "--param")
+            {
+                const auto assignment = next();
+                if (!assignment.containsChar('='))
+                {
+                    std::cerr << "Expected --param id=value, got " << assignment << std::endl;
+                    return false;
+                }
+                settings.parameterValues.set(assignment.upToFirstOccurrenceOf("=", false, false).trim(),
+                    assignment.fromFirstOccurrenceOf("=", false, false).trim());
+            }
+            else if (arg == "--jobs")
+                settings.numJobs = juce::jmax(1, next().getIntValue());
+            else if (arg == "--block-size")
+                settings.blockSize = juce::jlimit(32, 65536, next().getIntValue());
+            else if (arg == "--tail")
+                settings.tailSeconds = juce::jmax(0.0, next().getDoubleValue());
+            else if (arg == "--help" || arg == "-h")
+                return false;
+            else if (arg.startsWith("--"))
+            {
+                std::cerr << "Unknown option " << arg << std::endl;
+                return false;
+            }
+            else
+                settings.inputFiles.add(juce::File::getCurrentWorkingDirectory().getChildFile(arg));
+        }
+
+        return !settings.inputFiles.isEmpty();
+    }
+
+    // Applies the saved state first, then any --param overrides on top
+    bool configureProcessor(PluginProcessor& processor, const RenderSettings& settings)
+    {
+        if (!settings.state.isEmpty())
+            processor.setStateInformation(settings.state.getData(), static_cast<int>(settings.state.getSize()));
+
+        for (const auto& id : settings.parameterValues.getAllKeys())
+        {
+            auto* parameter = processor.parameters.getParameter(id);
+            if (parameter == nullptr)
+            {
+                std::cerr << "Unknown parameter " << id << std::endl;
+                return false;
+            }
+
+            const float value = settings.parameterValues[id].getFloatValue();
+            parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+        }
+
+        return true;
+    }
+
+    // The convolution engine loads its impulse response on a background thread.
+    // Feed silence until it is installed so the first rendered samples already have reverb.
+    void waitForReverb(PluginProcessor& processor, juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi)
+    {
+        // A custom IR from the saved state is decoded on the loader thread first
+        processor.waitForImpulseResponse(10000);
+
+        const auto deadline = juce::Time::getMillisecondCounter() + 2000;
+
+        while (processor.reverbConvolver.getCurrentIRSize() == 0 && juce::Time::getMillisecondCounter() < deadline)
+        {
+            buffer.clear();
+            processor.processBlock(buffer, midi);
+            juce::Thread::sleep(2);
+        }
+
+        // Let the convolution crossfade to the new engine settle
+        for (int i = 0; i < 4; ++i)
+        {
+            buffer.clear();
+            processor.processBlock(buffer, midi);
+        }
+    }
+
+    bool renderFile(PluginProcessor& processor, juce::AudioFormatManager& formats, const juce::File& input, const RenderSettings& settings)
+    {
+        std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(input));
+        if (reader == nullptr)
+        {
+            log("Skipping " + input.getFullPathName() + ": unsupported or unreadable file");
+            return false;
+        }
+
+        const int numChannels = static_cast<int>(reader->numChannels);
+        if (numChannels < 1 || numChannels > PluginProcessor::maxChannels)
+        {
+            log("Skipping " + input.getFullPathName() + ": only files of 1 to " + juce::String(PluginProcessor::maxChannels) + " channels are supported");
+            return false;
+        }
+
+        auto outputDirectory = settings.outputDirectory == juce::File() ? input.getParentDirectory() : settings.outputDirectory;
+        auto output = outputDirectory.getChildFile(input.getFileNameWithoutExtension() + settings.suffix + input.getFileExtension());
+        output.deleteFile();
+
+        auto* format = formats.findFormatForFileExtension(input.getFileExtension());
+        std::unique_ptr<juce::OutputStream> stream = std::make_unique<juce::FileOutputStream>(output);
+        if (format == nullptr || !static_cast<juce::FileOutputStream*>(stream.get())->openedOk())
+        {
+            log("Skipping " + input.getFullPathName() + ": cannot write " + output.getFullPathName());
+            return false;
+        }
+
+        std::unique_ptr<juce::AudioFormatWriter> writer(format->createWriterFor(stream.get(),
+            reader->sampleRate,
+            static_cast<unsigned int>(numChannels),
+            static_cast<int>(reader->bitsPerSample),
+            reader->metadataValues,
+            0));
+        if (writer == nullptr)
+        {
+            log("Skipping " + input.getFullPathName() + ": no writer for this format/bit depth");
+            return false;
+        }
+        stream.release(); // now owned by the writer
+
+        // One processor is reused for every file this worker renders; prepareToPlay resets the tape
+        const int blockSize = settings.blockSize;
+        processor.setNonRealtime(true);
+        // Buses in the file's canonical layout (mono, stereo, LCR ... 7.1), which the processor accepts
+        processor.setPlayConfigDetails(numChannels, numChannels, reader->sampleRate, blockSize);
+        processor.prepareToPlay(reader->sampleRate, blockSize);
+
+        juce::AudioBuffer<float> buffer(numChannels, blockSize);
+        juce::MidiBuffer midi;
+        waitForReverb(processor, buffer, midi);
+
+        const auto inputLength = reader->lengthInSamples;
+        const auto totalLength = inputLength + static_cast<juce::int64>(settings.tailSeconds * reader->sampleRate);
+        const double startMs = juce::Time::getMillisecondCounterHiRes();
+
+        for (juce::int64 position = 0; position < totalLength; position += blockSize)
+        {
+            const int numSamples = static_cast<int>(juce::jmin(static_cast<juce::int64>(blockSize), totalLength - position));
+            juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), numChannels, 0, numSamples);
+
+            // Past the end of the file the reader fills with silence, which renders the tail
+            reader->read(&block, 0, numSamples, position, true, true);
+            processor.processBlock(block, midi);
+            writer->writeFromAudioSampleBuffer(block, 0, numSamples);
+        }
+
+        const double elapsedSeconds = (juce::Time::getMillisecondCounterHiRes() - startMs) / 1000.0;
+        const double audioSeconds = static_cast<double>(totalLength) / reader->sampleRate;
+        const double realtimeFactor = elapsedSeconds > 0.0 ? audioSeconds / elapsedSeconds : 0.0;
+
+        processor.releaseResources();
+
+        log(input.getFileName() + " -> " + output.getFullPathName()
+            + juce::String::formatted(": %.2f s audio in %.3f s (%.1fx realtime)", audioSeconds, elapsedSeconds, realtimeFactor));
+        return true;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    // The APVTS needs a message manager, just like in the tests
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    RenderSettings settings;
+    if (!parseArguments(argc, argv, settings))
+    {
+        printUsage();
+        return 1;
+    }
+
+    if (settings.outputDirectory != juce::File() && !settings.outputDirectory.createDirectory())
+    {
+        std::cerr << "Cannot create output directory " << settings.outputDirectory.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    const int numWorkers = juce::jmin(settings.numJobs, settings.inputFiles.size());
+
+    // Processors are created and configured here on the message thread; workers only render
+    std::vector<std::unique_ptr<PluginProcessor>> processors;
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        processors.push_back(std::make_unique<PluginProcessor>());
+        if (!configureProcessor(*processors.back(), settings))
+            return 1;
+    }
+
+    std::atomic<int> nextFile { 0 };
+    std::atomic<int> numFailed { 0 };
+    std::vector<std::thread> workers;
+    const double startMs = juce::Time::getMillisecondCounterHiRes();
+
+    for (int w = 0; w < numWorkers; ++w)
+    {
+        workers.emplace_back([&, w] {
+            juce::AudioFormatManager formats;
+            formats.registerBasicFormats();
+
+            for (int i = nextFile++; i < settings.inputFiles.size(); i = nextFile++)
+                if (!renderFile(*processors[static_cast<size_t>(w)], formats, settings.inputFiles[i], settings))
+                    ++numFailed;
+        });
+    }
+
+    for (auto& worker : workers)
+        worker.join();
+
+    const double totalSeconds = (juce::Time::getMillisecondCounterHiRes() - startMs) / 1000.0;
+    log(juce::String::formatted("Rendered %d of %d files with %d workers in %.2f s",
+        settings.inputFiles.size() - numFailed.load(),
+        settings.inputFiles.size(),
+        numWorkers,
+        totalSeconds));
+
+    return numFailed.load() == 0 ? 0 : 2;
+}
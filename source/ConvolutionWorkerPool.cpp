@@ -0,0 +1,311 @@
+#include "ConvolutionWorkerPool.h"
+#include <thread>
+
+#if JUCE_MAC || JUCE_IOS
+#include <dispatch/dispatch.h>
+#elif JUCE_WINDOWS
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <semaphore.h>
+#endif
+
+namespace
+{
+    // What a parked worker waits on. juce::Thread::notify() signals a WaitableEvent, which
+    // locks a mutex; post() here is the OS semaphore, an atomic increment that only enters
+    // the kernel to wake a thread that is actually waiting. Safe from the audio thread.
+    class WakeSemaphore
+    {
+    public:
+#if JUCE_MAC || JUCE_IOS
+        WakeSemaphore() : semaphore(dispatch_semaphore_create(0)) {}
+        ~WakeSemaphore() { dispatch_release(semaphore); }
+
+        void post() noexcept { dispatch_semaphore_signal(semaphore); }
+        void wait() noexcept { dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER); }
+
+    private:
+        dispatch_semaphore_t semaphore;
+#elif JUCE_WINDOWS
+        WakeSemaphore() : semaphore(CreateSemaphoreW(nullptr, 0, LONG_MAX, nullptr)) {}
+        ~WakeSemaphore() { CloseHandle(semaphore); }
+
+        void post() noexcept { ReleaseSemaphore(semaphore, 1, nullptr); }
+        void wait() noexcept { WaitForSingleObject(semaphore, INFINITE); }
+
+    private:
+        HANDLE semaphore;
+#else
+        WakeSemaphore() { sem_init(&semaphore, 0, 0); }
+        ~WakeSemaphore() { sem_destroy(&semaphore); }
+
+        void post() noexcept { sem_post(&semaphore); }
+        void wait() noexcept
+        {
+            while (sem_wait(&semaphore) != 0 && errno == EINTR) {}
+        }
+
+    private:
+        sem_t semaphore;
+#endif
+
+        JUCE_DECLARE_NON_COPYABLE(WakeSemaphore)
+    };
+}
+
+//==============================================================================
+ConvolutionWorkerPool::SlotQueue::SlotQueue()
+{
+    for (size_t i = 0; i < capacity; ++i)
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+bool ConvolutionWorkerPool::SlotQueue::push(int slot) noexcept
+{
+    size_t position = enqueuePosition.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        auto& cell = cells[position & (capacity - 1)];
+        const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        const auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+
+        if (difference == 0)
+        {
+            if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                cell.slot = slot;
+                cell.sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (difference < 0)
+        {
+            return false; // full
+        }
+        else
+        {
+            position = enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool ConvolutionWorkerPool::SlotQueue::pop(int& slot) noexcept
+{
+    size_t position = dequeuePosition.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        auto& cell = cells[position & (capacity - 1)];
+        const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        const auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1);
+
+        if (difference == 0)
+        {
+            if (dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                slot = cell.slot;
+                cell.sequence.store(position + capacity, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (difference < 0)
+        {
+            return false; // empty
+        }
+        else
+        {
+            position = dequeuePosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+//==============================================================================
+class ConvolutionWorkerPool::Worker : private juce::Thread
+{
+public:
+    Worker(ConvolutionWorkerPool& poolToUse, int index)
+        : juce::Thread("CTD201 Convolution " + juce::String(index + 1)),
+          pool(poolToUse),
+          workerIndex(index)
+    {
+        startThread(juce::Thread::Priority::high);
+    }
+
+    ~Worker() override
+    {
+        signalThreadShouldExit();
+        wake.post();
+        stopThread(2000);
+    }
+
+    // Any thread, the audio thread included: never locks. Wakes the worker if it is
+    // parked waiting for work; true if it was.
+    bool wakeIfSleeping() noexcept
+    {
+        if (!sleeping.load() || !sleeping.exchange(false))
+            return false;
+
+        wake.post();
+        return true;
+    }
+
+private:
+    void run() override
+    {
+        int idleRounds = 0;
+        while (!threadShouldExit())
+        {
+            if (pool.runNext(workerIndex))
+            {
+                idleRounds = 0;
+                continue;
+            }
+
+            // Jobs arrive every partition; stay responsive for a moment, then block until
+            // notify() has something. Spinning, the worker costs the audio thread nothing.
+            if (++idleRounds < 64)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            // Marked before the queues are looked at once more, so a slot pushed after
+            // that look finds the worker asleep and posts (the semaphore keeps a post that
+            // comes before the wait; a stale one only costs an extra round)
+            sleeping.store(true);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (pool.runNext(workerIndex))
+            {
+                sleeping.store(false);
+                idleRounds = 0;
+                continue;
+            }
+
+            wake.wait();
+            sleeping.store(false);
+            idleRounds = 0;
+        }
+    }
+
+    ConvolutionWorkerPool& pool;
+    const int workerIndex;
+    std::atomic<bool> sleeping { false };
+    WakeSemaphore wake;
+};
+
+//==============================================================================
+ConvolutionWorkerPool::ConvolutionWorkerPool()
+{
+    // Leave one core for the host's own audio threads
+    numWorkers = juce::jlimit(1, maxWorkers, juce::SystemStats::getNumCpus() - 1);
+
+    for (int i = 0; i < numWorkers; ++i)
+        queues[static_cast<size_t>(i)] = std::make_unique<SlotQueue>();
+
+    for (int i = 0; i < numWorkers; ++i)
+        workers[static_cast<size_t>(i)] = std::make_unique<Worker>(*this, i);
+}
+
+ConvolutionWorkerPool::~ConvolutionWorkerPool()
+{
+    for (auto& worker : workers)
+        worker.reset();
+}
+
+int ConvolutionWorkerPool::add(Client* client)
+{
+    const std::lock_guard<std::mutex> scopedLock(lock);
+
+    for (int i = 0; i < maxClients; ++i)
+    {
+        if (!slotInUse[static_cast<size_t>(i)])
+        {
+            slotInUse[static_cast<size_t>(i)] = true;
+            slots[static_cast<size_t>(i)].client.store(client);
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+void ConvolutionWorkerPool::remove(int slot)
+{
+    if (slot < 0 || slot >= maxClients) return;
+
+    const std::lock_guard<std::mutex> scopedLock(lock);
+    auto& entry = slots[static_cast<size_t>(slot)];
+
+    // A worker marks the slot running before it loads the client, so after this either
+    // it sees nullptr or we see it running and wait for it to leave
+    entry.client.store(nullptr);
+    while (entry.running.load())
+        std::this_thread::yield();
+
+    slotInUse[static_cast<size_t>(slot)] = false;
+}
+
+void ConvolutionWorkerPool::notify(int slot) noexcept
+{
+    jassert(slot >= 0 && slot < maxClients);
+
+    // Already waiting in a queue: it will see the new jobs when it runs
+    if (slots[static_cast<size_t>(slot)].queued.exchange(true, std::memory_order_acq_rel))
+        return;
+
+    const int owner = slot % numWorkers;
+    queues[static_cast<size_t>(owner)]->push(slot);
+    std::atomic_thread_fence(std::memory_order_seq_cst); // pairs with the worker's, before it sleeps
+
+    // The queue's own worker if it is asleep, else any sleeping one steals it. Busy or
+    // spinning workers find it themselves, so the usual case signals nothing.
+    if (workers[static_cast<size_t>(owner)]->wakeIfSleeping())
+        return;
+
+    for (int i = 1; i < numWorkers; ++i)
+        if (workers[static_cast<size_t>((owner + i) % numWorkers)]->wakeIfSleeping())
+            return;
+}
+
+bool ConvolutionWorkerPool::runNext(int workerIndex) noexcept
+{
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        auto& queue = *queues[static_cast<size_t>((workerIndex + i) % numWorkers)];
+
+        int slot = -1;
+        if (queue.pop(slot))
+            return runSlot(slot, *queues[static_cast<size_t>(workerIndex)]);
+    }
+
+    return false;
+}
+
+bool ConvolutionWorkerPool::runSlot(int slot, SlotQueue& queue) noexcept
+{
+    auto& entry = slots[static_cast<size_t>(slot)];
+
+    // Another worker is still running this client: requeue it (it stays marked queued)
+    if (entry.running.exchange(true))
+    {
+        queue.push(slot);
+        std::this_thread::yield();
+        return false;
+    }
+
+    // Cleared before running, so jobs submitted from here on queue the slot again
+    entry.queued.store(false, std::memory_order_release);
+
+    bool didWork = false;
+    if (auto* client = entry.client.load())
+        didWork = client->runBackgroundWork();
+
+    entry.running.store(false, std::memory_order_release);
+    return didWork;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+// Process-wide worker threads for the FFT partition jobs of every PartitionedConvolver.
+//
+// One pool per process (held through juce::SharedResourcePointer), one worker per spare
+// core. An instance registers once and gets a slot; when its audio callback submits
+// jobs it calls notify(slot), which is lock-free and allocation-free: the slot index is
+// pushed onto one worker's bounded MPMC queue, and idle workers steal from the others,
+// so the partition work of a busy session spreads over every idle core instead of
+// adding to whichever host thread runs the track. A worker that has been idle for a
+// while parks on an OS semaphore; waking it is a semaphore post (no lock, one system
+// call), and a worker that is busy or still spinning is not signalled at all.
+//
+// A slot is only ever run by one worker at a time, so a client sees its
+// runBackgroundWork() calls serialised, exactly as with a single background thread.
+class ConvolutionWorkerPool
+{
+public:
+    class Client
+    {
+    public:
+        virtual ~Client() = default;
+
+        // Runs whatever jobs are pending. Returns true if it did any work.
+        virtual bool runBackgroundWork() = 0;
+    };
+
+    static constexpr int maxClients = 1024;
+    static constexpr int maxWorkers = 8;
+
+    ConvolutionWorkerPool();
+    ~ConvolutionWorkerPool();
+
+    // Message thread. Returns the client's slot, or -1 if every slot is taken.
+    int add(Client* client);
+
+    // Message thread. Returns once no worker is inside the slot's runBackgroundWork(),
+    // and none will enter it again.
+    void remove(int slot);
+
+    // Audio thread: schedules the slot's client to run. Never waits or locks; it only posts
+    // a worker's semaphore when that worker has parked.
+    void notify(int slot) noexcept;
+
+    int getNumWorkers() const noexcept { return numWorkers; }
+
+private:
+    struct Slot
+    {
+        std::atomic<Client*> client { nullptr };
+        std::atomic<bool> queued { false };
+        std::atomic<bool> running { false };
+    };
+
+    // Bounded multi-producer multi-consumer queue of slot indices (Vyukov). Every slot
+    // is in at most one queue at a time, so it can never fill up.
+    class SlotQueue
+    {
+    public:
+        SlotQueue();
+
+        bool push(int slot) noexcept;
+        bool pop(int& slot) noexcept;
+
+    private:
+        struct Cell
+        {
+            std::atomic<size_t> sequence { 0 };
+            int slot = -1;
+        };
+
+        static constexpr size_t capacity = maxClients; // power of two
+        std::array<Cell, capacity> cells;
+        alignas(64) std::atomic<size_t> enqueuePosition { 0 };
+        alignas(64) std::atomic<size_t> dequeuePosition { 0 };
+    };
+
+    class Worker;
+
+    // Runs the slot's client unless another worker already is. Returns true if it did work.
+    bool runSlot(int slot, SlotQueue& queue) noexcept;
+
+    // Own queue first, then the others in turn
+    bool runNext(int workerIndex) noexcept;
+
+    std::array<Slot, maxClients> slots;
+    std::array<bool, maxClients> slotInUse {}; // under lock
+    std::mutex lock;
+
+    int numWorkers = 1;
+    std::array<std::unique_ptr<SlotQueue>, maxWorkers> queues;
+    std::array<std::unique_ptr<Worker>, maxWorkers> workers;
+
+    JUCE_DECLARE_NON_COPYABLE(ConvolutionWorkerPool)
+};
@@ -0,0 +1,264 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <vector>
+
+// Set by the CTD201_DSP_STATS CMake option; off unless the build asks for it
+#ifndef CTD201_DSP_STATS
+ #define CTD201_DSP_STATS 0
+#endif
+
+// Per-instance DSP load and deadline statistics.
+//
+// The audio thread brackets each host block with beginBlock()/endBlock() and marks where
+// each stage starts with startStage(); a stage runs until the next one starts, stopStage()
+// or endBlock(), and time spent in the same stage across slices adds up. endBlock() pushes
+// one fixed-size record into a single-producer/single-consumer FIFO (nothing allocates or
+// locks on the audio thread; if the reader falls behind, records are dropped) and counts
+// deadline overruns, i.e. blocks that took longer to render than they last in real time.
+//
+// getStatistics() drains the FIFO into a window of the most recent blocks and returns
+// min / mean / p99 / max per stage and for the whole block. Call it from one non-audio
+// thread at a time (the editor timer, a test).
+//
+// With CTD201_DSP_STATS off every audio-thread call is an empty inline function and the
+// class holds no state, so the instrumentation costs nothing.
+class DspLoadMonitor
+{
+public:
+    enum class Stage
+    {
+        input,     // parameter snapshot, tempo sync, input gain, peak meter
+        eqUpdate,  // shelf coefficient hand-off
+        tapeLoop,  // motor, modulation, heads, filters, saturation, tape write
+        reverb,    // convolution send and return
+        outputMix, // dry/wet blend, clip, master gain
+        numStages
+    };
+
+    static constexpr int numStages = static_cast<int>(Stage::numStages);
+    static constexpr bool isEnabled = CTD201_DSP_STATS != 0;
+
+    static constexpr int fifoSize = 1024;    // records in flight between the threads
+    static constexpr int historySize = 512;  // blocks the statistics window covers
+
+    // Seconds per block
+    struct Timing
+    {
+        double min = 0.0;
+        double mean = 0.0;
+        double p99 = 0.0;
+        double max = 0.0;
+    };
+
+    struct Statistics
+    {
+        Timing total;
+        std::array<Timing, numStages> stages {};
+
+        double meanLoad = 0.0; // mean block time / mean block duration
+        double peakLoad = 0.0; // worst block time / that block's duration
+
+        juce::uint64 numBlocks = 0;   // since the last reset
+        juce::uint64 numOverruns = 0; // blocks slower than real time, since the last reset
+        int windowSize = 0;           // blocks behind the timings above
+
+        const Timing& operator[](Stage stage) const noexcept { return stages[static_cast<size_t>(stage)]; }
+    };
+
+    static const char* getStageName(Stage stage) noexcept
+    {
+        switch (stage)
+        {
+            case Stage::input:     return "Input";
+            case Stage::eqUpdate:  return "EQ Update";
+            case Stage::tapeLoop:  return "Tape Loop";
+            case Stage::reverb:    return "Reverb";
+            case Stage::outputMix: return "Output Mix";
+            case Stage::numStages: break;
+        }
+        return "";
+    }
+
+#if CTD201_DSP_STATS
+    DspLoadMonitor()
+        : secondsPerTick(1.0 / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond()))
+    {
+        history.resize(historySize);
+        sortScratch.resize(historySize);
+    }
+
+    // Not concurrent with the audio callback (prepareToPlay / releaseResources)
+    void prepare(double newSampleRate) noexcept
+    {
+        sampleRate = newSampleRate > 0.0 ? newSampleRate : 44100.0;
+        reset();
+    }
+
+    // Starts a fresh window and zeroes the counters; safe while audio runs
+    void reset() noexcept
+    {
+        const juce::SpinLock::ScopedLockType lock(readerLock);
+        drain();
+        historyCount = historyWrite = 0;
+        blockBase = blocks.load(std::memory_order_relaxed);
+        overrunBase = overruns.load(std::memory_order_relaxed);
+    }
+
+    // === Audio thread ===
+    void beginBlock(int numSamples) noexcept
+    {
+        current = {};
+        activeStage = -1;
+        current.budget = static_cast<double>(numSamples) / sampleRate;
+        blockStart = juce::Time::getHighResolutionTicks();
+    }
+
+    void endBlock() noexcept
+    {
+        const auto now = juce::Time::getHighResolutionTicks();
+        closeStage(now);
+        current.total = static_cast<double>(now - blockStart) * secondsPerTick;
+
+        // Single writer, so plain load + store is enough
+        blocks.store(blocks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if (current.total > current.budget)
+            overruns.store(overruns.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+        const auto scope = fifo.write(1);
+        if (scope.blockSize1 > 0)
+            records[static_cast<size_t>(scope.startIndex1)] = current;
+    }
+
+    // Closes the running stage (if any) and starts timing the next one
+    void startStage(Stage stage) noexcept
+    {
+        const auto now = juce::Time::getHighResolutionTicks();
+        closeStage(now);
+        activeStage = static_cast<int>(stage);
+        stageStart = now;
+    }
+
+    void stopStage() noexcept
+    {
+        closeStage(juce::Time::getHighResolutionTicks());
+    }
+
+    // === Reader thread ===
+    Statistics getStatistics()
+    {
+        const juce::SpinLock::ScopedLockType lock(readerLock);
+        drain();
+
+        Statistics stats;
+        stats.numBlocks = blocks.load(std::memory_order_relaxed) - blockBase;
+        stats.numOverruns = overruns.load(std::memory_order_relaxed) - overrunBase;
+        stats.windowSize = historyCount;
+
+        if (historyCount == 0)
+            return stats;
+
+        double totalBudget = 0.0, totalTime = 0.0;
+        for (int i = 0; i < historyCount; ++i)
+        {
+            const auto& r = history[static_cast<size_t>(i)];
+            totalBudget += r.budget;
+            totalTime += r.total;
+            if (r.budget > 0.0)
+                stats.peakLoad = juce::jmax(stats.peakLoad, r.total / r.budget);
+        }
+        stats.meanLoad = totalBudget > 0.0 ? totalTime / totalBudget : 0.0;
+
+        stats.total = summarise([](const Record& r) { return r.total; });
+        for (size_t s = 0; s < static_cast<size_t>(numStages); ++s)
+            stats.stages[s] = summarise([s](const Record& r) { return r.stages[s]; });
+
+        return stats;
+    }
+
+private:
+    struct Record
+    {
+        double budget = 0.0;
+        double total = 0.0;
+        std::array<double, numStages> stages {};
+    };
+
+    void closeStage(juce::int64 now) noexcept
+    {
+        if (activeStage >= 0)
+            current.stages[static_cast<size_t>(activeStage)] += static_cast<double>(now - stageStart) * secondsPerTick;
+
+        activeStage = -1;
+    }
+
+    void drain() noexcept
+    {
+        const auto scope = fifo.read(fifo.getNumReady());
+        scope.forEach([this](int index) {
+            history[static_cast<size_t>(historyWrite)] = records[static_cast<size_t>(index)];
+            historyWrite = (historyWrite + 1) % historySize;
+            historyCount = juce::jmin(historyCount + 1, historySize);
+        });
+    }
+
+    template <typename Field>
+    Timing summarise(Field field) noexcept
+    {
+        Timing t;
+        t.min = t.max = field(history[0]);
+
+        double sum = 0.0;
+        for (int i = 0; i < historyCount; ++i)
+        {
+            const double value = field(history[static_cast<size_t>(i)]);
+            sortScratch[static_cast<size_t>(i)] = value;
+            sum += value;
+            t.min = juce::jmin(t.min, value);
+            t.max = juce::jmax(t.max, value);
+        }
+        t.mean = sum / historyCount;
+
+        // Nearest-rank 99th percentile
+        const int rank = juce::jlimit(0, historyCount - 1, static_cast<int>(std::ceil(0.99 * historyCount)) - 1);
+        auto first = sortScratch.begin();
+        std::nth_element(first, first + rank, first + historyCount);
+        t.p99 = sortScratch[static_cast<size_t>(rank)];
+        return t;
+    }
+
+    const double secondsPerTick;
+    double sampleRate = 44100.0;
+
+    // Audio thread
+    Record current;
+    juce::int64 blockStart = 0, stageStart = 0;
+    int activeStage = -1;
+    std::atomic<juce::uint64> blocks { 0 }, overruns { 0 };
+
+    // Shared through the FIFO
+    juce::AbstractFifo fifo { fifoSize };
+    std::array<Record, fifoSize> records {};
+
+    // Reader side
+    juce::SpinLock readerLock;
+    std::vector<Record> history;
+    std::vector<double> sortScratch;
+    int historyCount = 0, historyWrite = 0;
+    juce::uint64 blockBase = 0, overrunBase = 0;
+
+#else
+    void prepare(double) noexcept {}
+    void reset() noexcept {}
+    void beginBlock(int) noexcept {}
+    void endBlock() noexcept {}
+
+    void startStage(Stage) noexcept {}
+    void stopStage() noexcept {}
+
+    Statistics getStatistics() { return {}; }
+#endif
+};
@@ -0,0 +1,244 @@
+#include "ImpulseResponseCache.h"
+#include "BinaryData.h"
+#include <juce_dsp/juce_dsp.h>
+
+namespace
+{
+    // Same steps (and order) juce::dsp::Convolution applies when it loads an IR itself,
+    // so cached IRs sound identical to the ones the convolver used to prepare per instance.
+
+    void trimSilence(juce::AudioBuffer<float>& buffer)
+    {
+        const float threshold = juce::Decibels::decibelsToGain(-80.0f);
+        int first = buffer.getNumSamples();
+        int last = 0;
+
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        {
+            const auto* data = buffer.getReadPointer(ch);
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+            {
+                if (std::abs(data[i]) > threshold)
+                {
+                    first = juce::jmin(first, i);
+                    last = juce::jmax(last, i + 1);
+                }
+            }
+        }
+
+        if (first >= last)
+            return;
+
+        juce::AudioBuffer<float> trimmed(buffer.getNumChannels(), last - first);
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            trimmed.copyFrom(ch, 0, buffer, ch, first, last - first);
+
+        buffer = std::move(trimmed);
+    }
+
+    juce::AudioBuffer<float> resample(juce::AudioBuffer<float>& buffer, double sourceRate, double targetRate)
+    {
+        if (sourceRate == targetRate || sourceRate <= 0.0 || targetRate <= 0.0)
+            return std::move(buffer);
+
+        const auto ratio = sourceRate / targetRate;
+        const auto resampledLength = static_cast<int>(std::ceil(buffer.getNumSamples() / ratio));
+
+        juce::MemoryAudioSource memorySource(buffer, false);
+        juce::ResamplingAudioSource resampler(&memorySource, false, buffer.getNumChannels());
+        resampler.setResamplingRatio(ratio);
+        resampler.prepareToPlay(resampledLength, targetRate);
+
+        juce::AudioBuffer<float> resampled(buffer.getNumChannels(), resampledLength);
+        resampler.getNextAudioBlock(juce::AudioSourceChannelInfo(resampled));
+        return resampled;
+    }
+
+    void normalise(juce::AudioBuffer<float>& buffer)
+    {
+        float maxSumSquared = 0.0f;
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        {
+            const auto* data = buffer.getReadPointer(ch);
+            float sum = 0.0f;
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                sum += data[i] * data[i];
+            maxSumSquared = juce::jmax(maxSumSquared, sum);
+        }
+
+        if (maxSumSquared > 0.0f)
+            buffer.applyGain(0.125f / std::sqrt(maxSumSquared));
+    }
+
+    ImpulseResponseCache::Ptr decode(juce::AudioFormatReader* reader, const juce::String& identity, double sampleRate, bool stereo, bool trim)
+    {
+        if (reader == nullptr || reader->lengthInSamples <= 0)
+            return nullptr;
+
+        const int numChannels = stereo ? juce::jmin(2, static_cast<int>(reader->numChannels)) : 1;
+        juce::AudioBuffer<float> buffer(numChannels, static_cast<int>(reader->lengthInSamples));
+        reader->read(&buffer, 0, buffer.getNumSamples(), 0, true, numChannels > 1);
+
+        if (trim)
+            trimSilence(buffer);
+
+        auto ir = std::make_shared<ImpulseResponseCache::ImpulseResponse>();
+        ir->identity = identity;
+        ir->buffer = resample(buffer, reader->sampleRate, sampleRate);
+        ir->sampleRate = sampleRate > 0.0 ? sampleRate : reader->sampleRate;
+        ir->stereo = stereo;
+        normalise(ir->buffer);
+        return ir;
+    }
+}
+
+std::shared_ptr<const ImpulseResponseCache::Spectra> ImpulseResponseCache::ImpulseResponse::getSpectra(int partitionSize, int firstSample, int lastSample) const
+{
+    const std::lock_guard<std::mutex> scopedLock(spectraLock);
+
+    for (const auto& existing : spectra)
+        if (existing->partitionSize == partitionSize && existing->firstSample == firstSample && existing->lastSample == lastSample)
+            return existing;
+
+    auto segment = std::make_shared<Spectra>();
+    segment->partitionSize = partitionSize;
+    segment->firstSample = firstSample;
+    segment->lastSample = lastSample;
+    segment->numPartitions = (lastSample - firstSample + partitionSize - 1) / partitionSize;
+
+    const int numBins = partitionSize + 1;
+    juce::dsp::FFT fft(juce::roundToInt(std::log2(2 * partitionSize)));
+    std::vector<float> fftBuffer(static_cast<size_t>(4 * partitionSize)); // 2 * FFT size, as juce::dsp::FFT wants
+
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+    {
+        const float* irData = buffer.getReadPointer(ch);
+        std::vector<std::complex<float>> partitions(static_cast<size_t>(segment->numPartitions * numBins));
+
+        for (int k = 0; k < segment->numPartitions; ++k)
+        {
+            std::fill(fftBuffer.begin(), fftBuffer.end(), 0.0f);
+            const int start = firstSample + k * partitionSize;
+            const int count = juce::jmin(partitionSize, lastSample - start);
+            std::copy(irData + start, irData + start + count, fftBuffer.begin());
+
+            fft.performRealOnlyForwardTransform(fftBuffer.data(), true);
+
+            const auto* bins = reinterpret_cast<const std::complex<float>*>(fftBuffer.data());
+            std::copy(bins, bins + numBins, partitions.begin() + k * numBins);
+        }
+
+        segment->channels.push_back(std::move(partitions));
+    }
+
+    spectra.push_back(segment);
+    return segment;
+}
+
+ImpulseResponseCache::Ptr ImpulseResponseCache::getDefault(double sampleRate, bool stereo)
+{
+    return getOrCreate("binary:DefaultReverbIR_wav", sampleRate, stereo, false, [](juce::AudioFormatManager& formats) {
+        auto stream = std::make_unique<juce::MemoryInputStream>(BinaryData::DefaultReverbIR_wav,
+            static_cast<size_t>(BinaryData::DefaultReverbIR_wavSize),
+            false);
+        return std::unique_ptr<juce::AudioFormatReader>(formats.createReaderFor(std::move(stream)));
+    });
+}
+
+ImpulseResponseCache::Ptr ImpulseResponseCache::getFromFile(const juce::File& file, double sampleRate, bool stereo, bool trim)
+{
+    if (!file.existsAsFile())
+        return nullptr;
+
+    return getOrCreate(getFileIdentity(file), sampleRate, stereo, trim, [file](juce::AudioFormatManager& formats) {
+        return std::unique_ptr<juce::AudioFormatReader>(formats.createReaderFor(file));
+    });
+}
+
+ImpulseResponseCache::Ptr ImpulseResponseCache::getFromMemory(const juce::String& identity,
+    std::shared_ptr<const juce::MemoryBlock> data,
+    double sampleRate,
+    bool stereo,
+    bool trim)
+{
+    if (data == nullptr || data->getSize() == 0)
+        return nullptr;
+
+    return getOrCreate(identity, sampleRate, stereo, trim, [data](juce::AudioFormatManager& formats) {
+        auto stream = std::make_unique<juce::MemoryInputStream>(*data, false);
+        return std::unique_ptr<juce::AudioFormatReader>(formats.createReaderFor(std::move(stream)));
+    });
+}
+
+juce::String ImpulseResponseCache::getFileIdentity(const juce::File& file)
+{
+    // Size and modification time in the identity, so an edited file isn't served stale
+    return "file:" + file.getFullPathName()
+           + ":" + juce::String(file.getSize())
+           + ":" + juce::String(file.getLastModificationTime().toMilliseconds());
+}
+
+int ImpulseResponseCache::getNumEntries()
+{
+    const std::lock_guard<std::mutex> scopedLock(lock);
+
+    int alive = 0;
+    for (const auto& entry : entries)
+        if (!entry.second.expired())
+            ++alive;
+    return alive;
+}
+
+juce::String ImpulseResponseCache::makeKey(const juce::String& identity, double sampleRate, bool stereo, bool trim)
+{
+    return identity + "@" + juce::String(sampleRate, 2) + (stereo ? ":stereo" : ":mono") + (trim ? ":trim" : "");
+}
+
+ImpulseResponseCache::Ptr ImpulseResponseCache::getOrCreate(const juce::String& identity,
+    double sampleRate,
+    bool stereo,
+    bool trim,
+    const std::function<std::unique_ptr<juce::AudioFormatReader>(juce::AudioFormatManager&)>& createReader)
+{
+    const auto key = makeKey(identity, sampleRate, stereo, trim);
+
+    std::unique_lock<std::mutex> scopedLock(lock);
+
+    for (auto it = entries.begin(); it != entries.end();)
+        it = it->second.expired() ? entries.erase(it) : std::next(it);
+
+    if (auto found = entries.find(key); found != entries.end())
+        if (auto existing = found->second.lock())
+            return existing;
+
+    // Someone is decoding this one already: wait for their copy rather than decode it twice
+    if (auto inFlight = decoding.find(key); inFlight != decoding.end())
+    {
+        auto pending = inFlight->second;
+        scopedLock.unlock();
+        return pending.get();
+    }
+
+    // Registered once, before anyone decodes; after that the manager is only read
+    if (!formatsRegistered)
+    {
+        formatManager.registerBasicFormats();
+        formatsRegistered = true;
+    }
+
+    std::promise<Ptr> decoded;
+    decoding.emplace(key, decoded.get_future().share());
+    scopedLock.unlock();
+
+    auto reader = createReader(formatManager);
+    auto ir = decode(reader.get(), identity, sampleRate, stereo, trim);
+
+    scopedLock.lock();
+    if (ir != nullptr)
+        entries[key] = ir;
+    decoding.erase(key);
+    scopedLock.unlock();
+
+    decoded.set_value(ir);
+    return ir;
+}
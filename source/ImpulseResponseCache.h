@@ -0,0 +1,92 @@
+#pragma once
+
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <complex>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Process-wide cache of decoded impulse responses.
+//
+// Every plugin instance holds a juce::SharedResourcePointer<ImpulseResponseCache>, so one
+// cache exists while any instance is alive. Entries are keyed by IR identity (embedded asset
+// or file path + size + modification time), sample rate and channel mode, and hold the IR
+// already trimmed, resampled to the session rate and normalised. Instances share the same
+// immutable data, so decode cost and RAM scale with the number of unique IRs, not instances.
+// That includes the FFT partitions the convolver multiplies with (getSpectra), the largest
+// part of its memory: they are built once per IR and stage layout, and live with the IR.
+//
+// The cache only keeps weak references: an entry is freed when the last instance using it
+// lets go. The lock only covers the maps, never a decode: different IRs decode in
+// parallel, and a lookup for an IR that is being decoded waits for that decode instead of
+// starting its own. Lookups can wait, so call them from prepareToPlay or the message
+// thread, never from processBlock.
+class ImpulseResponseCache
+{
+public:
+    // One segment of an IR, uniformly partitioned, in the frequency domain: partition k of
+    // each IR channel is the FFT of samples [firstSample + k P, firstSample + (k + 1) P),
+    // zero padded to 2P, as P + 1 bins
+    struct Spectra
+    {
+        int partitionSize = 0;
+        int firstSample = 0;
+        int lastSample = 0;
+        int numPartitions = 0;
+        std::vector<std::vector<std::complex<float>>> channels; // numPartitions x (P + 1) each
+    };
+
+    struct ImpulseResponse
+    {
+        juce::String identity;
+        juce::AudioBuffer<float> buffer; // trimmed (if asked), resampled, normalised
+        double sampleRate = 0.0;
+        bool stereo = true;
+
+        // The spectra of [firstSample, lastSample) in partitions of partitionSize, built by
+        // the first caller and shared with every later one. Not from the audio thread:
+        // building them locks this IR (a second caller for the same IR waits rather than
+        // build its own copy).
+        std::shared_ptr<const Spectra> getSpectra(int partitionSize, int firstSample, int lastSample) const;
+
+    private:
+        mutable std::mutex spectraLock;
+        mutable std::vector<std::shared_ptr<const Spectra>> spectra;
+    };
+
+    using Ptr = std::shared_ptr<const ImpulseResponse>;
+
+    // The embedded BinaryData::DefaultReverbIR_wav
+    Ptr getDefault(double sampleRate, bool stereo);
+
+    // Returns nullptr if the file can't be read
+    Ptr getFromFile(const juce::File& file, double sampleRate, bool stereo, bool trim);
+
+    // An IR file already in memory (restored from a session, or read to hash it), keyed by
+    // the given identity so it shares entries with getFromFile. nullptr if it can't be decoded.
+    Ptr getFromMemory(const juce::String& identity, std::shared_ptr<const juce::MemoryBlock> data, double sampleRate, bool stereo, bool trim);
+
+    // The identity getFromFile uses for a file
+    static juce::String getFileIdentity(const juce::File& file);
+
+    // Number of IRs currently alive in the cache (mainly for tests)
+    int getNumEntries();
+
+private:
+    Ptr getOrCreate(const juce::String& identity,
+        double sampleRate,
+        bool stereo,
+        bool trim,
+        const std::function<std::unique_ptr<juce::AudioFormatReader>(juce::AudioFormatManager&)>& createReader);
+
+    static juce::String makeKey(const juce::String& identity, double sampleRate, bool stereo, bool trim);
+
+    std::mutex lock;
+    std::map<juce::String, std::weak_ptr<const ImpulseResponse>> entries;
+    std::map<juce::String, std::shared_future<Ptr>> decoding; // by whichever lookup came first
+    juce::AudioFormatManager formatManager;
+    bool formatsRegistered = false;
+};
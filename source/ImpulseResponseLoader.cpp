@@ -0,0 +1,115 @@
+#include "ImpulseResponseLoader.h"
+#include <algorithm>
+#include <chrono>
+
+class ImpulseResponseLoader::Worker : private juce::Thread
+{
+public:
+    Worker() : juce::Thread("CTD201 IR Loader")
+    {
+        startThread(juce::Thread::Priority::low);
+    }
+
+    ~Worker() override
+    {
+        {
+            const std::lock_guard<std::mutex> scopedLock(lock);
+            stopping = true;
+        }
+        changed.notify_all();
+        stopThread(10000);
+    }
+
+    void enqueue(ImpulseResponseLoader& client, Job job)
+    {
+        {
+            const std::lock_guard<std::mutex> scopedLock(lock);
+            client.pendingJob = std::move(job);
+            if (std::find(queue.begin(), queue.end(), &client) == queue.end())
+                queue.push_back(&client);
+        }
+        changed.notify_all();
+    }
+
+    void cancel(ImpulseResponseLoader& client)
+    {
+        std::unique_lock<std::mutex> scopedLock(lock);
+        queue.erase(std::remove(queue.begin(), queue.end(), &client), queue.end());
+        client.pendingJob = nullptr;
+        changed.wait(scopedLock, [&] { return running != &client; });
+    }
+
+    bool waitUntilIdle(ImpulseResponseLoader& client, int timeoutMs)
+    {
+        std::unique_lock<std::mutex> scopedLock(lock);
+        return changed.wait_for(scopedLock, std::chrono::milliseconds(timeoutMs), [&] { return !isBusy(client); });
+    }
+
+    bool isLoading(ImpulseResponseLoader& client)
+    {
+        const std::lock_guard<std::mutex> scopedLock(lock);
+        return isBusy(client);
+    }
+
+private:
+    bool isBusy(ImpulseResponseLoader& client) const
+    {
+        return running == &client || std::find(queue.begin(), queue.end(), &client) != queue.end();
+    }
+
+    void run() override
+    {
+        std::unique_lock<std::mutex> scopedLock(lock);
+
+        while (!stopping && !threadShouldExit())
+        {
+            if (queue.empty())
+            {
+                changed.wait_for(scopedLock, std::chrono::milliseconds(100));
+                continue;
+            }
+
+            running = queue.front();
+            queue.pop_front();
+            auto job = std::move(running->pendingJob);
+            running->pendingJob = nullptr;
+
+            scopedLock.unlock();
+            if (job)
+                job();
+            scopedLock.lock();
+
+            running = nullptr;
+            changed.notify_all();
+        }
+    }
+
+    std::mutex lock;
+    std::condition_variable changed;
+    std::deque<ImpulseResponseLoader*> queue;
+    ImpulseResponseLoader* running = nullptr;
+    bool stopping = false;
+};
+
+//==============================================================================
+ImpulseResponseLoader::ImpulseResponseLoader() = default;
+
+ImpulseResponseLoader::~ImpulseResponseLoader()
+{
+    worker->cancel(*this);
+}
+
+void ImpulseResponseLoader::load(Job job)
+{
+    worker->enqueue(*this, std::move(job));
+}
+
+bool ImpulseResponseLoader::waitUntilIdle(int timeoutMs)
+{
+    return worker->waitUntilIdle(*this, timeoutMs);
+}
+
+bool ImpulseResponseLoader::isLoading()
+{
+    return worker->isLoading(*this);
+}
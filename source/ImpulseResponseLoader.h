@@ -0,0 +1,45 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+// Runs an instance's impulse response loads off the calling thread.
+//
+// Decoding, resampling and partitioning an IR takes tens of milliseconds; a session
+// restoring hundreds of instances must not wait for that inside setStateInformation.
+// load() only queues the work. One thread per process (shared through
+// juce::SharedResourcePointer) works through every instance's requests in turn.
+//
+// Each instance has at most one request waiting: a newer one replaces it, so a burst of
+// state changes decodes only the last IR. The job installs its result itself (the
+// convolver picks new IRs up atomically on the audio thread).
+class ImpulseResponseLoader
+{
+public:
+    using Job = std::function<void()>;
+
+    ImpulseResponseLoader();
+
+    // Drops a waiting job and waits for a running one to finish
+    ~ImpulseResponseLoader();
+
+    // Message thread
+    void load(Job job);
+
+    // Blocks until nothing is waiting or running for this instance (tests, offline renders).
+    // Returns false on timeout.
+    bool waitUntilIdle(int timeoutMs);
+
+    bool isLoading();
+
+private:
+    class Worker;
+    juce::SharedResourcePointer<Worker> worker;
+
+    Job pendingJob; // guarded by the worker's lock
+
+    JUCE_DECLARE_NON_COPYABLE(ImpulseResponseLoader)
+};
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "ParameterSnapshot.h"
+#include <array>
+#include <atomic>
+
+// MIDI continuous controllers -> plugin parameters.
+//
+// processBlock splits the host block at every mapped controller event and moves the
+// parameter right at that sample, so CC automation lands where it was recorded whatever
+// buffer size the host renders with. Switches (heads, bypass, kill dry...) are on from a
+// value of 64 up.
+//
+// Telling the host about a parameter change locks and posts messages, so the audio
+// thread doesn't: apply() hands the value to the ParameterSnapshot, which uses it from
+// that sample on, and queues the parameter's slot in a lock-free FIFO. forwardToHost()
+// drains the FIFO on the message thread, sets each parameter to its latest value and
+// lets the snapshot read it again. Parameters the snapshot doesn't read follow once set.
+//
+// The default map uses the undefined controllers 20-34. setEnabled(false) switches the
+// whole map off for setups that send those controllers to something else. setMapping()
+// and setEnabled() may be called from the message thread while audio is running; apply()
+// is audio thread only.
+class MidiControllerMap
+{
+public:
+    static constexpr int numControllers = 128;
+
+    // Holds every override slot at once (a slot is only queued once), so it never fills
+    static constexpr int fifoSize = ParameterSnapshot::maxOverrides + 1;
+
+    struct DefaultMapping
+    {
+        int controller;
+        const char* parameterID;
+    };
+
+    static constexpr std::array<DefaultMapping, 15> defaultMappings { {
+        { 20, "delayTime" },
+        { 21, "feedback" },
+        { 22, "saturation" },
+        { 23, "wow" },
+        { 24, "flutter" },
+        { 25, "echoMix" },
+        { 26, "reverbMix" },
+        { 27, "wetDry" },
+        { 28, "masterGain" },
+        { 29, "bass" },
+        { 30, "treble" },
+        { 31, "inputGain" },
+        { 32, "head1" },
+        { 33, "head2" },
+        { 34, "head3" },
+    } };
+
+    // Installs the default map
+    void attach(juce::AudioProcessorValueTreeState& state)
+    {
+        clear();
+        for (const auto& mapping : defaultMappings)
+            setMapping(mapping.controller, state.getParameter(mapping.parameterID));
+    }
+
+    void clear() noexcept
+    {
+        for (auto& target : targets)
+            target.store(nullptr, std::memory_order_relaxed);
+    }
+
+    // nullptr unmaps the controller
+    void setMapping(int controller, juce::RangedAudioParameter* parameter) noexcept
+    {
+        if (juce::isPositiveAndBelow(controller, numControllers))
+            targets[static_cast<size_t>(controller)].store(parameter, std::memory_order_release);
+    }
+
+    juce::RangedAudioParameter* getMapping(int controller) const noexcept
+    {
+        return juce::isPositiveAndBelow(controller, numControllers)
+                   ? targets[static_cast<size_t>(controller)].load(std::memory_order_acquire)
+                   : nullptr;
+    }
+
+    // Off, controller messages pass through untouched; the mappings are kept
+    void setEnabled(bool shouldBeEnabled) noexcept { enabled.store(shouldBeEnabled, std::memory_order_relaxed); }
+    bool isEnabled() const noexcept { return enabled.load(std::memory_order_relaxed); }
+
+    // True for controller messages that move a parameter
+    bool isMapped(const juce::MidiMessage& message) const noexcept
+    {
+        return isEnabled() && message.isController() && getMapping(message.getControllerNumber()) != nullptr;
+    }
+
+    // Audio thread. Moves the mapped parameter in the snapshot and queues it for the
+    // host; false if unmapped. Never locks or allocates.
+    bool apply(const juce::MidiMessage& message, ParameterSnapshot& snapshot) noexcept
+    {
+        if (!isMapped(message))
+            return false;
+
+        auto* parameter = getMapping(message.getControllerNumber());
+        const int slot = snapshot.setOverride(*parameter, static_cast<float>(message.getControllerValue()) / 127.0f);
+
+        if (slot >= 0)
+        {
+            const auto scope = fifo.write(1);
+            jassert(scope.blockSize1 == 1);
+            if (scope.blockSize1 > 0)
+                slots[static_cast<size_t>(scope.startIndex1)] = slot;
+        }
+
+        return true;
+    }
+
+    // Message thread (single consumer). Sets every parameter controllers moved since the
+    // last call, telling the host, and returns it to the snapshot.
+    void forwardToHost(ParameterSnapshot& snapshot)
+    {
+        for (;;)
+        {
+            int slot = -1;
+            {
+                const auto scope = fifo.read(1);
+                if (scope.blockSize1 == 0)
+                    return;
+
+                slot = slots[static_cast<size_t>(scope.startIndex1)];
+            }
+
+            const auto change = snapshot.takeOverride(slot);
+            if (change.parameter == nullptr)
+                continue;
+
+            if (change.parameter->getValue() != change.normalisedValue)
+                change.parameter->setValueNotifyingHost(change.normalisedValue);
+
+            snapshot.releaseOverride(slot, change.sequence);
+        }
+    }
+
+private:
+    std::array<std::atomic<juce::RangedAudioParameter*>, numControllers> targets {};
+    std::atomic<bool> enabled { true };
+
+    juce::AbstractFifo fifo { fifoSize };
+    std::array<int, fifoSize> slots {};
+};
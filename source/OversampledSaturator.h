@@ -0,0 +1,67 @@
+#pragma once
+
+#include "TapeSaturator.h"
+#include <juce_dsp/juce_dsp.h>
+#include <memory>
+#include <vector>
+
+// The feedback saturation at 4x the session rate, for high-quality (offline) renders.
+//
+// tanh of a hot echo puts harmonics far above Nyquist; at the session rate they fold back
+// as aliasing, which then goes round the loop with every repeat. Here each channel's run
+// is upsampled through JUCE's polyphase IIR half-band cascade, saturated with
+// TapeSaturator's fast tanh and filtered back down.
+//
+// The IIR half-bands keep the added delay to a few samples (getLatencyInSamples); the
+// processor takes it off the head distance so the echoes stay on time. One oversampler
+// per channel, all allocated in prepare(): process() never allocates.
+template <typename SampleType>
+class OversampledSaturator
+{
+public:
+    static constexpr int factorLog2 = 2; // 4x
+
+    void prepare(int numChannels, int maxBlockSize)
+    {
+        using Oversampling = juce::dsp::Oversampling<SampleType>;
+
+        oversamplers.clear();
+        for (int ch = 0; ch < juce::jmax(1, numChannels); ++ch)
+        {
+            auto oversampler = std::make_unique<Oversampling>(1, factorLog2, Oversampling::filterHalfBandPolyphaseIIR, true);
+            oversampler->initProcessing(static_cast<size_t>(juce::jmax(1, maxBlockSize)));
+            oversamplers.push_back(std::move(oversampler));
+        }
+    }
+
+    void release() { oversamplers.clear(); }
+
+    void reset() noexcept
+    {
+        for (auto& oversampler : oversamplers)
+            oversampler->reset();
+    }
+
+    // Delay through the up- and downsampling filters, in session-rate samples
+    SampleType getLatencyInSamples() const noexcept
+    {
+        return oversamplers.empty() ? SampleType(0) : oversamplers.front()->getLatencyInSamples();
+    }
+
+    // Saturates `data` in place at 4x: data[i] = tanh(data[i] * drive), band-limited
+    void process(int channel, SampleType* data, int numSamples, float drive) noexcept
+    {
+        jassert(juce::isPositiveAndBelow(channel, static_cast<int>(oversamplers.size())));
+        auto& oversampler = *oversamplers[static_cast<size_t>(channel)];
+
+        SampleType* channels[] = { data };
+        juce::dsp::AudioBlock<SampleType> block(channels, 1, static_cast<size_t>(numSamples));
+
+        auto oversampled = oversampler.processSamplesUp(block);
+        TapeSaturator::processFast(oversampled.getChannelPointer(0), static_cast<int>(oversampled.getNumSamples()), drive);
+        oversampler.processSamplesDown(block);
+    }
+
+private:
+    std::vector<std::unique_ptr<juce::dsp::Oversampling<SampleType>>> oversamplers;
+};
@@ -0,0 +1,310 @@
+#include "ParameterSnapshot.h"
+
+namespace
+{
+    constexpr double gainRampSeconds = 0.02;
+    constexpr double eqRampSeconds = 0.05;
+
+    bool differs(float a, float b) noexcept
+    {
+        return std::abs(a - b) > 1.0e-6f;
+    }
+
+    // The parameters MIDI controllers have moved ahead of the host, for one read()
+    struct ActiveOverrides
+    {
+        std::array<std::pair<const std::atomic<float>*, float>, ParameterSnapshot::maxOverrides> entries;
+        size_t size = 0;
+
+        float load(const std::atomic<float>* source, float fallback) const noexcept
+        {
+            if (source == nullptr) return fallback;
+
+            for (size_t i = 0; i < size; ++i)
+                if (entries[i].first == source)
+                    return entries[i].second;
+
+            return source->load(std::memory_order_relaxed);
+        }
+
+        bool loadBool(const std::atomic<float>* source, bool fallback) const noexcept
+        {
+            return source != nullptr ? load(source, 0.0f) > 0.5f : fallback;
+        }
+    };
+}
+
+void ParameterSnapshot::attach(juce::AudioProcessorValueTreeState& state)
+{
+    sources.delayTime = state.getRawParameterValue("delayTime");
+    sources.feedback = state.getRawParameterValue("feedback");
+    sources.saturation = state.getRawParameterValue("saturation");
+    sources.wow = state.getRawParameterValue("wow");
+    sources.flutter = state.getRawParameterValue("flutter");
+    sources.echoMix = state.getRawParameterValue("echoMix");
+    sources.reverbMix = state.getRawParameterValue("reverbMix");
+    sources.masterMix = state.getRawParameterValue("wetDry");
+    sources.masterGain = state.getRawParameterValue("masterGain");
+    sources.bass = state.getRawParameterValue("bass");
+    sources.treble = state.getRawParameterValue("treble");
+    sources.inputGain = state.getRawParameterValue("inputGain");
+    sources.heads = { state.getRawParameterValue("head1"), state.getRawParameterValue("head2"), state.getRawParameterValue("head3") };
+    sources.bypass = state.getRawParameterValue("bypass");
+    sources.killDry = state.getRawParameterValue("killDry");
+    sources.syncMode = state.getRawParameterValue("syncMode");
+    sources.syncRate = state.getRawParameterValue("syncRate");
+    sources.antiAlias = state.getRawParameterValue("antiAlias");
+    sources.adaptiveQuality = state.getRawParameterValue("adaptiveQuality");
+    sources.interpolation = state.getRawParameterValue("interpolation");
+    sources.renderMode = state.getRawParameterValue("renderMode");
+
+    numOverrides = 0;
+    for (auto* processorParameter : state.processor.getParameters())
+    {
+        auto* parameter = dynamic_cast<juce::RangedAudioParameter*>(processorParameter);
+        if (parameter == nullptr || numOverrides == maxOverrides) continue;
+
+        auto& entry = overrides[static_cast<size_t>(numOverrides++)];
+        entry.parameter = parameter;
+        entry.source = state.getRawParameterValue(parameter->getParameterID());
+        entry.forwarded.store(entry.requested.load());
+        entry.queued.store(false);
+    }
+
+    jassert(numOverrides < maxOverrides);
+
+    values = read();
+}
+
+int ParameterSnapshot::setOverride(juce::RangedAudioParameter& parameter, float normalisedValue) noexcept
+{
+    for (int slot = 0; slot < numOverrides; ++slot)
+    {
+        auto& entry = overrides[static_cast<size_t>(slot)];
+        if (entry.parameter != &parameter) continue;
+
+        // What the parameter will hold once set: snapped to its steps, like the host's value
+        const auto& range = parameter.getNormalisableRange();
+        const float normalised = juce::jlimit(0.0f, 1.0f, normalisedValue);
+        entry.normalisedValue.store(normalised, std::memory_order_relaxed);
+        entry.value.store(range.snapToLegalValue(range.convertFrom0to1(normalised)), std::memory_order_relaxed);
+
+        // Published before the queued flag is looked at: if the message thread has already
+        // taken the slot and missed this value, the flag is clear and it gets queued again
+        entry.requested.fetch_add(1);
+        return entry.queued.exchange(true) ? -1 : slot;
+    }
+
+    return -1;
+}
+
+ParameterSnapshot::PendingOverride ParameterSnapshot::takeOverride(int slot) noexcept
+{
+    if (!juce::isPositiveAndBelow(slot, numOverrides)) return {};
+
+    auto& entry = overrides[static_cast<size_t>(slot)];
+    entry.queued.store(false);
+
+    PendingOverride pending;
+    pending.sequence = entry.requested.load();
+    pending.parameter = entry.parameter;
+    pending.normalisedValue = entry.normalisedValue.load(std::memory_order_relaxed);
+    return pending;
+}
+
+void ParameterSnapshot::releaseOverride(int slot, juce::uint32 sequence) noexcept
+{
+    if (juce::isPositiveAndBelow(slot, numOverrides))
+        overrides[static_cast<size_t>(slot)].forwarded.store(sequence, std::memory_order_release);
+}
+
+void ParameterSnapshot::prepare(double sampleRate)
+{
+    currentSampleRate = sampleRate > 0.0 ? sampleRate : 44100.0;
+    values = read();
+
+    for (auto* gain : { &inputGain, &masterGain, &dryGain, &wetGain, &feedback, &echoLevel, &reverbLevel })
+        gain->reset(currentSampleRate, gainRampSeconds);
+
+    bassDb.reset(currentSampleRate, eqRampSeconds);
+    trebleDb.reset(currentSampleRate, eqRampSeconds);
+
+    inputGain.setCurrentAndTargetValue(juce::Decibels::decibelsToGain(values.inputGainDb));
+    masterGain.setCurrentAndTargetValue(juce::Decibels::decibelsToGain(values.masterGainDb));
+    setMixTargets(values, true);
+    feedback.setCurrentAndTargetValue(values.feedback);
+    echoLevel.setCurrentAndTargetValue(values.echoMix);
+    reverbLevel.setCurrentAndTargetValue(values.reverbMix);
+
+    for (size_t head = 0; head < headGains.size(); ++head)
+    {
+        headGains[head].reset(currentSampleRate, gainRampSeconds);
+        headGains[head].setCurrentAndTargetValue(values.headEnabled[head] ? 1.0f : 0.0f);
+    }
+
+    bassDb.setCurrentAndTargetValue(values.bassDb);
+    trebleDb.setCurrentAndTargetValue(values.trebleDb);
+
+    // The filters pick the coefficients up on the first slice
+    bassDirty = trebleDirty = true;
+    filterCoefficientsChanged = false;
+}
+
+ParameterSnapshot::Values ParameterSnapshot::read() const noexcept
+{
+    ActiveOverrides active;
+    for (int slot = 0; slot < numOverrides; ++slot)
+    {
+        const auto& entry = overrides[static_cast<size_t>(slot)];
+        if (entry.isActive())
+            active.entries[active.size++] = { entry.source, entry.value.load(std::memory_order_relaxed) };
+    }
+
+    auto load = [&active](const std::atomic<float>* source, float fallback) { return active.load(source, fallback); };
+    auto loadBool = [&active](const std::atomic<float>* source, bool fallback) { return active.loadBool(source, fallback); };
+
+    Values v;
+    v.delayTimeMs = load(sources.delayTime, v.delayTimeMs);
+    v.feedback = load(sources.feedback, v.feedback);
+    v.saturation = load(sources.saturation, v.saturation);
+    v.wow = load(sources.wow, v.wow);
+    v.flutter = load(sources.flutter, v.flutter);
+    v.echoMix = load(sources.echoMix, v.echoMix);
+    v.reverbMix = load(sources.reverbMix, v.reverbMix);
+    v.masterMix = load(sources.masterMix, v.masterMix);
+    v.masterGainDb = load(sources.masterGain, v.masterGainDb);
+    v.bassDb = load(sources.bass, v.bassDb);
+    v.trebleDb = load(sources.treble, v.trebleDb);
+    v.inputGainDb = load(sources.inputGain, v.inputGainDb);
+
+    for (size_t head = 0; head < v.headEnabled.size(); ++head)
+        v.headEnabled[head] = loadBool(sources.heads[head], v.headEnabled[head]);
+
+    v.bypass = loadBool(sources.bypass, v.bypass);
+    v.killDry = loadBool(sources.killDry, v.killDry);
+    v.syncMode = loadBool(sources.syncMode, v.syncMode);
+    v.antiAlias = loadBool(sources.antiAlias, v.antiAlias);
+    v.adaptiveQuality = loadBool(sources.adaptiveQuality, v.adaptiveQuality);
+    v.syncRate = static_cast<int>(load(sources.syncRate, static_cast<float>(v.syncRate)));
+    v.interpolation = static_cast<int>(load(sources.interpolation, static_cast<float>(v.interpolation)));
+    v.renderMode = static_cast<int>(load(sources.renderMode, static_cast<float>(v.renderMode)));
+    return v;
+}
+
+void ParameterSnapshot::setMixTargets(const Values& v, bool jump) noexcept
+{
+    // Equal-power master mix, overridden by bypass (fully dry) and kill dry (fully wet)
+    float dry = std::cos(v.masterMix * juce::MathConstants<float>::halfPi);
+    float wet = std::sin(v.masterMix * juce::MathConstants<float>::halfPi);
+
+    if (v.bypass)
+    {
+        dry = 1.0f;
+        wet = 0.0f;
+    }
+    else if (v.killDry)
+    {
+        dry = 0.0f;
+        wet = 1.0f;
+    }
+
+    if (jump)
+    {
+        dryGain.setCurrentAndTargetValue(dry);
+        wetGain.setCurrentAndTargetValue(wet);
+    }
+    else
+    {
+        dryGain.setTargetValue(dry);
+        wetGain.setTargetValue(wet);
+    }
+}
+
+ParameterSnapshot::Ramp ParameterSnapshot::advanceRamp(juce::SmoothedValue<float>& smoother, int numSamples) noexcept
+{
+    Ramp ramp;
+    ramp.start = smoother.getCurrentValue();
+    ramp.end = smoother.isSmoothing() ? smoother.skip(numSamples) : ramp.start;
+    return ramp;
+}
+
+void ParameterSnapshot::pull() noexcept
+{
+    const Values next = read();
+
+    // --- Gains: dB -> linear only when the dB value moved ---
+    if (differs(next.inputGainDb, values.inputGainDb) || differs(next.masterGainDb, values.masterGainDb))
+    {
+        inputGain.setTargetValue(juce::Decibels::decibelsToGain(next.inputGainDb));
+        masterGain.setTargetValue(juce::Decibels::decibelsToGain(next.masterGainDb));
+    }
+
+    // --- Mix: cos/sin only when mix, bypass or kill dry changed ---
+    if (differs(next.masterMix, values.masterMix) || next.bypass != values.bypass || next.killDry != values.killDry)
+    {
+        setMixTargets(next, false);
+    }
+
+    // --- Echo: feedback and the echo/reverb levels, ramped in the tape loop ---
+    if (differs(next.feedback, values.feedback) || differs(next.echoMix, values.echoMix) || differs(next.reverbMix, values.reverbMix))
+    {
+        feedback.setTargetValue(next.feedback);
+        echoLevel.setTargetValue(next.echoMix);
+        reverbLevel.setTargetValue(next.reverbMix);
+    }
+
+    if (next.headEnabled != values.headEnabled)
+    {
+        for (size_t head = 0; head < headGains.size(); ++head)
+            headGains[head].setTargetValue(next.headEnabled[head] ? 1.0f : 0.0f);
+    }
+
+    // --- EQ: retarget the dB smoothers ---
+    if (differs(next.bassDb, values.bassDb))
+    {
+        bassDb.setTargetValue(next.bassDb);
+    }
+
+    if (differs(next.trebleDb, values.trebleDb))
+    {
+        trebleDb.setTargetValue(next.trebleDb);
+    }
+
+    values = next;
+}
+
+void ParameterSnapshot::advance(int numSamples) noexcept
+{
+    inputGainRamp = advanceRamp(inputGain, numSamples);
+    masterGainRamp = advanceRamp(masterGain, numSamples);
+    dryGainRamp = advanceRamp(dryGain, numSamples);
+    wetGainRamp = advanceRamp(wetGain, numSamples);
+    feedbackRamp = advanceRamp(feedback, numSamples);
+    echoLevelRamp = advanceRamp(echoLevel, numSamples);
+    reverbLevelRamp = advanceRamp(reverbLevel, numSamples);
+
+    for (size_t head = 0; head < headGains.size(); ++head)
+        headGainRamps[head] = advanceRamp(headGains[head], numSamples);
+
+    // Shelf coefficients (pow + trig) only while a dB ramp is moving
+    filterCoefficientsChanged = false;
+    const auto sampleRate = currentSampleRate;
+
+    if (bassDirty || bassDb.isSmoothing())
+    {
+        const float db = bassDb.isSmoothing() ? bassDb.skip(numSamples) : bassDb.getCurrentValue();
+        bassCoefficients = juce::IIRCoefficients::makeLowShelf(sampleRate, bassFrequency, shelfQ, juce::Decibels::decibelsToGain(db));
+        bassDirty = false;
+        filterCoefficientsChanged = true;
+        ++numCoefficientUpdates;
+    }
+
+    if (trebleDirty || trebleDb.isSmoothing())
+    {
+        const float db = trebleDb.isSmoothing() ? trebleDb.skip(numSamples) : trebleDb.getCurrentValue();
+        trebleCoefficients = juce::IIRCoefficients::makeHighShelf(sampleRate, trebleFrequency, shelfQ, juce::Decibels::decibelsToGain(db));
+        trebleDirty = false;
+        filterCoefficientsChanged = true;
+        ++numCoefficientUpdates;
+    }
+}
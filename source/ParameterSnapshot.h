@@ -0,0 +1,199 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <array>
+#include <atomic>
+
+// Reads every APVTS parameter once per slice and caches what is derived from them.
+//
+// processBlock used to load each atomic separately and rebuild the shelf EQ coefficients,
+// dB->gain conversions and equal-power mix gains on every block. Here the raw values are
+// compared against the previous snapshot (with a small epsilon), and derived values are
+// only recomputed when their inputs moved:
+//
+//   input / master gain   dB->gain on change, then a 20 ms linear ramp
+//   dry / wet gains       cos/sin on change (mix, bypass or kill dry), 20 ms ramp
+//   feedback, echo and    20 ms linear ramp, applied per sample in the tape loop
+//   reverb levels
+//   head switches         20 ms fade (0 -> 1 or back) applied per sample by the head reader
+//   bass / treble         dB smoothed over 50 ms; coefficients rebuilt once per slice
+//                         while that ramp runs, never while it is settled
+//
+// The ramps run in samples, not slices, so a change sounds the same whatever block size
+// the host uses. pull() picks up new parameter values (once per host block, and again
+// after each MIDI controller event); advance() moves the ramps over one slice.
+//
+// MIDI controllers move parameters on the audio thread, where telling the host is not
+// allowed (it locks and posts messages). setOverride() makes the snapshot read the
+// controller's value for that parameter straight away; the message thread picks it up
+// with takeOverride(), sets the parameter and calls releaseOverride(), after which the
+// parameter is read again. Each parameter has one slot, so however many controller
+// events arrive before the message thread gets round to it, only the latest is passed on.
+//
+// Audio thread only, apart from attach(), prepare(), takeOverride() and releaseOverride().
+class ParameterSnapshot
+{
+public:
+    struct Values
+    {
+        float delayTimeMs = 300.0f;
+        float feedback = 0.2f;
+        float saturation = 0.2f;
+        float wow = 0.1f;
+        float flutter = 0.1f;
+        float echoMix = 0.5f;
+        float reverbMix = 0.2f;
+        float masterMix = 0.5f;
+        float masterGainDb = 0.0f;
+        float bassDb = 0.0f;
+        float trebleDb = 0.0f;
+        float inputGainDb = 0.0f;
+        std::array<bool, 3> headEnabled { true, true, true };
+        bool bypass = false;
+        bool killDry = false;
+        bool syncMode = false;
+        bool antiAlias = false;
+        bool adaptiveQuality = false;
+        int syncRate = 1;
+        int interpolation = 0;
+        int renderMode = 0;
+    };
+
+    // A gain that moves linearly from start to end across the slice
+    struct Ramp
+    {
+        float start = 1.0f;
+        float end = 1.0f;
+
+        bool isRamping() const noexcept { return start != end; }
+    };
+
+    // Parameters (of the whole processor) that can be overridden, at most
+    static constexpr int maxOverrides = 64;
+
+    // An override the host has yet to be told about
+    struct PendingOverride
+    {
+        juce::RangedAudioParameter* parameter = nullptr;
+        float normalisedValue = 0.0f;
+        juce::uint32 sequence = 0;
+    };
+
+    static constexpr float shelfQ = 0.707f;
+    static constexpr float bassFrequency = 150.0f;
+    static constexpr float trebleFrequency = 3000.0f;
+
+    void attach(juce::AudioProcessorValueTreeState& state);
+
+    // Jumps every ramp to the current parameter values
+    void prepare(double sampleRate);
+
+    // Loads the parameters once and retargets whatever moved
+    void pull() noexcept;
+
+    // Advances every ramp by numSamples and rebuilds shelf coefficients if they glide
+    void advance(int numSamples) noexcept;
+
+    // Audio thread. Reads `parameter` as this normalised value from the next pull() on,
+    // until the message thread releases it. Returns the parameter's slot when it has to
+    // be queued for the message thread, -1 if it is queued already or not a parameter of
+    // the attached processor.
+    int setOverride(juce::RangedAudioParameter& parameter, float normalisedValue) noexcept;
+
+    // Message thread, for a slot setOverride() returned: the latest value it holds.
+    // Release it with that sequence once the parameter is set; a newer setOverride() in
+    // between keeps it active and returns the slot again.
+    PendingOverride takeOverride(int slot) noexcept;
+    void releaseOverride(int slot, juce::uint32 sequence) noexcept;
+
+    // True while the shelves still have to move (coefficients change every slice)
+    bool areFiltersRamping() const noexcept { return bassDirty || trebleDirty || bassDb.isSmoothing() || trebleDb.isSmoothing(); }
+
+    const Values& getValues() const noexcept { return values; }
+
+    Ramp getInputGain() const noexcept { return inputGainRamp; }
+    Ramp getMasterGain() const noexcept { return masterGainRamp; }
+    Ramp getDryGain() const noexcept { return dryGainRamp; }
+    Ramp getWetGain() const noexcept { return wetGainRamp; }
+    Ramp getFeedback() const noexcept { return feedbackRamp; }
+    Ramp getEchoLevel() const noexcept { return echoLevelRamp; }
+    Ramp getReverbLevel() const noexcept { return reverbLevelRamp; }
+
+    // 0..1 fade of each playback head, so toggling one never clicks
+    Ramp getHeadGain(size_t head) const noexcept { return headGainRamps[head]; }
+
+    // True if the last advance() produced new shelf coefficients
+    bool haveFilterCoefficientsChanged() const noexcept { return filterCoefficientsChanged; }
+    const juce::IIRCoefficients& getBassCoefficients() const noexcept { return bassCoefficients; }
+    const juce::IIRCoefficients& getTrebleCoefficients() const noexcept { return trebleCoefficients; }
+
+    // How many times shelf coefficients were rebuilt (for tests and profiling)
+    int getNumCoefficientUpdates() const noexcept { return numCoefficientUpdates; }
+
+private:
+    Values read() const noexcept;
+    void setMixTargets(const Values& v, bool jump) noexcept;
+    static Ramp advanceRamp(juce::SmoothedValue<float>& smoother, int numSamples) noexcept;
+
+    struct Sources
+    {
+        std::atomic<float>* delayTime = nullptr;
+        std::atomic<float>* feedback = nullptr;
+        std::atomic<float>* saturation = nullptr;
+        std::atomic<float>* wow = nullptr;
+        std::atomic<float>* flutter = nullptr;
+        std::atomic<float>* echoMix = nullptr;
+        std::atomic<float>* reverbMix = nullptr;
+        std::atomic<float>* masterMix = nullptr;
+        std::atomic<float>* masterGain = nullptr;
+        std::atomic<float>* bass = nullptr;
+        std::atomic<float>* treble = nullptr;
+        std::atomic<float>* inputGain = nullptr;
+        std::array<std::atomic<float>*, 3> heads {};
+        std::atomic<float>* bypass = nullptr;
+        std::atomic<float>* killDry = nullptr;
+        std::atomic<float>* syncMode = nullptr;
+        std::atomic<float>* syncRate = nullptr;
+        std::atomic<float>* antiAlias = nullptr;
+        std::atomic<float>* adaptiveQuality = nullptr;
+        std::atomic<float>* interpolation = nullptr;
+        std::atomic<float>* renderMode = nullptr;
+    } sources;
+
+    // One per parameter of the processor, in its order (filled by attach). Active while
+    // requested != forwarded; queued from setOverride() returning the slot until
+    // takeOverride().
+    struct Override
+    {
+        juce::RangedAudioParameter* parameter = nullptr;
+        const std::atomic<float>* source = nullptr;
+        std::atomic<float> normalisedValue { 0.0f };
+        std::atomic<float> value { 0.0f };
+        std::atomic<juce::uint32> requested { 0 };
+        std::atomic<juce::uint32> forwarded { 0 };
+        std::atomic<bool> queued { false };
+
+        bool isActive() const noexcept { return requested.load(std::memory_order_relaxed) != forwarded.load(std::memory_order_acquire); }
+    };
+
+    std::array<Override, maxOverrides> overrides;
+    int numOverrides = 0;
+
+    Values values;
+    double currentSampleRate = 44100.0;
+
+    juce::SmoothedValue<float> inputGain, masterGain, dryGain, wetGain;
+    Ramp inputGainRamp, masterGainRamp, dryGainRamp, wetGainRamp;
+
+    juce::SmoothedValue<float> feedback, echoLevel, reverbLevel;
+    Ramp feedbackRamp, echoLevelRamp, reverbLevelRamp;
+
+    std::array<juce::SmoothedValue<float>, 3> headGains;
+    std::array<Ramp, 3> headGainRamps;
+
+    juce::SmoothedValue<float> bassDb, trebleDb;
+    juce::IIRCoefficients bassCoefficients, trebleCoefficients;
+    bool filterCoefficientsChanged = false;
+    bool bassDirty = true, trebleDirty = true;
+    int numCoefficientUpdates = 0;
+};
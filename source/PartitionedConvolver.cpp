@@ -0,0 +1,774 @@
+#include "PartitionedConvolver.h"
+#include <algorithm>
+#include <complex>
+#include <iterator>
+#include <thread>
+
+namespace
+{
+    // Segment layout, see PartitionedConvolver.h.
+    // Inline stages need firstSample >= partitionSize, background stages >= 2 * partitionSize;
+    // latency counts towards both.
+    struct StageLayout
+    {
+        int partitionSize;
+        int firstSample;
+        bool background;
+    };
+
+    constexpr int headLength = 64;
+    constexpr StageLayout stageLayouts[] = {
+        { 64, 64, false },
+        { 512, 1024, false },
+        { 4096, 8192, true },
+    };
+
+    constexpr int crossfadeSamples = 2048;
+
+    // Jobs over which partitions cut off by the tail limit fade out, or back in
+    constexpr int tailFadeJobs = 8;
+
+    // Adds `num` samples into a power-of-two ring starting at `position`
+    void addToRing(float* ring, int ringMask, juce::int64 position, const float* source, int num) noexcept
+    {
+        const int start = static_cast<int>(position & ringMask);
+        const int firstPart = juce::jmin(num, ringMask + 1 - start);
+
+        juce::FloatVectorOperations::add(ring + start, source, firstPart);
+        if (firstPart < num)
+            juce::FloatVectorOperations::add(ring, source + firstPart, num - firstPart);
+    }
+
+    //==============================================================================
+    // One uniformly partitioned overlap-save convolution over one segment of the IR.
+    //
+    // A stage whose results are due later than one partition after its input (the tail
+    // segment, or every segment once the convolver has latency) runs on the worker pool
+    // with up to maxJobsInFlight jobs queued: job n is submitted at a boundary and
+    // collected jobsInFlight boundaries later, exactly when its output is due. In realtime
+    // the audio thread never waits for a worker: a job nobody has started by then it runs
+    // itself, and one a worker is still running loses its output for that partition.
+    // Offline there is no deadline, and it waits rather than let the output depend on timing.
+    //
+    // With a tail limit the jobs stop multiplying the partitions that start past it, which
+    // is where the cost of a long IR goes. Their input spectra keep going into the delay
+    // line, so they can fade back in at any time without a gap in their history.
+    class UniformStage
+    {
+    public:
+        static constexpr int maxJobsInFlight = 64;
+
+        UniformStage(const ImpulseResponseCache::ImpulseResponse& ir, const StageLayout& layout, int lastSample, int numChannelsToUse, int latencySamples)
+            : partitionSize(layout.partitionSize),
+              firstSample(layout.firstSample),
+              latency(latencySamples),
+              jobsInFlight(layout.background || latencySamples > 0
+                               ? juce::jlimit(0, maxJobsInFlight, (layout.firstSample + latencySamples - layout.partitionSize) / layout.partitionSize)
+                               : 0),
+              numChannels(numChannelsToUse),
+              numBins(partitionSize + 1),
+              fft(juce::roundToInt(std::log2(2 * partitionSize))),
+              spectra(ir.getSpectra(partitionSize, firstSample, lastSample)) // shared by every instance with this IR
+        {
+            numPartitions = spectra->numPartitions;
+            activePartitions = fadeStart = numPartitions;
+
+            fftBuffer.resize(static_cast<size_t>(4 * partitionSize)); // 2 * FFT size, as juce::dsp::FFT wants
+            accumulator.resize(static_cast<size_t>(numBins));
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                Channel channel;
+                channel.partitions = spectra->channels[static_cast<size_t>(ch) % spectra->channels.size()].data(); // surround channels alternate the IR's L/R
+                channel.delayLine.resize(static_cast<size_t>(numPartitions * numBins));
+                channel.frame.resize(static_cast<size_t>(2 * partitionSize));
+                channels.push_back(std::move(channel));
+            }
+
+            jobs.resize(static_cast<size_t>(jobsInFlight > 0 ? jobsInFlight + 1 : 1));
+            for (auto& job : jobs)
+            {
+                job.input.resize(static_cast<size_t>(numChannels * 2 * partitionSize));
+                job.result.resize(static_cast<size_t>(numChannels * partitionSize));
+            }
+        }
+
+        // Audio thread; never waits. The jobs in flight belong to the old generation: none
+        // is collected, queued ones are skipped, and the first job after this clears the
+        // delay line wherever it runs.
+        void reset() noexcept
+        {
+            liveGeneration.store(++generation, std::memory_order_release);
+            nextToCollect = submitted.load(std::memory_order_relaxed);
+
+            for (auto& channel : channels)
+                std::fill(channel.frame.begin(), channel.frame.end(), 0.0f);
+        }
+
+        // Input arrives in pieces that never cross a partition boundary
+        void pushInput(int channel, const float* input, juce::int64 time, int num) noexcept
+        {
+            const int offset = partitionSize + static_cast<int>(time % partitionSize);
+            std::copy(input, input + num, channels[static_cast<size_t>(channel)].frame.begin() + offset);
+        }
+
+        // Called at time = boundary (a multiple of partitionSize), after the input up to it was pushed.
+        // Returns true if it submitted a job to the worker pool.
+        bool onBoundary(juce::int64 time, float* const* ring, int ringMask, std::atomic<int>& missedDeadlines, bool realtime) noexcept
+        {
+            if (jobsInFlight == 0)
+            {
+                auto& job = jobs.front();
+                job.generation = generation;
+                applyTailLimit(job);
+                runJob(job, true);
+
+                for (auto& channel : channels)
+                    shiftFrame(channel);
+
+                // The job covered input [time - P, time); its segment starts firstSample into the IR
+                writeResults(job, time - partitionSize + firstSample + latency, ring, ringMask);
+                return false;
+            }
+
+            // Collect the job submitted jobsInFlight boundaries ago (due right now), then submit this one
+            const auto numSubmitted = submitted.load(std::memory_order_relaxed);
+            if (nextToCollect < numSubmitted)
+            {
+                const auto& due = getJob(nextToCollect);
+                jassert(due.submitTime + jobsInFlight * partitionSize >= time);
+
+                if (due.submitTime + jobsInFlight * partitionSize == time)
+                {
+                    if (finishJob(nextToCollect, missedDeadlines, realtime))
+                        writeResults(due, due.submitTime - partitionSize + firstSample + latency, ring, ringMask);
+
+                    ++nextToCollect;
+                }
+            }
+
+            // The slot's previous job is normally long done. If a worker is still on it (more
+            // than a partition late), this partition is dropped and the stage starts over.
+            const auto previousInSlot = numSubmitted - static_cast<juce::int64>(jobs.size());
+            if (completed.load(std::memory_order_acquire) <= previousInSlot
+                && !finishJob(previousInSlot, missedDeadlines, realtime))
+            {
+                reset();
+                return false;
+            }
+
+            auto& job = getJob(numSubmitted);
+            job.submitTime = time;
+            job.generation = generation;
+            applyTailLimit(job);
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                auto& channel = channels[static_cast<size_t>(ch)];
+                std::copy(channel.frame.begin(), channel.frame.end(), job.input.begin() + ch * 2 * partitionSize);
+                shiftFrame(channel);
+            }
+
+            submitted.store(numSubmitted + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Worker side: runs the submitted jobs in order. Returns true if it ran any.
+        bool tryRunPendingJobs() noexcept
+        {
+            bool didWork = false;
+            for (;;)
+            {
+                auto next = nextToRun.load(std::memory_order_acquire);
+
+                // Nothing queued, or the audio thread is finishing the next one itself
+                if (next >= submitted.load(std::memory_order_acquire) || completed.load(std::memory_order_acquire) != next)
+                    return didWork;
+
+                if (!nextToRun.compare_exchange_strong(next, next + 1, std::memory_order_acq_rel))
+                    continue;
+
+                runClaimedJob(next);
+                didWork = true;
+            }
+        }
+
+        // Audio thread: IR samples past this are not convolved (0 for the whole segment).
+        // Takes effect from the next job, fading over tailFadeJobs.
+        void setTailLimit(int samples) noexcept { tailLimit = samples; }
+
+        bool isBackground() const noexcept { return jobsInFlight > 0; }
+        int getPartitionSize() const noexcept { return partitionSize; }
+
+        // Furthest ahead of the current time a result is ever written
+        int getLookahead() const noexcept { return firstSample + 2 * partitionSize + latency; }
+
+    private:
+        struct Channel
+        {
+            const std::complex<float>* partitions = nullptr; // numPartitions x numBins, IR spectra (in `spectra`)
+            std::vector<std::complex<float>> delayLine;      // numPartitions x numBins, input spectra
+            std::vector<float> frame;                    // [previous P | current P] input
+        };
+
+        struct Job
+        {
+            std::vector<float> input;   // numChannels x 2P, frame snapshot the job reads
+            std::vector<float> result;  // numChannels x P output samples
+
+            // Partitions [0, activePartitions) are convolved, those from fadeStart on at fadeGain
+            int activePartitions = 0;
+            int fadeStart = 0;
+            float fadeGain = 1.0f;
+
+            juce::int64 submitTime = 0;   // the boundary it was submitted at
+            juce::uint32 generation = 0;  // see reset()
+        };
+
+        Job& getJob(juce::int64 index) noexcept
+        {
+            return jobs[static_cast<size_t>(index % static_cast<juce::int64>(jobs.size()))];
+        }
+
+        // Audio thread, at the job's deadline. True if its result is ready: a worker has
+        // finished it, or nobody had started it and it ran here. In realtime, false if a
+        // worker is still running it (or the one before): its output is dropped, and it
+        // finishes in the background so the delay line stays whole. Offline it waits.
+        bool finishJob(juce::int64 index, std::atomic<int>& missedDeadlines, bool realtime) noexcept
+        {
+            if (completed.load(std::memory_order_acquire) > index)
+                return true;
+
+            missedDeadlines.fetch_add(1, std::memory_order_relaxed);
+
+            for (;;)
+            {
+                const auto done = completed.load(std::memory_order_acquire);
+                if (done > index)
+                    return true;
+
+                // Nobody has started it (offline: or the ones before it), so it runs here
+                auto expected = done;
+                if ((done == index || !realtime) && nextToRun.compare_exchange_strong(expected, done + 1, std::memory_order_acq_rel))
+                {
+                    runClaimedJob(done);
+                    continue;
+                }
+
+                if (realtime)
+                    return false;
+
+                std::this_thread::yield();
+            }
+        }
+
+        // Whoever claimed the job: runs it (skips it if reset() has made it stale) and
+        // lets the next one be claimed
+        void runClaimedJob(juce::int64 index) noexcept
+        {
+            auto& job = getJob(index);
+            if (job.generation == liveGeneration.load(std::memory_order_acquire))
+                runJob(job, false);
+
+            completed.store(index + 1, std::memory_order_release);
+        }
+
+        // Audio thread, once per job: which partitions it convolves, and at what gain the
+        // ones on their way out or back in
+        void applyTailLimit(Job& job) noexcept
+        {
+            const int wanted = tailLimit > 0
+                                   ? juce::jlimit(0, numPartitions, (tailLimit - firstSample + partitionSize - 1) / partitionSize)
+                                   : numPartitions;
+
+            if (!tailLimitApplied)
+            {
+                // A new engine starts at the limit in force, with nothing to fade
+                activePartitions = fadeStart = wanted;
+                tailLimitApplied = true;
+            }
+
+            if (fadeJobsRemaining > 0 && --fadeJobsRemaining == 0)
+            {
+                if (fadingIn)
+                    fadeStart = activePartitions;
+                else
+                    activePartitions = fadeStart;
+            }
+
+            // One fade at a time; a limit that moved meanwhile is picked up after it
+            if (fadeJobsRemaining == 0 && wanted != activePartitions)
+            {
+                fadingIn = wanted > activePartitions;
+                fadeStart = juce::jmin(wanted, activePartitions);
+                activePartitions = juce::jmax(wanted, activePartitions);
+                fadeJobsRemaining = tailFadeJobs;
+            }
+
+            const float position = static_cast<float>(fadeJobsRemaining) / static_cast<float>(tailFadeJobs + 1);
+            job.activePartitions = activePartitions;
+            job.fadeStart = fadeStart;
+            job.fadeGain = fadingIn ? 1.0f - position : position;
+        }
+
+        void shiftFrame(Channel& channel) noexcept
+        {
+            std::copy(channel.frame.begin() + partitionSize, channel.frame.end(), channel.frame.begin());
+        }
+
+        // Inline stages read the live frame, queued jobs their own snapshot
+        void runJob(Job& job, bool readFrame) noexcept
+        {
+            // First job since a reset: the history before it is gone
+            if (job.generation != historyGeneration)
+            {
+                for (auto& channel : channels)
+                    std::fill(channel.delayLine.begin(), channel.delayLine.end(), std::complex<float>());
+
+                delayLineHead = 0;
+                historyGeneration = job.generation;
+            }
+
+            const int slot = delayLineHead;
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                auto& channel = channels[static_cast<size_t>(ch)];
+                const float* input = readFrame ? channel.frame.data() : job.input.data() + ch * 2 * partitionSize;
+
+                // Forward FFT of the 2P input frame into the frequency-domain delay line
+                std::copy(input, input + 2 * partitionSize, fftBuffer.begin());
+                std::fill(fftBuffer.begin() + 2 * partitionSize, fftBuffer.end(), 0.0f);
+                fft.performRealOnlyForwardTransform(fftBuffer.data(), true);
+
+                const auto* bins = reinterpret_cast<const std::complex<float>*>(fftBuffer.data());
+                std::copy(bins, bins + numBins, channel.delayLine.begin() + slot * numBins);
+
+                // Everything past the tail limit: the result is silence
+                if (job.activePartitions == 0)
+                {
+                    std::fill_n(job.result.begin() + ch * partitionSize, partitionSize, 0.0f);
+                    continue;
+                }
+
+                // Multiply-accumulate: sum over k of X[n - k] * H[k], fading partitions scaled
+                std::fill(accumulator.begin(), accumulator.end(), std::complex<float>());
+                for (int k = 0; k < job.activePartitions; ++k)
+                {
+                    const int inputSlot = (slot - k + numPartitions) % numPartitions;
+                    const auto* x = channel.delayLine.data() + inputSlot * numBins;
+                    const auto* h = channel.partitions + k * numBins;
+
+                    if (k < job.fadeStart)
+                    {
+                        for (int b = 0; b < numBins; ++b)
+                            accumulator[static_cast<size_t>(b)] += x[b] * h[b];
+                    }
+                    else
+                    {
+                        for (int b = 0; b < numBins; ++b)
+                            accumulator[static_cast<size_t>(b)] += x[b] * h[b] * job.fadeGain;
+                    }
+                }
+
+                // Inverse FFT (with the mirrored negative frequencies filled in), keep the valid half
+                auto* out = reinterpret_cast<std::complex<float>*>(fftBuffer.data());
+                std::copy(accumulator.begin(), accumulator.end(), out);
+                const int fftSize = 2 * partitionSize;
+                for (int b = numBins; b < fftSize; ++b)
+                    out[b] = std::conj(out[fftSize - b]);
+
+                fft.performRealOnlyInverseTransform(fftBuffer.data());
+                std::copy(fftBuffer.begin() + partitionSize, fftBuffer.begin() + 2 * partitionSize, job.result.begin() + ch * partitionSize);
+            }
+
+            delayLineHead = (delayLineHead + 1) % numPartitions;
+        }
+
+        void writeResults(const Job& job, juce::int64 outputTime, float* const* ring, int ringMask) noexcept
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                addToRing(ring[ch], ringMask, outputTime, job.result.data() + ch * partitionSize, partitionSize);
+        }
+
+        const int partitionSize;
+        const int firstSample;
+        const int latency;
+        const int jobsInFlight;
+        const int numChannels;
+        const int numBins;
+        int numPartitions = 0;
+
+        juce::dsp::FFT fft;
+        std::shared_ptr<const ImpulseResponseCache::Spectra> spectra;
+        std::vector<float> fftBuffer;
+        std::vector<std::complex<float>> accumulator;
+        std::vector<Channel> channels;
+        std::vector<Job> jobs;
+        int delayLineHead = 0;
+
+        // Tail limit, audio thread. Partitions [fadeStart, activePartitions) are fading
+        // in or out while fadeJobsRemaining > 0; otherwise fadeStart == activePartitions.
+        int tailLimit = 0;
+        bool tailLimitApplied = false;
+        int activePartitions = 0;
+        int fadeStart = 0;
+        int fadeJobsRemaining = 0;
+        bool fadingIn = false;
+
+        // Job n lives in jobs[n % jobs.size()], one slot more than are in flight, so a job
+        // that finishes a little late has still freed its slot by the time it is needed.
+        // The audio thread submits. A job is claimed by moving nextToRun past it, and only
+        // once completed has reached it: the jobs share the delay line, so they run one at
+        // a time and in order, whichever thread runs them.
+        std::atomic<juce::int64> submitted { 0 };
+        std::atomic<juce::int64> nextToRun { 0 };
+        std::atomic<juce::int64> completed { 0 };
+        std::atomic<juce::uint32> liveGeneration { 0 }; // jobs of older generations are skipped
+
+        // Audio thread
+        juce::int64 nextToCollect = 0;
+        juce::uint32 generation = 0;
+
+        // Whoever is running jobs: the generation the delay line holds
+        juce::uint32 historyGeneration = 0;
+    };
+}
+
+//==============================================================================
+// Everything needed to convolve with one IR. Built off the audio thread, then handed over.
+class PartitionedConvolver::Engine
+{
+public:
+    Engine(const ImpulseResponseCache::ImpulseResponse& ir, int numChannelsToUse, int maxBlockSize, int latencySamples, std::atomic<int>& missedDeadlineCounter)
+        : numChannels(numChannelsToUse),
+          irLength(ir.buffer.getNumSamples()),
+          latency(latencySamples),
+          missedDeadlines(missedDeadlineCounter)
+    {
+        // Direct FIR head, stored reversed so the dot product walks both arrays forwards
+        head.setSize(numChannels, headLength);
+        head.clear();
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const float* irData = ir.buffer.getReadPointer(ch % ir.buffer.getNumChannels());
+            for (int k = 0; k < juce::jmin(headLength, irLength); ++k)
+                head.setSample(ch, headLength - 1 - k, irData[k]);
+        }
+
+        // The head's output goes latency samples ahead, the stages' further still
+        int ringSize = headLength + latency;
+        for (size_t i = 0; i < std::size(stageLayouts); ++i)
+        {
+            const auto& layout = stageLayouts[i];
+            if (layout.firstSample >= irLength) break;
+
+            const int lastSample = i + 1 < std::size(stageLayouts) ? juce::jmin(irLength, stageLayouts[i + 1].firstSample) : irLength;
+            stages.push_back(std::make_unique<UniformStage>(ir, layout, lastSample, numChannels, latency));
+            ringSize = juce::jmax(ringSize, stages.back()->getLookahead());
+        }
+
+        ringSize = juce::nextPowerOfTwo(ringSize);
+        ringMask = ringSize - 1;
+        ring.setSize(numChannels, ringSize);
+        ring.clear();
+
+        history.setSize(numChannels, 2 * headLength);
+        history.clear();
+        inputCopy.setSize(numChannels, juce::jmax(1, maxBlockSize));
+    }
+
+    void reset() noexcept
+    {
+        for (auto& stage : stages)
+            stage->reset();
+
+        ring.clear();
+        history.clear();
+        time = 0;
+    }
+
+    // input and output may alias. Returns true if it queued jobs for the worker pool.
+    bool process(const float* const* input, float* const* output, int numChannelsToProcess, int numSamples, int tailLimit, bool realtime) noexcept
+    {
+        jassert(numChannelsToProcess <= numChannels && numSamples <= inputCopy.getNumSamples());
+
+        for (auto& stage : stages)
+            stage->setTailLimit(tailLimit);
+
+        for (int ch = 0; ch < numChannelsToProcess; ++ch)
+            inputCopy.copyFrom(ch, 0, input[ch], numSamples);
+
+        bool submittedJobs = false;
+        int done = 0;
+        while (done < numSamples)
+        {
+            // Never cross a 64-sample boundary: every partition size is a multiple of it
+            const int n = juce::jmin(numSamples - done, headLength - static_cast<int>(time % headLength));
+
+            for (int ch = 0; ch < numChannelsToProcess; ++ch)
+            {
+                const float* in = inputCopy.getReadPointer(ch, done);
+                float* out = output[ch] + done;
+
+                processHead(ch, in, out, n);
+
+                for (auto& stage : stages)
+                    stage->pushInput(ch, in, time, n);
+
+                // With latency the head's output is due later, like everything else
+                float* ringData = ring.getWritePointer(ch);
+                if (latency > 0)
+                {
+                    addToRing(ringData, ringMask, time + latency, out, n);
+                    std::fill(out, out + n, 0.0f);
+                }
+
+                // Everything scheduled for these samples
+                for (int i = 0; i < n; ++i)
+                {
+                    const int index = static_cast<int>((time + i) & ringMask);
+                    out[i] += ringData[index];
+                    ringData[index] = 0.0f;
+                }
+            }
+
+            time += n;
+            done += n;
+
+            if (time % headLength == 0)
+                for (auto& stage : stages)
+                    if (time % stage->getPartitionSize() == 0)
+                        submittedJobs = stage->onBoundary(time, ring.getArrayOfWritePointers(), ringMask, missedDeadlines, realtime) || submittedJobs;
+        }
+
+        return submittedJobs;
+    }
+
+    bool runBackgroundJobs() noexcept
+    {
+        bool didWork = false;
+        for (auto& stage : stages)
+            if (stage->isBackground())
+                didWork = stage->tryRunPendingJobs() || didWork;
+        return didWork;
+    }
+
+    int getIRLength() const noexcept { return irLength; }
+
+private:
+    void processHead(int ch, const float* in, float* out, int n) noexcept
+    {
+        // history: [headLength - 1 previous samples | n new samples]
+        float* h = history.getWritePointer(ch);
+        std::copy(in, in + n, h + headLength - 1);
+
+        const float* taps = head.getReadPointer(ch);
+        for (int i = 0; i < n; ++i)
+        {
+            const float* x = h + i;
+            float sum = 0.0f;
+            for (int k = 0; k < headLength; ++k)
+                sum += taps[k] * x[k];
+            out[i] = sum;
+        }
+
+        std::copy(h + n, h + n + headLength - 1, h);
+    }
+
+    const int numChannels;
+    const int irLength;
+    const int latency;
+    std::atomic<int>& missedDeadlines;
+
+    juce::AudioBuffer<float> head;
+    juce::AudioBuffer<float> history;
+    juce::AudioBuffer<float> inputCopy;
+    juce::AudioBuffer<float> ring;
+    int ringMask = 0;
+    juce::int64 time = 0;
+
+    std::vector<std::unique_ptr<UniformStage>> stages;
+};
+
+//==============================================================================
+PartitionedConvolver::PartitionedConvolver()
+{
+    poolSlot = workerPool->add(this);
+}
+
+PartitionedConvolver::~PartitionedConvolver()
+{
+    workerPool->remove(poolSlot);
+
+    delete pendingEngine.exchange(nullptr);
+    delete retiredEngine.exchange(nullptr);
+}
+
+int PartitionedConvolver::getOffloadLatency(int maximumBlockSize) noexcept
+{
+    const int twoBlocks = (2 * juce::jmax(1, maximumBlockSize) + headLength - 1) / headLength * headLength;
+    return juce::jmax(1024, twoBlocks);
+}
+
+void PartitionedConvolver::prepare(const juce::dsp::ProcessSpec& spec, int latencySamples)
+{
+    // Every stage boundary is a multiple of the head length; so must the latency be
+    jassert(latencySamples >= 0 && latencySamples % headLength == 0);
+
+    const std::lock_guard<std::mutex> scopedLock(loaderLock);
+
+    // Keep the workers away from the engines we are about to drop
+    workerPool->remove(poolSlot);
+
+    liveEngine.store(nullptr);
+    liveFadingEngine.store(nullptr);
+    activeEngine.reset();
+    fadingEngine.reset();
+    fadeSamplesRemaining = 0;
+    delete pendingEngine.exchange(nullptr);
+    delete retiredEngine.exchange(nullptr);
+
+    preparedSpec = spec;
+    latency = juce::jmax(0, latencySamples / headLength * headLength);
+    isPrepared = true;
+    fadeScratch.setSize(juce::jmin(maxChannels, static_cast<int>(spec.numChannels)), static_cast<int>(spec.maximumBlockSize));
+    currentIRSize.store(0);
+    resetRequested.store(false);
+
+    poolSlot = workerPool->add(this);
+}
+
+void PartitionedConvolver::reset() noexcept
+{
+    resetRequested.store(true);
+}
+
+void PartitionedConvolver::loadImpulseResponse(ImpulseResponseCache::Ptr ir)
+{
+    if (ir == nullptr || ir->buffer.getNumSamples() == 0) return;
+
+    const std::lock_guard<std::mutex> scopedLock(loaderLock);
+    currentIR = ir;
+
+    // Without a pool slot (every one taken) no worker deletes retired engines, and none
+    // runs their jobs either, so it is done here. The audio thread only starts the next
+    // crossfade once the last old engine is gone.
+    if (poolSlot < 0)
+        delete retiredEngine.exchange(nullptr, std::memory_order_acq_rel);
+
+    if (!isPrepared) return;
+
+    auto engine = std::make_unique<Engine>(*ir,
+        juce::jmin(maxChannels, static_cast<int>(preparedSpec.numChannels)),
+        static_cast<int>(preparedSpec.maximumBlockSize),
+        latency,
+        missedDeadlines);
+
+    // An engine that was never picked up is simply replaced
+    delete pendingEngine.exchange(engine.release(), std::memory_order_acq_rel);
+}
+
+void PartitionedConvolver::process(const juce::dsp::ProcessContextReplacing<float>& context) noexcept
+{
+    auto& block = context.getOutputBlock();
+    const int numSamples = static_cast<int>(block.getNumSamples());
+    const int numChannels = static_cast<int>(block.getNumChannels());
+
+    if (resetRequested.exchange(false))
+    {
+        if (activeEngine != nullptr) activeEngine->reset();
+        if (fadingEngine != nullptr) fadingEngine->reset();
+    }
+
+    bool wakeWorkers = false;
+
+    // Finish a crossfade whose old engine is waiting for the pool to delete it
+    if (fadingEngine != nullptr && fadeSamplesRemaining <= 0 && retiredEngine.load() == nullptr)
+    {
+        liveFadingEngine.store(nullptr, std::memory_order_release);
+        retiredEngine.store(fadingEngine.release(), std::memory_order_release);
+        wakeWorkers = true;
+    }
+
+    // Pick up a new IR (one crossfade at a time)
+    if (fadingEngine == nullptr)
+    {
+        if (auto* incoming = pendingEngine.exchange(nullptr, std::memory_order_acq_rel))
+        {
+            fadingEngine = std::move(activeEngine);
+            fadeSamplesRemaining = fadingEngine != nullptr ? crossfadeSamples : 0;
+            activeEngine.reset(incoming);
+
+            liveEngine.store(activeEngine.get(), std::memory_order_release);
+            liveFadingEngine.store(fadingEngine.get(), std::memory_order_release);
+            currentIRSize.store(activeEngine->getIRLength(), std::memory_order_relaxed);
+        }
+    }
+
+    if (activeEngine == nullptr)
+    {
+        block.clear();
+        notifyWorkers(wakeWorkers);
+        return;
+    }
+
+    float* outputs[maxChannels] = {};
+    float* fadeOutputs[maxChannels] = {};
+    jassert(numChannels <= juce::jmin(maxChannels, fadeScratch.getNumChannels()));
+
+    const int channelsToProcess = juce::jmin(numChannels, maxChannels, fadeScratch.getNumChannels());
+
+    for (int ch = 0; ch < channelsToProcess; ++ch)
+    {
+        outputs[ch] = block.getChannelPointer(static_cast<size_t>(ch));
+        fadeOutputs[ch] = fadeScratch.getWritePointer(ch);
+    }
+
+    if (fadingEngine != nullptr && fadeSamplesRemaining > 0)
+    {
+        // Old engine into scratch first (it reads the same input)
+        wakeWorkers = fadingEngine->process(outputs, fadeOutputs, channelsToProcess, numSamples, tailLimit, !nonRealtime) || wakeWorkers;
+        wakeWorkers = activeEngine->process(outputs, outputs, channelsToProcess, numSamples, tailLimit, !nonRealtime) || wakeWorkers;
+
+        for (int ch = 0; ch < channelsToProcess; ++ch)
+        {
+            int remaining = fadeSamplesRemaining;
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const float oldGain = remaining > 0 ? static_cast<float>(remaining) / static_cast<float>(crossfadeSamples) : 0.0f;
+                outputs[ch][i] = outputs[ch][i] * (1.0f - oldGain) + fadeOutputs[ch][i] * oldGain;
+                remaining = juce::jmax(0, remaining - 1);
+            }
+        }
+
+        fadeSamplesRemaining = juce::jmax(0, fadeSamplesRemaining - numSamples);
+        notifyWorkers(wakeWorkers);
+        return;
+    }
+
+    wakeWorkers = activeEngine->process(outputs, outputs, channelsToProcess, numSamples, tailLimit, !nonRealtime) || wakeWorkers;
+    notifyWorkers(wakeWorkers);
+}
+
+void PartitionedConvolver::notifyWorkers(bool hasWork) noexcept
+{
+    // Without a slot (every one taken) the audio thread runs each job at its deadline
+    if (hasWork && poolSlot >= 0)
+        workerPool->notify(poolSlot);
+}
+
+bool PartitionedConvolver::runBackgroundWork()
+{
+    bool didWork = false;
+
+    if (auto* engine = liveEngine.load(std::memory_order_acquire))
+        didWork = engine->runBackgroundJobs() || didWork;
+
+    if (auto* engine = liveFadingEngine.load(std::memory_order_acquire))
+        didWork = engine->runBackgroundJobs() || didWork;
+
+    // The audio thread unpublished this engine before retiring it, so nothing else can be using it
+    delete retiredEngine.exchange(nullptr, std::memory_order_acq_rel);
+
+    return didWork;
+}
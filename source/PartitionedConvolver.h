@@ -0,0 +1,119 @@
+#pragma once
+
+#include "ConvolutionWorkerPool.h"
+#include "ImpulseResponseCache.h"
+#include <juce_dsp/juce_dsp.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Non-uniformly partitioned convolution reverb, zero latency by default.
+//
+// The impulse response is split into segments of growing partition size:
+//
+//   [0, 64)        direct FIR                          inline, zero latency
+//   [64, 1024)     64-sample FFT partitions            inline
+//   [1024, 8192)   512-sample FFT partitions           inline
+//   [8192, end)    4096-sample FFT partitions          worker pool
+//
+// Every segment starts at least one partition length into the IR, so its result is
+// due no earlier than it can be computed; the tail segment starts two partitions in,
+// which gives the worker pool a full 4096-sample deadline per job. If a job is
+// not done by then the audio thread finishes it itself, so the output never depends
+// on scheduling. Cost per callback is therefore small and flat even at 32-sample
+// buffers with 5-10 s IRs.
+//
+// Prepared with a latency (a multiple of 64, see getOffloadLatency) every FFT stage runs
+// on the pool: each segment's result is then due that many samples later, which leaves
+// room for several jobs in flight per stage, and the audio thread only runs the 64-tap
+// head and picks up finished results. The whole output is delayed by the latency.
+//
+// Drop-in for juce::dsp::Convolution on the reverb path: prepare / reset / process /
+// getCurrentIRSize. New IRs are partitioned on the calling (non-audio) thread and
+// crossfaded in on the audio thread without allocating. The partition spectra belong to
+// the IR (ImpulseResponse::getSpectra), so instances with the same IR share one copy.
+class PartitionedConvolver : private ConvolutionWorkerPool::Client
+{
+public:
+    // Up to 7.1; channels beyond the IR's own alternate between its left and right
+    static constexpr int maxChannels = 8;
+
+    // Latency that moves every FFT stage onto the worker pool: at least two host blocks,
+    // so a job submitted in one callback is never due before the next has started
+    static int getOffloadLatency(int maximumBlockSize) noexcept;
+
+    PartitionedConvolver();
+    ~PartitionedConvolver() override;
+
+    // Audio must be stopped (prepareToPlay). Drops the current engine; call loadImpulseResponse after.
+    // latencySamples delays the output by that much (a multiple of 64; 0 for none).
+    void prepare(const juce::dsp::ProcessSpec& spec, int latencySamples = 0);
+
+    int getLatencySamples() const noexcept { return latency; }
+
+    // Clears the reverb tail on the next process call
+    void reset() noexcept;
+
+    // Message/loader thread only. The shared IR data is read, never copied into the audio path.
+    void loadImpulseResponse(ImpulseResponseCache::Ptr ir);
+
+    void process(const juce::dsp::ProcessContextReplacing<float>& context) noexcept;
+
+    // Audio thread. Stops convolving IR samples past `samples` (0 for the whole IR), which
+    // saves most of the cost of a long tail; the cut partitions fade out over several of
+    // their own lengths, and back in when the limit is lifted. The tail keeps being fed
+    // meanwhile, so it returns exactly as it would have sounded.
+    void setTailLimit(int samples) noexcept { tailLimit = juce::jmax(0, samples); }
+    int getTailLimit() const noexcept { return tailLimit; }
+
+    // Audio thread. In realtime a job the pool is late with is run here if no worker has
+    // started it, and dropped (a partition of silence) if one has. Offline renders have no
+    // deadline: they wait for it instead, so the output never depends on the workers.
+    void setNonRealtime(bool isNonRealtime) noexcept { nonRealtime = isNonRealtime; }
+
+    // Length of the IR currently being heard (0 until the first one is installed)
+    int getCurrentIRSize() const noexcept { return currentIRSize.load(std::memory_order_relaxed); }
+
+    // How often a job was not ready in time (run on the audio thread, or dropped)
+    int getNumMissedDeadlines() const noexcept { return missedDeadlines.load(std::memory_order_relaxed); }
+
+    class Engine;
+
+private:
+    // Called by the worker pool, never by two workers at once
+    bool runBackgroundWork() override;
+
+    // Audio thread: hands queued jobs and retired engines to the pool
+    void notifyWorkers(bool hasWork) noexcept;
+
+    juce::dsp::ProcessSpec preparedSpec {};
+    bool isPrepared = false;
+    int latency = 0;
+
+    // Audio thread
+    std::unique_ptr<Engine> activeEngine;
+    std::unique_ptr<Engine> fadingEngine;
+    int fadeSamplesRemaining = 0;
+    int tailLimit = 0;
+    bool nonRealtime = false;
+    juce::AudioBuffer<float> fadeScratch;
+
+    // Hand-over between threads
+    std::atomic<Engine*> pendingEngine { nullptr };     // loader -> audio
+    std::atomic<Engine*> retiredEngine { nullptr };     // audio -> pool (deleted there, or by the loader without a slot)
+    std::atomic<Engine*> liveEngine { nullptr };        // audio -> pool (jobs)
+    std::atomic<Engine*> liveFadingEngine { nullptr };  // audio -> pool (jobs)
+
+    std::atomic<bool> resetRequested { false };
+    std::atomic<int> currentIRSize { 0 };
+    std::atomic<int> missedDeadlines { 0 };
+
+    std::mutex loaderLock;
+    ImpulseResponseCache::Ptr currentIR;
+
+    juce::SharedResourcePointer<ConvolutionWorkerPool> workerPool;
+    int poolSlot = -1;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PartitionedConvolver)
+};
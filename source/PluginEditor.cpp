@@ -96,6 +96,33 @@ PluginEditor::PluginEditor(PluginProcessor& p)
 
     setupSlider(inputGainSlider, inputGainLabel, "Input Gain", "inputGain");
     addAndMakeVisible(peakLed);
+
+    addAndMakeVisible(tapeScope);
+    addAndMakeVisible(spectrumView);
+    tapeScope.setTooltip("Playback level of each tape head over the last two seconds.");
+    spectrumView.setTooltip("Spectrum of the wet signal (echoes and reverb).");
+    processorRef.wetSpectrum.setActive(true);
+
+    if (PluginProcessor::hasDspLoadStatistics)
+    {
+        dspLoadLabel.setFont(juce::Font(11.0f));
+        dspLoadLabel.setJustificationType(juce::Justification::centredRight);
+        dspLoadLabel.setColour(juce::Label::textColourId, juce::Colours::black);
+        dspLoadLabel.setTooltip("DSP time per block as a share of the block's real-time length.");
+        addAndMakeVisible(dspLoadLabel);
+    }
+
+    addAndMakeVisible(adaptiveQualityButton);
+    adaptiveQualityButton.setColour(juce::ToggleButton::textColourId, juce::Colours::black);
+    adaptiveQualityButton.setTooltip("Under CPU pressure, shortens the reverb tail, then uses cheaper interpolation, then simpler flutter, and restores them when the load drops.");
+    adaptiveQualityAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(processorRef.parameters, "adaptiveQuality", adaptiveQualityButton);
+
+    qualityTierLabel.setFont(juce::Font(11.0f));
+    qualityTierLabel.setJustificationType(juce::Justification::centred);
+    qualityTierLabel.setColour(juce::Label::textColourId, juce::Colours::black);
+    addAndMakeVisible(qualityTierLabel);
+    updateQualityTierReadout();
+
     startTimerHz(30); // Start the LED update timer
 
     // --- Effect knobs ---
@@ -156,12 +183,42 @@ PluginEditor::PluginEditor(PluginProcessor& p)
 }
 
 PluginEditor::~PluginEditor() {
+    processorRef.wetSpectrum.setActive(false);
     setLookAndFeel(nullptr);
     attachments.clear(); // destroy attachments first
 }
 
 
 void PluginEditor::paint(juce::Graphics& g)
+{
+    // The chrome never changes between resizes, so paint is a single blit. The image is
+    // kept at the physical pixel scale so it stays sharp on HiDPI displays.
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+    if (chromeImage.isNull() || scale != chromeScale)
+    {
+        const auto width = juce::jmax(1, juce::roundToInt(static_cast<float>(getWidth()) * scale));
+        const auto height = juce::jmax(1, juce::roundToInt(static_cast<float>(getHeight()) * scale));
+
+        chromeImage = juce::Image(juce::Image::ARGB, width, height, true);
+        chromeScale = scale;
+
+        juce::Graphics cg(chromeImage);
+        cg.addTransform(juce::AffineTransform::scale(scale));
+        renderChrome(cg);
+    }
+
+    g.drawImage(chromeImage, getLocalBounds().toFloat());
+}
+
+void PluginEditor::invalidateRenderCaches()
+{
+    chromeImage = {};
+    myLookAndFeel.clearRenderCaches();
+    repaint();
+}
+
+void PluginEditor::renderChrome(juce::Graphics& g)
 {
     // 1. Background (The Case - light grey Tolex style)
     g.fillAll(juce::Colour(0x6dc1cbc1));
@@ -189,6 +246,8 @@ void PluginEditor::paint(juce::Graphics& g)
 
 void PluginEditor::resized()
 {
+    chromeImage = {}; // re-rendered at the new size on the next paint
+
     auto area = getLocalBounds().reduced(20);
     area.removeFromTop(40); // Skip title
 
@@ -210,6 +269,7 @@ void PluginEditor::resized()
     bypassButton.setBounds(leftCol.getX() + 10, startY + 230, 100, buttonHeight);
     killDryButton.setBounds(leftCol.getX() + 10, startY + 275, 100, buttonHeight);
     initButton.setBounds(leftCol.getX() + 10, startY + 320, 100, buttonHeight);
+    adaptiveQualityButton.setBounds(leftCol.getX() + 10, startY + 358, 100, 25);
 
     // Add a visual gap between the vertical line and the right-side controls
     area.removeFromLeft(20);
@@ -223,6 +283,7 @@ void PluginEditor::resized()
     inputGainLabel.setBounds(col0, bottomStrip.getY(), mixKnobWidth, 20);
     inputGainSlider.setBounds(col0, bottomStrip.getY() + 20, mixKnobWidth, 80);
     peakLed.setBounds(col0 + mixKnobWidth - 30, bottomStrip.getY() + 10, 15, 15);
+    dspLoadLabel.setBounds(col0 + mixKnobWidth - 90, bottomStrip.getY() + 100, 75, 16);
 
     // 2. ECHO MIX
     int col1 = bottomStrip.getX() + mixKnobWidth;
@@ -249,6 +310,9 @@ void PluginEditor::resized()
     masterGainLabel.setBounds(col4, bottomStrip.getY(), mixKnobWidth, 20);
     masterGainSlider.setBounds(col4, bottomStrip.getY() + 20, mixKnobWidth, 80);
 
+    // Under the master knobs, where there is room for the longest tier name
+    qualityTierLabel.setBounds(col3, bottomStrip.getY() + 102, 2 * mixKnobWidth, 16);
+
     // --- 3. MAIN EFFECTS GRID (Repacked for balance) ---
     int knobSize = 90;
     int spacing = 35; // Wider spacing to fill the new width
@@ -289,17 +353,88 @@ void PluginEditor::resized()
 
     trebleLabel.setBounds(x4, row2Y, knobSize, 20);
     trebleSlider.setBounds(x4, row2Y + 20, knobSize, knobSize);
+
+    // --- 4. SCOPES (the free space right of the knob grid) ---
+    tapeScope.setBounds(x4, row1Y, area.getRight() - x4, knobSize + 20);
+    int spectrumX = x4 + knobSize + 15;
+    spectrumView.setBounds(spectrumX, row2Y, area.getRight() - spectrumX, knobSize + 20);
 }
 
 void PluginEditor::timerCallback()
 {
-    // 0.95f is almost clipping (digital absolute zero is 1.0f)
-    float currentPeak = processorRef.inputPeakLevel.load();
+    // Every frame since the last tick, so a short transient can't slip between two polls
+    float currentPeak = 0.0f;
+    processorRef.telemetry.popAll([this, &currentPeak](const TelemetryFrame& frame) {
+        currentPeak = juce::jmax(currentPeak, frame.inputPeak);
+        tapeScope.addFrame(frame);
+    });
 
+    tapeScope.refresh();
+    spectrumView.refresh(processorRef.wetSpectrum);
+
+    // 0.95f is almost clipping (digital absolute zero is 1.0f)
     if (currentPeak >= 0.95f)
         ledDecay = 1.0f; // Flash bright!
     else
-        ledDecay *= 0.85f; // Fade out smoothly
+        ledDecay = ledDecay > 0.01f ? ledDecay * 0.85f : 0.0f; // Fade out smoothly, then rest
 
     peakLed.setBrightness(ledDecay);
+
+    // The numbers would be unreadable at 30 Hz; refresh a few times a second
+    if (PluginProcessor::hasDspLoadStatistics && ++dspLoadTicks >= 8)
+    {
+        dspLoadTicks = 0;
+        updateDspLoadReadout();
+    }
+
+    if (++qualityTierTicks >= 8)
+    {
+        qualityTierTicks = 0;
+        updateQualityTierReadout();
+    }
+}
+
+void PluginEditor::updateQualityTierReadout()
+{
+    // Only while the governor is on; reduced tiers stand out
+    const bool enabled = adaptiveQualityButton.getToggleState();
+    qualityTierLabel.setVisible(enabled);
+    if (!enabled) return;
+
+    const auto tier = processorRef.getQualityTier();
+    qualityTierLabel.setText(juce::String("Quality: ") + QualityGovernor::getTierName(tier), juce::dontSendNotification);
+    qualityTierLabel.setColour(juce::Label::textColourId, tier == QualityGovernor::Tier::full ? juce::Colours::black : juce::Colours::darkred);
+    qualityTierLabel.setTooltip("Load " + juce::String(processorRef.getGovernorLoad() * 100.0f, 1) + "% of the block duration, smoothed");
+}
+
+void PluginEditor::updateDspLoadReadout()
+{
+    const auto stats = processorRef.getDspLoadStatistics();
+    if (stats.windowSize == 0)
+    {
+        dspLoadLabel.setText("DSP --", juce::dontSendNotification);
+        return;
+    }
+
+    dspLoadLabel.setText("DSP " + juce::String(stats.meanLoad * 100.0, 1) + "%", juce::dontSendNotification);
+
+    // Breakdown on hover: p99 per stage, worst block and overruns
+    juce::String details;
+    details << "Mean " << juce::String(stats.meanLoad * 100.0, 1) << "%, peak "
+            << juce::String(stats.peakLoad * 100.0, 1) << "% of the block duration\n"
+            << "Block p99 " << juce::String(stats.total.p99 * 1.0e6, 0) << " us, max "
+            << juce::String(stats.total.max * 1.0e6, 0) << " us\n";
+
+    for (int s = 0; s < DspLoadMonitor::numStages; ++s)
+    {
+        const auto stage = static_cast<DspLoadMonitor::Stage>(s);
+        details << DspLoadMonitor::getStageName(stage) << ": p99 "
+                << juce::String(stats[stage].p99 * 1.0e6, 1) << " us\n";
+    }
+
+    details << "Overruns: " << juce::String(static_cast<juce::int64>(stats.numOverruns))
+            << " of " << juce::String(static_cast<juce::int64>(stats.numBlocks)) << " blocks";
+
+    dspLoadLabel.setTooltip(details);
+    dspLoadLabel.setColour(juce::Label::textColourId, stats.peakLoad >= 1.0 ? juce::Colours::darkred : juce::Colours::black);
 }
\ No newline at end of file
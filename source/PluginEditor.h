@@ -4,14 +4,19 @@
 
 #include "PluginProcessor.h"
 #include "BinaryData.h"
+#include "TelemetryViews.h"
 #include "melatonin_inspector/melatonin_inspector.h"
+#include <map>
 #include <vector>
 
 class OverloadLED : public juce::Component
 {
 public:
     void setBrightness(float b) {
-        brightness = juce::jlimit(0.0f, 1.0f, b);
+        b = juce::jlimit(0.0f, 1.0f, b);
+        // Skip the repaint while the LED sits dark (or hasn't visibly changed)
+        if (std::abs(b - brightness) < 0.004f) return;
+        brightness = b;
         repaint();
     }
     void paint(juce::Graphics& g) override {
@@ -58,23 +63,23 @@ public:
         auto rw = radius * 2.0f;
         auto angle = rotaryStartAngle + sliderPos * (rotaryEndAngle - rotaryStartAngle);
 
-        // A. Knob Body (Dark recessed circle)
-        g.setColour(juce::Colour(0xff202020));
-        g.fillEllipse(rx, ry, rw, rw);
+        // A + B. Knob body and silver ring: the same for every knob of this size, so it is
+        // rendered once per size and pixel scale and then only blitted
+        const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+        const auto& body = getKnobBody(rw, scale);
+        g.drawImageTransformed(body, juce::AffineTransform::scale(1.0f / scale).translated(rx - knobMargin, ry - knobMargin));
 
-        // B. Knob Outline (Silver ring)
-        g.setColour(juce::Colours::grey);
-        g.drawEllipse(rx, ry, rw, rw, 2.0f);
+        // C. Pointer (White Line), a cached rectangle drawn under the knob's rotation
+        g.setColour(juce::Colours::white);
+        g.fillPath(getPointer(radius), juce::AffineTransform::rotation(angle).translated(centreX, centreY));
+    }
 
-        // C. Pointer (White Line)
-        juce::Path p;
-        auto pointerLength = radius * 0.8f;
-        auto pointerThickness = 3.0f;
-        p.addRectangle(-pointerThickness * 0.5f, -radius, pointerThickness, pointerLength);
-        p.applyTransform(juce::AffineTransform::rotation(angle).translated(centreX, centreY));
+    int getNumCachedKnobBodies() const noexcept { return static_cast<int>(knobBodies.size()); }
 
-        g.setColour(juce::Colours::white);
-        g.fillPath(p);
+    void clearRenderCaches()
+    {
+        knobBodies.clear();
+        pointers.clear();
     }
 
     // --- 2. TAPE SWITCHES (Green LED Style) ---
@@ -112,6 +117,54 @@ public:
     {
         return juce::Font(14.0f, juce::Font::bold);
     }
+
+private:
+    // Room around the body for the outline stroke (it is centred on the ellipse edge)
+    static constexpr float knobMargin = 2.0f;
+
+    const juce::Image& getKnobBody(float diameter, float scale)
+    {
+        const auto key = std::make_pair(juce::roundToInt(diameter * 4.0f), juce::roundToInt(scale * 100.0f));
+        auto cached = knobBodies.find(key);
+        if (cached != knobBodies.end())
+            return cached->second;
+
+        // A handful of sizes per editor; anything beyond that is a resize storm, start over
+        if (knobBodies.size() > 16)
+            knobBodies.clear();
+
+        const int pixels = static_cast<int>(std::ceil((diameter + knobMargin * 2.0f) * scale));
+        juce::Image image(juce::Image::ARGB, pixels, pixels, true);
+        {
+            juce::Graphics ig(image);
+            ig.addTransform(juce::AffineTransform::scale(scale));
+
+            // A. Knob Body (Dark recessed circle)
+            ig.setColour(juce::Colour(0xff202020));
+            ig.fillEllipse(knobMargin, knobMargin, diameter, diameter);
+
+            // B. Knob Outline (Silver ring)
+            ig.setColour(juce::Colours::grey);
+            ig.drawEllipse(knobMargin, knobMargin, diameter, diameter, 2.0f);
+        }
+
+        return knobBodies.emplace(key, std::move(image)).first->second;
+    }
+
+    const juce::Path& getPointer(float radius)
+    {
+        auto& pointer = pointers[juce::roundToInt(radius * 4.0f)];
+        if (pointer.isEmpty())
+        {
+            auto pointerLength = radius * 0.8f;
+            auto pointerThickness = 3.0f;
+            pointer.addRectangle(-pointerThickness * 0.5f, -radius, pointerThickness, pointerLength);
+        }
+        return pointer;
+    }
+
+    std::map<std::pair<int, int>, juce::Image> knobBodies;
+    std::map<int, juce::Path> pointers;
 };
 
 //==============================================================================
@@ -124,6 +177,9 @@ public:
     //==============================================================================
     void paint (juce::Graphics&) override;
     void resized() override;
+
+    // Drops the cached background and knob images (benchmarks, look-and-feel changes)
+    void invalidateRenderCaches();
     std::vector<std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment>> attachments;
 
 private:
@@ -195,9 +251,30 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> syncAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> syncRateAttachment;
 
+    // Background, faceplate, divider and title, rendered once per size and pixel scale
+    void renderChrome(juce::Graphics& g);
+    juce::Image chromeImage;
+    float chromeScale = 0.0f;
+
     OverloadLED peakLed;
     float ledDecay = 0.0f;
 
+    // Fed from processorRef.telemetry / wetSpectrum on the timer
+    TapeScope tapeScope;
+    SpectrumView spectrumView;
+
+    // DSP load readout next to the LED (only in builds with CTD201_DSP_STATS)
+    juce::Label dspLoadLabel;
+    int dspLoadTicks = 0;
+    void updateDspLoadReadout();
+
+    // Adaptive quality switch, and the tier the governor has the processor on
+    juce::ToggleButton adaptiveQualityButton { "Adaptive" };
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> adaptiveQualityAttachment;
+    juce::Label qualityTierLabel;
+    int qualityTierTicks = 0;
+    void updateQualityTierReadout();
+
     void timerCallback() override;
 
 
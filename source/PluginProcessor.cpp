@@ -1,6 +1,5 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
-#include "BinaryData.h"
 
 //==============================================================================
 PluginProcessor::PluginProcessor()
@@ -39,100 +38,275 @@ parameters(*this, nullptr, "PARAMETERS", {
         "1/2", "1/4", "1/4 Dotted", "1/4 Triplet", "1/8", "1/8 Dotted", "1/8 Triplet", "1/16"
     }, 1), // Default is index 1 ("1/4")
 
+    std::make_unique<juce::AudioParameterBool>("antiAlias", "Anti-Alias Saturation", false),
+
+    // Tape head interpolation (TapeInterpolation::Quality order). The sinc is only used
+    // by the high-quality profile; the realtime one falls back to 6-point Lagrange.
+    std::make_unique<juce::AudioParameterChoice>("interpolation", "Interpolation", juce::StringArray{
+        "Linear", "Hermite", "Lagrange 4", "Lagrange 6", "Sinc (Offline)"
+    }, 0),
+
+    // RenderMode order: high quality for offline bounces only, or forced either way
+    std::make_unique<juce::AudioParameterChoice>("renderMode", "Render Quality", juce::StringArray{
+        "Auto", "Realtime", "High Quality"
+    }, 0),
+
+    // Lets the QualityGovernor trade quality for time under CPU pressure
+    std::make_unique<juce::AudioParameterBool>("adaptiveQuality", "Adaptive Quality", false),
+
+    // Read-only (QualityGovernor::Tier order): the tier in use, for the host to show
+    std::make_unique<juce::AudioParameterChoice>("qualityTier", "Quality Tier", juce::StringArray{
+        "Full", "Short Reverb Tail", "Cheap Interpolation", "Control-Rate Modulation"
+    }, 0, juce::AudioParameterChoiceAttributes().withAutomatable(false)),
+
 })
 
 {
-    delayTimeParam   = parameters.getRawParameterValue("delayTime");
-    feedbackParam    = parameters.getRawParameterValue("feedback");
-    saturationParam  = parameters.getRawParameterValue("saturation");
-    wowParam         = parameters.getRawParameterValue("wow");
-    flutterParam     = parameters.getRawParameterValue("flutter");
-    masterMixParam      = parameters.getRawParameterValue("wetDry");
-    echoMixParam        = parameters.getRawParameterValue ("echoMix");
-    reverbMixParam   = parameters.getRawParameterValue("reverbMix");
-    masterGainParam  = parameters.getRawParameterValue("masterGain");
-    bassParam = parameters.getRawParameterValue("bass");
-    trebleParam = parameters.getRawParameterValue("treble");
-    inputGainParam = parameters.getRawParameterValue("inputGain");
-    head1Param = parameters.getRawParameterValue("head1");
-    head2Param = parameters.getRawParameterValue("head2");
-    head3Param = parameters.getRawParameterValue("head3");
-    bypassParam = parameters.getRawParameterValue("bypass");
-    killDryParam = parameters.getRawParameterValue("killDry");
-    syncModeParam = parameters.getRawParameterValue("syncMode");
-    syncRateParam = parameters.getRawParameterValue("syncRate");
+    parameterSnapshot.attach(parameters);
+    midiControllers.attach(parameters);
+    qualityTierParameter = parameters.getParameter("qualityTier");
 
+    // Passes MIDI controller moves on to the host; fast enough that it follows a sweep
+    startTimerHz(30);
 }
 
 PluginProcessor::~PluginProcessor()
 {
+    stopTimer();
 }
 
 //==============================================================================
 void PluginProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
+    // One tape per channel: a mono track gets a single tape, a 7.1 bus eight,
+    // all in one contiguous allocation (see TapeRingBuffer)
+    const int scratchChannels = juce::jlimit(1, maxChannels, juce::jmax(getTotalNumInputChannels(), getTotalNumOutputChannels()));
+
     // --- 1. Delay Buffer Setup ---
-    const float maxDelayTimeMs = 2000.0f * 2.85f;
-    const int maxDelaySamples = static_cast<int>(sampleRate * maxDelayTimeMs / 1000.0);
+    // Long enough for the farthest read: the longest delay on the longest head (ratio 1),
+    // plus the wow/flutter swing and the interpolator's taps behind the read position
+    static_assert(wowDepthSamples + flutterDepthSamples * (1.0f + 0.5f * jitterDepth) <= static_cast<float>(maxModulationSamples));
+    const int maxDelaySamples = static_cast<int>(std::ceil(sampleRate * maxDelayTimeMs / 1000.0))
+                                + maxModulationSamples + TapeInterpolation::maxTaps;
+    const bool compactTape = isTapeCompact();
+
+    // --- 1b. Scratch Buffers ---
+    // Everything processBlock needs is sized here so the audio thread never allocates.
+    // Larger host blocks are rendered in slices of this size (see processBlock).
+    preparedBlockSize = juce::jmax(1, samplesPerBlock);
+
+    // With the reverb offloaded everything is delayed to line up with its return
+    reverbLatency = isReverbOffloaded() ? PartitionedConvolver::getOffloadLatency(preparedBlockSize) : 0;
+    setLatencySamples(reverbLatency);
+
+    // Gains, mix and EQ start settled at the current parameter values
+    parameterSnapshot.prepare(sampleRate);
+
+    // Only the engine for the host's precision holds a tape; the other one is freed
+    if (getProcessingPrecision() == doublePrecision)
+    {
+        doubleEngine.prepare(scratchChannels, maxDelaySamples, preparedBlockSize, reverbLatency, compactTape);
+        doubleEngine.setSaturationOversampled(wantsHighQuality(), true);
+        floatEngine.release();
+    }
+    else
+    {
+        floatEngine.prepare(scratchChannels, maxDelaySamples, preparedBlockSize, reverbLatency, compactTape);
+        floatEngine.setSaturationOversampled(wantsHighQuality(), true);
+        doubleEngine.release();
+    }
 
-    delayBuffer.setSize(2, maxDelaySamples);
-    delayBuffer.clear();
+    reverbInput.setSize(scratchChannels, preparedBlockSize);
+    reverbInput.clear();
 
-    writeIndex = 0;
+    saturator.prepare(scratchChannels);
+    saturator.reset();
+
+    renderPosition = 0;
+    tailTracker.reset();
+    idle.store(false, std::memory_order_relaxed);
 
     // Smooth delay time changes
     smoothedDelayTime.reset(sampleRate, 0.08); // 80ms smoothing
-    if (delayTimeParam) smoothedDelayTime.setCurrentAndTargetValue(delayTimeParam->load());
-
-    // --- 2. Initialize EQ Filters ---
-    bassFilters.resize(getTotalNumOutputChannels());
-    trebleFilters.resize(getTotalNumOutputChannels());
-
-    for (auto& f : bassFilters) f.reset();
-    for (auto& f : trebleFilters) f.reset();
+    smoothedDelayTime.setCurrentAndTargetValue(parameterSnapshot.getValues().delayTimeMs);
 
     // --- 3. DSP Spec Setup (Define this ONLY ONCE) ---
     juce::dsp::ProcessSpec spec;
     spec.sampleRate = sampleRate;
     spec.maximumBlockSize = static_cast<juce::uint32>(samplesPerBlock);
-    spec.numChannels = static_cast<juce::uint32>(getTotalNumOutputChannels());
+    spec.numChannels = static_cast<juce::uint32>(scratchChannels);
 
     // --- 4. Prepare Reverb ---
-    reverbConvolver.prepare(spec);
+    reverbConvolver.prepare(spec, reverbLatency);
     reverbConvolver.reset();
 
-    // --- 5. Load Default Impulse Response ---
-    if (BinaryData::DefaultReverbIR_wavSize > 0)
-    {
-        reverbConvolver.loadImpulseResponse(
-            BinaryData::DefaultReverbIR_wav,
-            static_cast<size_t>(BinaryData::DefaultReverbIR_wavSize),
-            juce::dsp::Convolution::Stereo::yes,
-            juce::dsp::Convolution::Trim::no,
-            static_cast<size_t>(BinaryData::DefaultReverbIR_wavSize),
-            juce::dsp::Convolution::Normalise::yes
-        );
-    }
+    // --- 5. Load Impulse Response ---
+    // Decoded, resampled and normalised once per process and shared between instances.
+    // A custom IR survives sample-rate changes and loads in the background; the default
+    // is the fallback.
+    requestImpulseResponse(sampleRate, true);
 
     // --- 6. Modulation LFO Init ---
-    wowPhase = 0.0f;
-    flutterPhase = 0.0f;
     wowRate = 0.1f;    // 0.1 Hz base rate
     flutterRate = 1.0f; // 1.0 Hz base rate
+    modulator.prepare(sampleRate);
+    modulator.setRates(wowRate, flutterRate);
+
+    // --- 7. Load statistics and the governor start over for the new block duration ---
+    loadMonitor.prepare(sampleRate);
+    governor.prepare(sampleRate);
+
+    // The heads start on the interpolation in force, without a fade
+    const auto interpolation = getEffectiveInterpolation(parameterSnapshot.getValues().interpolation, wantsHighQuality());
+    floatEngine.setInterpolation(interpolation, true);
+    doubleEngine.setInterpolation(interpolation, true);
+
+    // --- 8. Meters and analyser ---
+    telemetryAccumulator.prepare(sampleRate);
+    wetSpectrum.prepare(sampleRate);
 }
 
 void PluginProcessor::releaseResources()
 {
 }
 
+template <typename SampleType>
+void PluginProcessor::TapeEngine<SampleType>::prepare(int numChannels, int tapeLength, int blockSize, int latency, bool compactTape)
+{
+    // Guard samples for the widest interpolator, so no head read ever wraps
+    using Storage = typename TapeRingBuffer<SampleType>::Storage;
+    tape.prepare(numChannels, tapeLength, TapeInterpolation::maxTaps, compactTape ? Storage::compact16 : Storage::native);
+    tape.clear();
+
+    dryBuffer.setSize(numChannels, blockSize);
+    wetAccumulator.setSize(numChannels, blockSize);
+    echoBuffer.setSize(numChannels, blockSize);
+    feedbackScratch.setSize(2, blockSize); // the second holds the outgoing saturation while it fades
+    dryBuffer.clear();
+    wetAccumulator.clear();
+    echoBuffer.clear();
+    feedbackScratch.clear();
+
+    latencyLine.setSize(latency > 0 ? 2 * numChannels : 0, latency);
+    latencyLine.clear();
+    latencyPosition = 0;
+
+    oversampledSaturator.prepare(numChannels, blockSize);
+    loopLatency.reset(saturationFadeSamples);
+
+    kernel.prepare(blockSize);
+
+    // Bass/treble shelves on the echo, SIMD across channels on surround buses
+    filters.prepare(numChannels);
+}
+
+template <typename SampleType>
+void PluginProcessor::TapeEngine<SampleType>::release()
+{
+    tape.release();
+    oversampledSaturator.release();
+    dryBuffer.setSize(0, 0);
+    wetAccumulator.setSize(0, 0);
+    echoBuffer.setSize(0, 0);
+    feedbackScratch.setSize(0, 0);
+    latencyLine.setSize(0, 0);
+}
+
+template <typename SampleType>
+void PluginProcessor::TapeEngine<SampleType>::setSaturationOversampled(bool shouldOversample, bool immediately) noexcept
+{
+    const auto latency = shouldOversample ? oversampledSaturator.getLatencyInSamples() : SampleType(0);
+
+    if (immediately)
+    {
+        oversampledSaturator.reset();
+        saturationOversampled = shouldOversample;
+        saturationFadeRemaining = 0;
+        loopLatency.setCurrentAndTargetValue(latency);
+        return;
+    }
+
+    if (shouldOversample == saturationOversampled) return;
+
+    // The filters start clean when they fade in. Turning back mid-fade continues from
+    // the mix already reached instead of jumping.
+    if (shouldOversample && saturationFadeRemaining == 0)
+        oversampledSaturator.reset();
+
+    saturationOversampled = shouldOversample;
+    saturationFadeRemaining = saturationFadeSamples - saturationFadeRemaining;
+    loopLatency.setTargetValue(latency);
+}
+
+template <typename SampleType>
+void PluginProcessor::TapeEngine<SampleType>::setInterpolation(TapeInterpolation::Quality quality, bool immediately) noexcept
+{
+    if (immediately)
+    {
+        interpolation = previousInterpolation = quality;
+        interpolationFadeRemaining = 0;
+        return;
+    }
+
+    if (quality == interpolation) return;
+
+    if (interpolationFadeRemaining > 0)
+    {
+        // Turning back continues from the mix already reached
+        if (quality == previousInterpolation)
+        {
+            std::swap(interpolation, previousInterpolation);
+            interpolationFadeRemaining = interpolationFadeSamples - interpolationFadeRemaining;
+        }
+        return;
+    }
+
+    previousInterpolation = interpolation;
+    interpolation = quality;
+    interpolationFadeRemaining = interpolationFadeSamples;
+}
+
+template <typename SampleType>
+void PluginProcessor::TapeEngine<SampleType>::delayDryAndWet(int numChannels, int numSamples) noexcept
+{
+    const int latency = latencyLine.getNumSamples();
+    if (latency == 0) return;
+
+    // Swap each sample with the one written `latency` samples ago
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        SampleType* signals[] = { dryBuffer.getWritePointer(ch), wetAccumulator.getWritePointer(ch) };
+        SampleType* lines[] = { latencyLine.getWritePointer(ch), latencyLine.getWritePointer(numChannels + ch) };
+
+        for (size_t i = 0; i < 2; ++i)
+        {
+            int position = latencyPosition;
+            for (int n = 0; n < numSamples; ++n)
+            {
+                std::swap(signals[i][n], lines[i][position]);
+                if (++position == latency)
+                    position = 0;
+            }
+        }
+    }
+
+    latencyPosition = (latencyPosition + numSamples) % latency;
+}
+
+int PluginProcessor::getNumTapeChannels() const noexcept
+{
+    return juce::jmax(floatEngine.tape.getNumChannels(), doubleEngine.tape.getNumChannels());
+}
+
 bool PluginProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
 {
 #if JucePlugin_IsMidiEffect
     juce::ignoreUnused (layouts);
     return true;
 #else
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-        && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // Mono, stereo and anything up to 7.1 (5.0, 5.1, 7.0, quad, discrete...)
+    const auto& output = layouts.getMainOutputChannelSet();
+    if (output.isDisabled() || output.size() > maxChannels)
         return false;
 
 #if !JucePlugin_IsSynth
@@ -145,34 +319,156 @@ bool PluginProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
 }
 
 //==============================================================================
-void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
+void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    processBlockInternal(buffer, midiMessages);
+}
+
+void PluginProcessor::processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    processBlockInternal(buffer, midiMessages);
+}
+
+bool PluginProcessor::supportsDoublePrecisionProcessing() const { return true; }
+
+template <typename SampleType>
+void PluginProcessor::processBlockInternal(juce::AudioBuffer<SampleType>& buffer, const juce::MidiBuffer& midiMessages)
+{
+    if (preparedBlockSize <= 0) return;
+
+    // Flush-to-zero for the whole render; the feedback path also snaps tiny values itself
+    juce::ScopedNoDenormals noDenormals;
+
+    // The host sets the precision before prepareToPlay, so this is the engine that was prepared
+    auto& engine = getEngine<SampleType>();
+    jassert(!engine.tape.isEmpty());
+    if (engine.tape.isEmpty()) return;
+
+    // Some hosts send more samples than they announced in prepareToPlay.
+    // Rather than growing the scratch buffers on the audio thread, render in prepared-size slices.
+    // The slice buffers only reference the host's channel pointers, so nothing is allocated here.
+    const int totalSamples = buffer.getNumSamples();
+
+    // Deadline is the real-time length of the host block, not of each slice
+    loadMonitor.beginBlock(totalSamples);
+
+    // Host automation arrives between blocks: pick it up once, at the first sample
+    parameterSnapshot.pull();
+
+    // The governor times the whole block itself, only while it is on
+    const bool governed = isGovernorActive();
+    const auto blockStart = governed ? juce::Time::getHighResolutionTicks() : juce::int64();
+
+    auto endBlock = [&] {
+        loadMonitor.endBlock();
+        const double seconds = governed ? juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - blockStart) : 0.0;
+        governor.addBlock(seconds, totalSamples, governed);
+    };
+
+    // --- Idle: input and tape silent for longer than anything can still ring ---
+    // Nothing is rendered and the output is silence until the input comes back. The
+    // tape only holds sub-threshold residue by then, so waking up needs no clean-up.
+    if (tailTracker.hasDecayed(getIdleHoldSamples()))
+    {
+        const float inputGain = juce::jmax(parameterSnapshot.getInputGain().end, 1.0e-3f);
+        if (TailTracker::isSilent(buffer.getArrayOfReadPointers(), buffer.getNumChannels(), totalSamples, TailTracker::silenceThreshold / inputGain))
+        {
+            // Controllers still move their parameters while asleep
+            for (const auto metadata : midiMessages)
+                midiControllers.apply(metadata.getMessage(), parameterSnapshot);
+
+            buffer.clear();
+            idle.store(true, std::memory_order_relaxed);
+            renderPosition += totalSamples;
+            endBlock();
+            return;
+        }
+
+        tailTracker.reset();
+    }
+
+    idle.store(false, std::memory_order_relaxed);
+
+    // Mapped MIDI controllers split the block, so each one lands on its own sample.
+    // A block with no controller events and settled shelves goes through in whole slices.
+    auto event = midiMessages.cbegin();
+    const auto lastEvent = midiMessages.cend();
+
+    auto skipUnmapped = [&] {
+        while (event != lastEvent && !midiControllers.isMapped((*event).getMessage()))
+            ++event;
+    };
+
+    skipUnmapped();
+
+    for (int start = 0; start < totalSamples;)
+    {
+        // Everything due at or before this sample moves its parameter first
+        bool parametersMoved = false;
+        for (; event != lastEvent && (*event).samplePosition <= start; ++event, skipUnmapped())
+            parametersMoved = midiControllers.apply((*event).getMessage(), parameterSnapshot) || parametersMoved;
+
+        if (parametersMoved)
+            parameterSnapshot.pull();
+
+        int end = juce::jmin(totalSamples, start + preparedBlockSize);
+
+        if (event != lastEvent)
+            end = juce::jmin(end, (*event).samplePosition);
+
+        // While the shelves glide their coefficients step on a fixed grid of the render
+        // position, not once per slice, so an EQ sweep doesn't depend on the block size
+        if (parameterSnapshot.areFiltersRamping())
+        {
+            const auto position = renderPosition + start;
+            const auto nextStep = (position / controlInterval + 1) * controlInterval;
+            end = juce::jmin(end, start + static_cast<int>(nextStep - position));
+        }
+
+        const int sliceSamples = end - start;
+        juce::AudioBuffer<SampleType> slice(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), start, sliceSamples);
+        processSlice(slice, engine);
+        start = end;
+    }
+
+    renderPosition += totalSamples;
+    endBlock();
+}
+
+template <typename SampleType>
+void PluginProcessor::processSlice(juce::AudioBuffer<SampleType>& buffer, TapeEngine<SampleType>& engine)
 {
     const int numSamples  = buffer.getNumSamples();
-    const int numChannels = buffer.getNumChannels();
+    const int numChannels = juce::jmin(buffer.getNumChannels(), engine.dryBuffer.getNumChannels());
     const float sampleRate = static_cast<float>(getSampleRate());
 
+    loadMonitor.startStage(DspLoadMonitor::Stage::input);
+
     // --- 1. Load Parameters ---
-    float feedback      = 0.4f;
-    float saturation    = 0.5f;
-    float wowAmount     = 0.0f;
-    float flutterAmount = 0.0f;
-    float echoVol       = 0.5f;
-    float reverbVol     = 0.0f;
-    float masterMix     = 0.5f;
-    float masterGainDb  = 0.0f;
-    float bassDb        = 0.0f;
-    float trebleDb      = 0.0f;
-
-    if (head1Param) headEnabled[0] = head1Param->load() > 0.5f;
-    if (head2Param) headEnabled[1] = head2Param->load() > 0.5f;
-    if (head3Param) headEnabled[2] = head3Param->load() > 0.5f;
+    // Read by processBlock at the top of the block and after each controller event;
+    // derived gains and EQ coefficients are cached in the snapshot and only recomputed
+    // (and ramped) when their inputs change. Here the ramps move across this slice.
+    parameterSnapshot.advance(numSamples);
+    const auto& params = parameterSnapshot.getValues();
+
+    const float saturation    = params.saturation;
+    const float wowAmount     = params.wow;
+    const float flutterAmount = params.flutter;
+
+    // Gains that are applied per sample, so automation never steps at slice edges
+    const auto feedback  = parameterSnapshot.getFeedback();
+    const auto echoLevel = parameterSnapshot.getEchoLevel();
+    const auto reverbLevel = parameterSnapshot.getReverbLevel();
+    const float sliceLength = static_cast<float>(numSamples);
+    const float feedbackStep = (feedback.end - feedback.start) / sliceLength;
+    const float echoStep = (echoLevel.end - echoLevel.start) / sliceLength;
+    const float reverbStep = (reverbLevel.end - reverbLevel.start) / sliceLength;
 
     // Feed target to smoother instead of loading instantly
     // --- TEMPO SYNC LOGIC ---
     float targetDelayMs = 500.0f;
-    bool isSync = syncModeParam && syncModeParam->load() > 0.5f;
 
-    if (isSync)
+    if (params.syncMode)
     {
         double bpm = 120.0; // Default fallback
         if (auto* playHead = getPlayHead()) {
@@ -183,7 +479,7 @@ void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiB
 
         // Math: 60,000 ms in a minute / BPM = length of 1 Quarter Note
         float quarterNoteMs = 60000.0f / static_cast<float>(bpm);
-        int rateIndex = syncRateParam ? static_cast<int>(syncRateParam->load()) : 1;
+        int rateIndex = params.syncRate;
 
         float multiplier = 1.0f;
         switch (rateIndex) {
@@ -199,213 +495,434 @@ void PluginProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiB
 
         targetDelayMs = quarterNoteMs * multiplier;
         // Safety clamp so tape doesn't crash if BPM gets crazy
-        targetDelayMs = juce::jlimit(50.0f, 2000.0f, targetDelayMs);
+        targetDelayMs = juce::jlimit(50.0f, maxDelayTimeMs, targetDelayMs);
     }
     else
     {
-        if (delayTimeParam) targetDelayMs = delayTimeParam->load();
+        targetDelayMs = params.delayTimeMs;
     }
 
     // Feed the chosen target to the motor smoother
     smoothedDelayTime.setTargetValue(targetDelayMs);
 
+    // Render profile: the high-quality one reads with the sinc and saturates at 4x, the
+    // realtime one uses the interpolation and anti-aliasing chosen for the session
+    const bool highQuality = wantsHighQuality();
+    highQualityActive.store(highQuality, std::memory_order_relaxed);
+
+    saturator.setMode(params.antiAlias ? TapeSaturator::Mode::antialiased : TapeSaturator::Mode::fast);
+    engine.setSaturationOversampled(highQuality, false);
 
-    if (feedbackParam)    feedback      = feedbackParam->load();
-    if (saturationParam)  saturation    = saturationParam->load();
-    if (wowParam)         wowAmount     = wowParam->load();
-    if (flutterParam)     flutterAmount = flutterParam->load();
-    if (echoMixParam)     echoVol       = echoMixParam->load();
-    if (reverbMixParam)   reverbVol     = reverbMixParam->load();
-    if (masterMixParam)   masterMix     = masterMixParam->load();
-    if (masterGainParam)  masterGainDb  = masterGainParam->load();
-    if (bassParam)        bassDb        = bassParam->load();
-    if (trebleParam)      trebleDb      = trebleParam->load();
+    engine.setInterpolation(getEffectiveInterpolation(params.interpolation, highQuality), false);
 
-    float inputGainDb = 0.0f;
-    if (inputGainParam) inputGainDb = inputGainParam->load();
+    // Under CPU pressure: a shorter reverb and control-rate jitter (the interpolation
+    // cap is in getEffectiveInterpolation)
+    const auto tier = governor.getTier();
+    reverbConvolver.setTailLimit(tier >= QualityGovernor::Tier::shortReverbTail ? juce::roundToInt(governedReverbTailSeconds * sampleRate) : 0);
+    reverbConvolver.setNonRealtime(isNonRealtime());
+    modulator.setControlRateNoise(tier >= QualityGovernor::Tier::controlRateModulation);
 
-    // Apply the gain to the incoming audio
-    buffer.applyGain(juce::Decibels::decibelsToGain(inputGainDb));
+    // Apply the gain to the incoming audio (ramped when the knob moves)
+    const auto inputGain = parameterSnapshot.getInputGain();
+    buffer.applyGainRamp(0, numSamples, inputGain.start, inputGain.end);
 
-    // Measure the loudest sample in this block and store it for the GUI LED
-    inputPeakLevel.store(buffer.getMagnitude(0, buffer.getNumSamples()));
+    // Input peak/RMS for the overload LED and the meters
+    telemetryAccumulator.addInput(buffer.getArrayOfReadPointers(), numChannels, numSamples);
+    tailTracker.addInput(static_cast<float>(buffer.getMagnitude(0, numSamples)), numSamples);
+
+    loadMonitor.startStage(DspLoadMonitor::Stage::eqUpdate);
 
     // --- 2. Update Filter Coefficients ---
-    {
-        float bassGain = juce::Decibels::decibelsToGain(bassDb);
-        float trebleGain = juce::Decibels::decibelsToGain(trebleDb);
+    // Only when bass/treble moved; the snapshot ramps them so the change is click-free
+    if (parameterSnapshot.haveFilterCoefficientsChanged())
+        engine.filters.setCoefficients(parameterSnapshot.getBassCoefficients(), parameterSnapshot.getTrebleCoefficients());
 
-        auto bassCoeffs = juce::IIRCoefficients::makeLowShelf(sampleRate, 150.0, 0.707, bassGain);
-        auto trebleCoeffs = juce::IIRCoefficients::makeHighShelf(sampleRate, 3000.0, 0.707, trebleGain);
+    loadMonitor.startStage(DspLoadMonitor::Stage::tapeLoop);
 
-        if (bassFilters.size() != numChannels) bassFilters.resize(numChannels);
-        if (trebleFilters.size() != numChannels) trebleFilters.resize(numChannels);
+    // --- 3. Prepare Buffers ---
+    // Snapshot the Clean Dry Input (into the preallocated scratch buffer)
+    for (int ch = 0; ch < numChannels; ++ch)
+        engine.dryBuffer.copyFrom(ch, 0, buffer, ch, 0, numSamples);
 
-        for (auto& f : bassFilters) f.setCoefficients(bassCoeffs);
-        for (auto& f : trebleFilters) f.setCoefficients(trebleCoeffs);
-    }
+    // Clear the "Wet Layer" buffer
+    engine.wetAccumulator.clear(0, numSamples);
 
-    // --- 3. Prepare Buffers & Base Mix Gains ---
-    // Calculate the default Master Mix gains
-    float globalDryGain = std::cos(masterMix * juce::MathConstants<float>::halfPi);
-    float globalWetGain = std::sin(masterMix * juce::MathConstants<float>::halfPi);
+    auto& tape = engine.tape;
+    auto& kernel = engine.kernel;
+    const int tapeMask = tape.getMask();
+    const int writeIndex = tape.getWritePosition();
 
-    // Snapshot the Clean Dry Input
-    juce::AudioBuffer<float> dryBuffer;
-    dryBuffer.makeCopyOf(buffer);
+    // --- 4. Motor & Modulation for the whole slice ---
+    // Computed once per sample and shared by every channel and head.
+    SampleType* delaySamples = kernel.getDelayArray();
+    SampleType* modulation = kernel.getModulationArray();
+    const float msToSamples = sampleRate / 1000.0f;
 
-    // Create a "Wet Layer" buffer
-    juce::AudioBuffer<float> wetAccumulator;
-    wetAccumulator.setSize(numChannels, numSamples);
-    wetAccumulator.clear();
+    for (int i = 0; i < numSamples; ++i)
+        delaySamples[i] = static_cast<SampleType>(smoothedDelayTime.getNextValue() * msToSamples);
 
-    if (delayBuffer.getNumSamples() == 0) return;
-    const int bufSize = delayBuffer.getNumSamples();
+    // Wow swings up to 50 samples, flutter 5, plus 30% of that again as jitter
+    modulator.setRates(wowRate, flutterRate);
+    modulator.process(modulation, numSamples, wowAmount * wowDepthSamples, flutterAmount * flutterDepthSamples,
+                      flutterAmount * flutterDepthSamples * jitterDepth);
 
-    // --- 4. Declare Head Timings Array ---
-    std::vector<float> currentHeadTimesSamples(3);
+    // The oversampling filters delay what goes onto tape; reading that much closer keeps
+    // every repeat on time (gliding while the saturation changes rate)
+    if (engine.loopLatency.isSmoothing() || engine.loopLatency.getTargetValue() != SampleType(0))
+        for (int i = 0; i < numSamples; ++i)
+            modulation[i] += engine.loopLatency.getNextValue();
 
-    // === 5. TAPE ECHO PROCESSING LOOP ===
-    for (int i = 0; i < numSamples; ++i)
+    // Head levels with the on/off fades folded in; a head that was just switched keeps
+    // playing until its fade reaches zero
+    std::array<typename TapeReadKernel<SampleType>::HeadGain, TapeReadKernel<SampleType>::numHeads> headGains;
+    for (size_t head = 0; head < headGains.size(); ++head)
     {
-        float currentDelayMs = smoothedDelayTime.getNextValue();
+        const auto fade = parameterSnapshot.getHeadGain(head);
+        headGains[head] = { headLevels[head] * fade.start, headLevels[head] * fade.end };
+    }
+
+    kernel.computeHeadPositions(headGains, writeIndex, tapeMask, numSamples);
+    kernel.resetHeadPeaks();
 
-        currentHeadTimesSamples[0] = (currentDelayMs * 0.364f) * (sampleRate / 1000.0f);
-        currentHeadTimesSamples[1] = (currentDelayMs * 0.691f) * (sampleRate / 1000.0f);
-        currentHeadTimesSamples[2] = (currentDelayMs * 1.000f) * (sampleRate / 1000.0f);
+    // No head playing: the tape only records, and there is no echo to read or filter
+    const bool headsPlaying = kernel.getActiveHeads() != 0;
 
-        wowPhase += 2.0f * juce::MathConstants<float>::pi * wowRate / sampleRate;
-        if (wowPhase >= 2.0f * juce::MathConstants<float>::pi) wowPhase -= 2.0f * juce::MathConstants<float>::pi;
+    // === 5. TAPE ECHO PROCESSING ===
+    // Heads are read a run at a time. A run never reaches tape written inside the same run,
+    // so the feedback path behaves exactly like the per-sample loop even for short delays.
+    const int numTaps = juce::jmax(kernel.getNumTaps(engine.interpolation), kernel.getNumTaps(engine.previousInterpolation));
+    const int runLength = kernel.getSafeRunLength(numSamples, numTaps);
+    SampleType tapeWritePeak = 0;
 
-        flutterPhase += 2.0f * juce::MathConstants<float>::pi * flutterRate / sampleRate;
-        if (flutterPhase >= 2.0f * juce::MathConstants<float>::pi) flutterPhase -= 2.0f * juce::MathConstants<float>::pi;
+    for (int runStart = 0; runStart < numSamples; runStart += runLength)
+    {
+        const int runSamples = juce::jmin(runLength, numSamples - runStart);
 
-        const float wowMod = std::sin(wowPhase) * wowAmount * 50.0f;
-        float flutterMod = std::sin(flutterPhase) * flutterAmount * 5.0f;
-        flutterMod += ((std::rand() / float(RAND_MAX)) - 0.5f) * flutterAmount * 5.0f * 0.3f;
+        const int runWriteIndex = tape.getWritePosition();
 
-        for (int ch = 0; ch < numChannels; ++ch)
+        // Every channel's heads first, so the shelves can filter all channels together
+        SampleType* echoChannels[maxChannels] = {};
+        if (headsPlaying)
         {
-            float* delayData = delayBuffer.getWritePointer(ch % 2);
-            float inputSample = dryBuffer.getReadPointer(ch)[i];
+            auto readHeads = [&](TapeInterpolation::Quality quality, int ch) {
+                return tape.isCompact() ? kernel.readHeads(quality, tape.getCompactReadPointer(ch), runStart, runSamples)
+                                        : kernel.readHeads(quality, tape.getReadPointer(ch), runStart, runSamples);
+            };
 
-            float rawEchoSample = 0.0f;
-            for (int head = 0; head < 3; ++head)
+            for (int ch = 0; ch < numChannels; ++ch)
             {
-                if (!headEnabled[head]) continue;
-
-                float readIndex = static_cast<float>(writeIndex) - currentHeadTimesSamples[head] + wowMod + flutterMod;
-
-                while (readIndex < 0.0f) readIndex += static_cast<float>(bufSize);
-                while (readIndex >= static_cast<float>(bufSize)) readIndex -= static_cast<float>(bufSize);
+                engine.echoBuffer.copyFrom(ch, 0, readHeads(engine.interpolation, ch), runSamples);
+                SampleType* echo = engine.echoBuffer.getWritePointer(ch);
+
+                if (engine.interpolationFadeRemaining > 0)
+                {
+                    // The same positions read the old way, crossfaded towards the new
+                    const SampleType* outgoing = readHeads(engine.previousInterpolation, ch);
+                    const auto step = SampleType(1) / static_cast<SampleType>(interpolationFadeSamples);
+                    const auto first = static_cast<SampleType>(interpolationFadeSamples - engine.interpolationFadeRemaining) * step;
+                    for (int i = 0; i < runSamples; ++i)
+                    {
+                        const auto incoming = juce::jmin(SampleType(1), first + step * static_cast<SampleType>(i));
+                        echo[i] = outgoing[i] + incoming * (echo[i] - outgoing[i]);
+                    }
+                }
+
+                echoChannels[ch] = echo;
+            }
 
-                const int readInt = static_cast<int>(readIndex);
-                const float frac = readIndex - static_cast<float>(readInt);
-                const int indexA = readInt;
-                const int indexB = (indexA + 1) % bufSize;
+            engine.filters.process(echoChannels, numChannels, runSamples);
+        }
 
-                float sample = delayData[indexA] * (1.0f - frac) + delayData[indexB] * frac;
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const SampleType* input = engine.dryBuffer.getReadPointer(ch, runStart);
+            const SampleType* echo = echoChannels[ch];
+            SampleType* wet = engine.wetAccumulator.getWritePointer(ch, runStart);
+            SampleType* feedbackSamples = engine.feedbackScratch.getWritePointer(0);
 
-                rawEchoSample += sample * headLevels[head];
+            if (!headsPlaying)
+            {
+                std::copy(input, input + runSamples, feedbackSamples);
+            }
+            else if (feedback.isRamping() || echoLevel.isRamping())
+            {
+                for (int i = 0; i < runSamples; ++i)
+                {
+                    const auto position = static_cast<float>(runStart + i);
+                    const auto feedbackGain = static_cast<SampleType>(feedback.start + feedbackStep * position);
+                    const auto echoGain = static_cast<SampleType>(echoLevel.start + echoStep * position);
+
+                    feedbackSamples[i] = input[i] + (echo[i] * feedbackGain);
+                    wet[i] += echo[i] * echoGain;
+                }
+            }
+            else
+            {
+                const auto feedbackGain = static_cast<SampleType>(feedback.end);
+                const auto echoGain = static_cast<SampleType>(echoLevel.end);
+
+                for (int i = 0; i < runSamples; ++i)
+                {
+                    feedbackSamples[i] = input[i] + (echo[i] * feedbackGain);
+                    wet[i] += echo[i] * echoGain;
+                }
             }
 
-            rawEchoSample = bassFilters[ch].processSingleSampleRaw(rawEchoSample);
-            rawEchoSample = trebleFilters[ch].processSingleSampleRaw(rawEchoSample);
+            // Saturate the whole run at once, then print it to tape. A decaying echo would
+            // go round the loop until it turned denormal, so tiny values go down as zero.
+            const float drive = 1.0f + 5.0f * saturation;
+            auto saturate = [&](bool oversampled, SampleType* data) {
+                if (oversampled)
+                    engine.oversampledSaturator.process(ch, data, runSamples, drive);
+                else
+                    saturator.process(ch, data, runSamples, drive);
+            };
+
+            if (engine.saturationFadeRemaining > 0)
+            {
+                // Both rates on the same input, crossfaded towards the new one
+                SampleType* outgoing = engine.feedbackScratch.getWritePointer(1);
+                std::copy(feedbackSamples, feedbackSamples + runSamples, outgoing);
+                saturate(engine.saturationOversampled, feedbackSamples);
+                saturate(!engine.saturationOversampled, outgoing);
+
+                const auto step = SampleType(1) / static_cast<SampleType>(saturationFadeSamples);
+                const auto first = static_cast<SampleType>(saturationFadeSamples - engine.saturationFadeRemaining) * step;
+                for (int i = 0; i < runSamples; ++i)
+                {
+                    const auto incoming = juce::jmin(SampleType(1), first + step * static_cast<SampleType>(i));
+                    feedbackSamples[i] = outgoing[i] + incoming * (feedbackSamples[i] - outgoing[i]);
+                }
+            }
+            else
+            {
+                saturate(engine.saturationOversampled, feedbackSamples);
+            }
 
-            float feedbackSample = inputSample + (rawEchoSample * feedback);
-            feedbackSample = std::tanh(feedbackSample * (1.0f + 5.0f * saturation));
-            delayData[writeIndex] = feedbackSample;
+            for (int i = 0; i < runSamples; ++i)
+            {
+                juce::dsp::util::snapToZero(feedbackSamples[i]);
+                tapeWritePeak = juce::jmax(tapeWritePeak, std::abs(feedbackSamples[i]));
+            }
 
-            wetAccumulator.getWritePointer(ch)[i] += rawEchoSample * echoVol;
+            tape.write(ch, runWriteIndex, feedbackSamples, runSamples);
         }
 
-        writeIndex++;
-        if (writeIndex >= bufSize) writeIndex = 0;
+        tape.advance(runSamples);
+        engine.saturationFadeRemaining = juce::jmax(0, engine.saturationFadeRemaining - runSamples);
+        engine.interpolationFadeRemaining = juce::jmax(0, engine.interpolationFadeRemaining - runSamples);
     }
 
+    tailTracker.addTapeWrite(static_cast<float>(tapeWritePeak), numSamples);
+
+    static_assert(TelemetryFrame::numHeads == TapeReadKernel<SampleType>::numHeads);
+    telemetryAccumulator.addHeadLevels(kernel.getHeadPeaks());
+    telemetryAccumulator.setFeedbackGain(feedback.end * (headGains[0].end + headGains[1].end + headGains[2].end));
+
+    loadMonitor.startStage(DspLoadMonitor::Stage::reverb);
+
     // === 6. REVERB PROCESSING ===
-    if (reverbEnabled && reverbVol > 0.0f)
+    const bool reverbActive = reverbEnabled && (reverbLevel.start > 0.0f || reverbLevel.end > 0.0f);
+    if (reverbActive)
     {
-        juce::AudioBuffer<float> reverbInput;
-        reverbInput.makeCopyOf(dryBuffer);
-
+        // The convolver runs in float for both precisions
         for (int ch = 0; ch < numChannels; ++ch)
-            reverbInput.addFrom(ch, 0, wetAccumulator, ch, 0, numSamples);
+        {
+            const SampleType* dry = engine.dryBuffer.getReadPointer(ch);
+            const SampleType* wet = engine.wetAccumulator.getReadPointer(ch);
+            float* send = reverbInput.getWritePointer(ch);
+
+            for (int i = 0; i < numSamples; ++i)
+                send[i] = static_cast<float>(dry[i] + wet[i]);
+        }
 
-        juce::dsp::AudioBlock<float> block(reverbInput);
+        auto block = juce::dsp::AudioBlock<float>(reverbInput)
+                         .getSubsetChannelBlock(0, static_cast<size_t>(numChannels))
+                         .getSubBlock(0, static_cast<size_t>(numSamples));
         juce::dsp::ProcessContextReplacing<float> ctx(block);
         reverbConvolver.process(ctx);
-
-        for (int ch = 0; ch < numChannels; ++ch)
-            wetAccumulator.addFrom(ch, 0, reverbInput, ch, 0, numSamples, reverbVol);
     }
 
-    // === 7. FINAL MIX & OUTPUT (WITH KILL DRY/BYPASS LOGIC) ===
-    bool isBypassed = bypassParam && bypassParam->load() > 0.5f;
-    bool isKillDry  = killDryParam && killDryParam->load() > 0.5f;
+    // An offloaded reverb returns reverbLatency samples late; the rest waits for it, always,
+    // so the latency reported to the host holds whether or not the reverb is heard
+    engine.delayDryAndWet(numChannels, numSamples);
 
-    if (isBypassed)
-    {
-        // Force fully Dry
-        globalDryGain = 1.0f;
-        globalWetGain = 0.0f;
-    }
-    else if (isKillDry)
+    if (reverbActive)
     {
-        // Force fully Wet (Overrides the Master Mix knob entirely)
-        globalDryGain = 0.0f;
-        globalWetGain = 1.0f;
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const float* reverbReturn = reverbInput.getReadPointer(ch);
+            SampleType* wet = engine.wetAccumulator.getWritePointer(ch);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const auto returnGain = static_cast<SampleType>(reverbLevel.start + reverbStep * static_cast<float>(i));
+                wet[i] += returnGain * static_cast<SampleType>(reverbReturn[i]);
+            }
+        }
     }
 
+    // Echo + reverb, before the wet/dry mix; only copied while the editor shows it
+    wetSpectrum.pushSamples(engine.wetAccumulator.getArrayOfReadPointers(), numChannels, numSamples);
+
+    loadMonitor.startStage(DspLoadMonitor::Stage::outputMix);
+
+    // === 7. FINAL MIX & OUTPUT ===
+    // Equal-power mix gains with kill dry / bypass folded in, ramped by the snapshot
+    const auto dryGain = parameterSnapshot.getDryGain();
+    const auto wetGain = parameterSnapshot.getWetGain();
+    const float dryStep = (dryGain.end - dryGain.start) / static_cast<float>(numSamples);
+    const float wetStep = (wetGain.end - wetGain.start) / static_cast<float>(numSamples);
+
     // Blend the final signals to the output buffer
     for (int ch = 0; ch < numChannels; ++ch)
     {
         auto* out = buffer.getWritePointer(ch);
-        const auto* dry = dryBuffer.getReadPointer(ch);
-        const auto* wet = wetAccumulator.getReadPointer(ch);
+        const auto* dry = engine.dryBuffer.getReadPointer(ch);
+        const auto* wet = engine.wetAccumulator.getReadPointer(ch);
 
         for (int i = 0; i < numSamples; ++i)
         {
+            const auto globalDryGain = static_cast<SampleType>(dryGain.start + dryStep * static_cast<float>(i));
+            const auto globalWetGain = static_cast<SampleType>(wetGain.start + wetStep * static_cast<float>(i));
+
             out[i] = (dry[i] * globalDryGain) + (wet[i] * globalWetGain);
-            out[i] = juce::jlimit(-1.0f, 1.0f, out[i]);
+            out[i] = juce::jlimit(SampleType(-1), SampleType(1), out[i]);
         }
     }
 
     // Apply Master Output Gain
-    buffer.applyGain(juce::Decibels::decibelsToGain(masterGainDb));
+    const auto masterGain = parameterSnapshot.getMasterGain();
+    buffer.applyGainRamp(0, numSamples, masterGain.start, masterGain.end);
+
+    telemetryAccumulator.addOutput(buffer.getArrayOfReadPointers(), numChannels, numSamples);
+    telemetryAccumulator.endSlice(numSamples, telemetry);
+
+    loadMonitor.stopStage();
 }
 
 void PluginProcessor::loadImpulseResponse(const juce::File& irFile, bool stereo)
 {
-    // Check if file actually exists before trying to load
-    if (!irFile.existsAsFile()) return;
-
-    // Load the file into the convolution engine
-    // We use Trim::yes to remove silence at the start/end
-    // We use Normalise::yes to ensure it doesn't blow up the volume
-    reverbConvolver.loadImpulseResponse(
-        irFile,
-        stereo ? juce::dsp::Convolution::Stereo::yes : juce::dsp::Convolution::Stereo::no,
-        juce::dsp::Convolution::Trim::yes,
-        0,
-        juce::dsp::Convolution::Normalise::yes
-    );
+    // Read once: the bytes are hashed for the saved state and decoded from memory
+    auto data = std::make_shared<juce::MemoryBlock>();
+    if (!irFile.existsAsFile() || !irFile.loadFileAsData(*data)) return;
+
+    PluginState::ImpulseResponse reference;
+    reference.isCustom = true;
+    reference.stereo = stereo;
+    reference.path = irFile.getFullPathName();
+    reference.hash = PluginState::hashContent(data->getData(), data->getSize());
+    const int generation = setImpulseResponseReference(std::move(reference));
+
+    // Not prepared yet: prepareToPlay picks the file up at the right sample rate
+    if (getSampleRate() <= 0.0) return;
+
+    // Trimmed (silence removed at start/end) and normalised so it doesn't blow up the volume
+    if (auto ir = irCache->getFromMemory(ImpulseResponseCache::getFileIdentity(irFile), std::move(data), getSampleRate(), stereo, true))
+        installImpulseResponse(std::move(ir), generation);
 }
 
 void PluginProcessor::loadDefaultIR()
 {
-    // Reload the binary asset
-    if (BinaryData::DefaultReverbIR_wavSize > 0)
+    const int generation = setImpulseResponseReference({});
+
+    if (getSampleRate() <= 0.0) return;
+
+    installImpulseResponse(irCache->getDefault(getSampleRate(), true), generation);
+}
+
+juce::File PluginProcessor::getCustomIRFile() const
+{
+    const std::lock_guard<std::mutex> scopedLock(irLock);
+    return irReference.isCustom && juce::File::isAbsolutePath(irReference.path) ? juce::File(irReference.path) : juce::File();
+}
+
+void PluginProcessor::setEmbedIRInState(bool shouldEmbed)
+{
+    parameters.state.setProperty("embedIR", shouldEmbed, nullptr);
+}
+
+bool PluginProcessor::isEmbeddingIRInState() const
+{
+    return static_cast<bool>(parameters.state.getProperty("embedIR", false));
+}
+
+int PluginProcessor::setImpulseResponseReference(PluginState::ImpulseResponse reference)
+{
+    const std::lock_guard<std::mutex> scopedLock(irLock);
+    irReference = std::move(reference);
+    return ++irGeneration;
+}
+
+void PluginProcessor::requestImpulseResponse(double sampleRate, bool loadDefaultNow)
+{
+    PluginState::ImpulseResponse reference;
+    int generation = 0;
+    {
+        const std::lock_guard<std::mutex> scopedLock(irLock);
+        reference = irReference;
+        generation = ++irGeneration;
+    }
+
+    if (!reference.isCustom && loadDefaultNow)
+    {
+        installImpulseResponse(irCache->getDefault(sampleRate, true), generation);
+        return;
+    }
+
+    // File I/O, decoding and partitioning happen on the loader thread
+    irLoader.load([this, reference, generation, sampleRate] {
+        auto ir = reference.isCustom ? resolveImpulseResponse(reference, sampleRate) : nullptr;
+        if (ir == nullptr)
+            ir = irCache->getDefault(sampleRate, true);
+
+        installImpulseResponse(std::move(ir), generation);
+    });
+}
+
+ImpulseResponseCache::Ptr PluginProcessor::resolveImpulseResponse(const PluginState::ImpulseResponse& reference, double sampleRate)
+{
+    if (juce::File::isAbsolutePath(reference.path))
     {
-        reverbConvolver.loadImpulseResponse(
-            BinaryData::DefaultReverbIR_wav,
-            static_cast<size_t>(BinaryData::DefaultReverbIR_wavSize),
-            juce::dsp::Convolution::Stereo::yes,
-            juce::dsp::Convolution::Trim::no,
-            static_cast<size_t>(BinaryData::DefaultReverbIR_wavSize),
-            juce::dsp::Convolution::Normalise::yes
-        );
+        const juce::File file(reference.path);
+        auto data = std::make_shared<juce::MemoryBlock>();
+
+        // A changed file is only used when the session has no copy of the original
+        if (file.existsAsFile() && file.loadFileAsData(*data)
+            && (reference.hash == 0 || reference.embeddedData == nullptr
+                || PluginState::hashContent(data->getData(), data->getSize()) == reference.hash))
+        {
+            if (auto ir = irCache->getFromMemory(ImpulseResponseCache::getFileIdentity(file), std::move(data), sampleRate, reference.stereo, true))
+                return ir;
+        }
     }
+
+    if (reference.embeddedData == nullptr)
+        return nullptr;
+
+    // Moved, missing or edited since the session was saved: the copy saved with it
+    const auto& embedded = *reference.embeddedData;
+    const auto identity = "embedded:" + juce::String::toHexString(PluginState::hashContent(embedded.getData(), embedded.getSize()));
+    return irCache->getFromMemory(identity, reference.embeddedData, sampleRate, reference.stereo, true);
+}
+
+void PluginProcessor::installImpulseResponse(ImpulseResponseCache::Ptr ir, int generation)
+{
+    if (ir == nullptr) return;
+
+    // Installs happen one at a time, so the newest choice is always the last one in
+    const std::lock_guard<std::mutex> installGuard(irInstallLock);
+    {
+        const std::lock_guard<std::mutex> scopedLock(irLock);
+        if (generation != irGeneration) return;
+    }
+
+    // Already at the session rate and normalised; the convolver partitions the shared data
+    // here on the calling thread and crossfades to it on the audio thread.
+    reverbConvolver.loadImpulseResponse(ir);
+
+    const std::lock_guard<std::mutex> scopedLock(irLock);
+    currentIR = std::move(ir);
 }
 
 //==============================================================================
@@ -445,7 +962,133 @@ bool PluginProcessor::isMidiEffect() const
 #endif
 }
 
-double PluginProcessor::getTailLengthSeconds() const { return 0.0; }
+double PluginProcessor::getTailLengthSeconds() const
+{
+    auto value = [this](const char* id) {
+        const auto* raw = parameters.getRawParameterValue(id);
+        return raw != nullptr ? raw->load(std::memory_order_relaxed) : 0.0f;
+    };
+
+    if (value("bypass") > 0.5f)
+        return 0.0;
+
+    // Tempo-synced delays are clamped to 2 s; without the play head here, assume the longest
+    const float delayMs = value("syncMode") > 0.5f ? maxDelayTimeMs : value("delayTime");
+
+    float headLevelSum = 0.0f, longestRatio = 0.0f;
+    const char* headIDs[] = { "head1", "head2", "head3" };
+    for (size_t head = 0; head < 3; ++head)
+    {
+        if (value(headIDs[head]) > 0.5f)
+        {
+            headLevelSum += headLevels[head];
+            longestRatio = juce::jmax(longestRatio, TapeReadKernel<float>::headRatios[head]);
+        }
+    }
+
+    const double sampleRate = getSampleRate();
+    const double reverbSeconds = sampleRate > 0.0 && value("reverbMix") > 0.0f
+                                     ? reverbConvolver.getCurrentIRSize() / sampleRate
+                                     : 0.0;
+
+    if (headLevelSum <= 0.0f)
+        return reverbSeconds;
+
+    const double loopGain = TailTracker::getLoopGain(value("feedback"),
+                                                     headLevelSum,
+                                                     1.0f + 5.0f * value("saturation"),
+                                                     juce::Decibels::decibelsToGain(value("bass")),
+                                                     juce::Decibels::decibelsToGain(value("treble")));
+
+    return TailTracker::estimateTailSeconds(delayMs * longestRatio / 1000.0, loopGain, reverbSeconds);
+}
+
+juce::int64 PluginProcessor::getIdleHoldSamples() const noexcept
+{
+    // Longest head (ratio 1), wow/flutter swing and, while it is heard, the reverb IR,
+    // plus the reverb latency and a block of slack
+    const double delayMs = juce::jmax(smoothedDelayTime.getCurrentValue(), smoothedDelayTime.getTargetValue());
+    const double longestRead = delayMs * getSampleRate() / 1000.0 + maxModulationSamples + TapeInterpolation::maxTaps;
+    const bool reverbHeard = reverbEnabled && parameterSnapshot.getReverbLevel().end > 0.0f;
+    return static_cast<juce::int64>(longestRead) + (reverbHeard ? reverbConvolver.getCurrentIRSize() : 0) + reverbLatency + preparedBlockSize;
+}
+
+void PluginProcessor::setReverbOffloaded(bool shouldOffload)
+{
+    parameters.state.setProperty("reverbOffload", shouldOffload, nullptr);
+}
+
+bool PluginProcessor::isReverbOffloaded() const
+{
+    return static_cast<bool>(parameters.state.getProperty("reverbOffload", false));
+}
+
+bool PluginProcessor::wantsHighQuality() const noexcept
+{
+    // From the snapshot: no parameter lookup by name on the audio thread
+    const auto mode = static_cast<RenderMode>(juce::jlimit(0, 2, parameterSnapshot.getValues().renderMode));
+    return mode == RenderMode::automatic ? isNonRealtime() : mode == RenderMode::highQuality;
+}
+
+TapeInterpolation::Quality PluginProcessor::getEffectiveInterpolation(int choice, bool highQuality) const noexcept
+{
+    // The sinc is for the high-quality profile only; the realtime one falls back to 6-point Lagrange
+    auto quality = static_cast<TapeInterpolation::Quality>(juce::jlimit(0, 4, choice));
+
+    if (highQuality)
+        quality = TapeInterpolation::Quality::sinc;
+    else if (quality == TapeInterpolation::Quality::sinc)
+        quality = TapeInterpolation::Quality::lagrange6;
+
+    if (governor.getTier() >= QualityGovernor::Tier::cheapInterpolation)
+        quality = juce::jmin(quality, TapeInterpolation::Quality::hermite);
+
+    return quality;
+}
+
+bool PluginProcessor::isGovernorActive() const noexcept
+{
+    return parameterSnapshot.getValues().adaptiveQuality && !isNonRealtime();
+}
+
+void PluginProcessor::timerCallback()
+{
+    forwardControllerChanges();
+
+    const int tier = static_cast<int>(governor.getTier());
+
+    if (tier != publishedTier)
+    {
+        publishedTier = tier;
+        qualityTierParameter->setValueNotifyingHost(qualityTierParameter->convertTo0to1(static_cast<float>(tier)));
+    }
+}
+
+void PluginProcessor::forwardControllerChanges()
+{
+    midiControllers.forwardToHost(parameterSnapshot);
+}
+
+void PluginProcessor::setMidiControllersEnabled(bool shouldBeEnabled)
+{
+    parameters.state.setProperty("midiControllers", shouldBeEnabled, nullptr);
+    midiControllers.setEnabled(shouldBeEnabled);
+}
+
+bool PluginProcessor::areMidiControllersEnabled() const
+{
+    return static_cast<bool>(parameters.state.getProperty("midiControllers", true));
+}
+
+void PluginProcessor::setCompactTape(bool shouldCompact)
+{
+    parameters.state.setProperty("compactTape", shouldCompact, nullptr);
+}
+
+bool PluginProcessor::isTapeCompact() const
+{
+    return static_cast<bool>(parameters.state.getProperty("compactTape", false));
+}
 int PluginProcessor::getNumPrograms() { return 1; }
 int PluginProcessor::getCurrentProgram() { return 0; }
 void PluginProcessor::setCurrentProgram (int) {}
@@ -454,27 +1097,65 @@ void PluginProcessor::changeProgramName (int, const juce::String&) {}
 
 void PluginProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    // 1. Grab the current state of all your knobs from the APVTS
-    auto state = parameters.copyState();
+    PluginState state;
+    state.parameters = parameters.copyState();
+    {
+        const std::lock_guard<std::mutex> scopedLock(irLock);
+        state.impulseResponse = irReference;
+    }
 
-    // 2. Convert it into an XML object
-    std::unique_ptr<juce::XmlElement> xml (state.createXml());
+    // The embedded copy is read at save time, so instances don't each hold their IR file
+    // in memory. One restored from a session is kept while its file is still missing.
+    auto& ir = state.impulseResponse;
+    const juce::File irFile = ir.isCustom && juce::File::isAbsolutePath(ir.path) ? juce::File(ir.path) : juce::File();
+
+    if (ir.isCustom && isEmbeddingIRInState())
+    {
+        auto data = std::make_shared<juce::MemoryBlock>();
+        if (irFile.existsAsFile() && irFile.loadFileAsData(*data)
+            && PluginState::hashContent(data->getData(), data->getSize()) == ir.hash)
+            ir.embeddedData = std::move(data);
+    }
+    else if (irFile.existsAsFile())
+    {
+        ir.embeddedData = nullptr;
+    }
 
-    // 3. Save it to the memory block the DAW provides
-    copyXmlToBinary (*xml, destData);
+    state.write(destData);
 }
 
 void PluginProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    // 1. Read the saved binary data back into an XML object
+    PluginState state;
+    if (state.read(data, sizeInBytes))
+    {
+        if (state.parameters.hasType(parameters.state.getType()))
+            parameters.replaceState(state.parameters);
+
+        midiControllers.setEnabled(areMidiControllersEnabled());
+
+        // Only queued here: hosts restore hundreds of instances in a row
+        setImpulseResponseReference(std::move(state.impulseResponse));
+        if (getSampleRate() > 0.0)
+            requestImpulseResponse(getSampleRate(), false);
+
+        return;
+    }
+
+    // Sessions saved before the binary format: the APVTS as XML, no IR
     std::unique_ptr<juce::XmlElement> xmlState (getXmlFromBinary (data, sizeInBytes));
 
-    // 2. If the XML is valid, load the values back into your knobs
     if (xmlState.get() != nullptr)
     {
         if (xmlState->hasTagName (parameters.state.getType()))
         {
             parameters.replaceState (juce::ValueTree::fromXml (*xmlState));
+            midiControllers.setEnabled(areMidiControllersEnabled());
+
+            // Those sessions used the stock IR, whatever this instance had loaded before
+            setImpulseResponseReference({});
+            if (getSampleRate() > 0.0)
+                requestImpulseResponse(getSampleRate(), false);
         }
     }
 }
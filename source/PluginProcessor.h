@@ -1,11 +1,32 @@
 #pragma once
 
+#include "DspLoadMonitor.h"
+#include "ImpulseResponseCache.h"
+#include "ImpulseResponseLoader.h"
+#include "MidiControllerMap.h"
+#include "OversampledSaturator.h"
+#include "ParameterSnapshot.h"
+#include "PartitionedConvolver.h"
+#include "PluginState.h"
+#include "QualityGovernor.h"
+#include "ShelfFilterBank.h"
+#include "SpectrumAnalyser.h"
+#include "TailTracker.h"
+#include "TapeModulator.h"
+#include "TapeReadKernel.h"
+#include "TapeRingBuffer.h"
+#include "TapeSaturator.h"
+#include "Telemetry.h"
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <type_traits>
 #include <vector>
 
 
-class PluginProcessor : public juce::AudioProcessor
+class PluginProcessor : public juce::AudioProcessor, private juce::Timer
 {
 public:
     PluginProcessor();
@@ -16,6 +37,8 @@ public:
     void releaseResources() override;
     bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock(juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override;
 
     // UI
     juce::AudioProcessorEditor* createEditor() override;
@@ -39,65 +62,285 @@ public:
     void getStateInformation(juce::MemoryBlock& destData) override;
     void setStateInformation(const void* data, int sizeInBytes) override;
 
+    // Mono, stereo and surround buses up to 7.1, one tape per channel
+    static constexpr int maxChannels = 8;
+
     // === Delay system ===
-    juce::AudioBuffer<float> delayBuffer;
-    int writeIndex = 0;
+    // Tapes allocated by the engine matching the processing precision (one per channel)
+    int getNumTapeChannels() const noexcept;
     float feedbackLevel = 0.4f;
 
     // Parameters (managed via APVTS)
     juce::AudioProcessorValueTreeState parameters;
 
-    std::atomic<float>* delayTimeParam   = nullptr;
-    std::atomic<float>* feedbackParam    = nullptr;
-    std::atomic<float>* saturationParam  = nullptr;
-    std::atomic<float>* wowParam         = nullptr;
-    std::atomic<float>* flutterParam     = nullptr;
-    std::atomic<float>* echoMixParam     = nullptr;
-    std::atomic<float>* masterMixParam   = nullptr;
-    std::atomic<float>* masterGainParam  = nullptr;
-    std::atomic<float>* reverbMixParam   = nullptr;
-    std::atomic<float>* head1Param = nullptr;
-    std::atomic<float>* head2Param = nullptr;
-    std::atomic<float>* head3Param = nullptr;
-    std::atomic<float>* bypassParam = nullptr;
-    std::atomic<float>* killDryParam = nullptr;
-    std::atomic<float>* syncModeParam = nullptr;
-    std::atomic<float>* syncRateParam = nullptr;
-
     juce::SmoothedValue<float> smoothedDelayTime;
 
 
     // === Delay heads ===
     std::vector<float> headTimesMs = { 150.0f, 300.0f, 450.0f };
-    std::vector<float> headLevels  = { 0.6f, 0.4f, 0.3f };
-    std::vector<bool>  headEnabled = { true, true, true };
+    // Playback level of each head; which heads play comes from the head1..3 parameters
+    std::array<float, 3> headLevels = { 0.6f, 0.4f, 0.3f };
 
     // === Wow & flutter ===
-    float wowPhase     = 0.0f;
-    float flutterPhase = 0.0f;
     float wowRate      = 0.2f;   // Hz
     float flutterRate  = 50.0f;  // Hz
 
+    // Start of the flutter jitter sequence, restarted by every prepareToPlay. Every
+    // instance uses TapeModulator::defaultSeed unless told otherwise; renders that have to
+    // match bit for bit (golden files, A/B bounces) can pin it. Not while processing.
+    void setFlutterSeed(std::uint32_t seed) noexcept { modulator.setSeed(seed); }
+
     // === Convolution reverb ===
-    juce::dsp::Convolution reverbConvolver;
-    juce::File currentIRFile;
-    bool useCustomIR = false;
+    PartitionedConvolver reverbConvolver;
     bool reverbEnabled = true;
 
+    // Runs the reverb's FFT stages on the process-wide worker pool instead of the host's
+    // audio thread, for a fixed latency of two blocks (at least 1024 samples) reported to
+    // the host. Saved with the state; takes effect at the next prepareToPlay.
+    void setReverbOffloaded(bool shouldOffload);
+    bool isReverbOffloaded() const;
+
+    // Render profiles. The realtime one is what a session can afford live; the high-quality
+    // one reads the heads with the windowed sinc and saturates the feedback at 4x. Offline
+    // bounces (isNonRealtime) use it automatically; the "renderMode" parameter can force
+    // either. Switching crossfades the saturation and allocates nothing.
+    enum class RenderMode
+    {
+        automatic,
+        realtime,
+        highQuality
+    };
+
+    // The profile the last processed block used
+    bool isRenderingHighQuality() const noexcept { return highQualityActive.load(std::memory_order_relaxed); }
+
+    // Adaptive quality, off by default ("adaptiveQuality" parameter). While this instance
+    // is expensive to run in realtime sessions (QualityGovernor only sees its own time, not
+    // the rest of the host's), the governor gives up the reverb tail past
+    // governedReverbTailSeconds, then the finer head interpolators, then the per-sample
+    // flutter jitter, a tier at a time, and takes them back once there is headroom. Each
+    // change fades in. Offline renders have no deadline and always run at full quality.
+    // The tier is published to the host as the read-only "qualityTier" parameter.
+    QualityGovernor::Tier getQualityTier() const noexcept { return governor.getTier(); }
+    float getGovernorLoad() const noexcept { return governor.getLoad(); }
+    static constexpr double governedReverbTailSeconds = 1.0;
+
+    // Stores the tape as dithered 16-bit samples instead of the host's precision: a half
+    // (float) or a quarter (double) of the memory, at a noise floor near -96 dBFS. Saved
+    // with the state; takes effect at the next prepareToPlay.
+    void setCompactTape(bool shouldCompact);
+    bool isTapeCompact() const;
+
+    // Longest motor delay (tempo sync clamps to it) and the wow/flutter swing in samples:
+    // the most any head reads behind the record head, which sizes the tape
+    static constexpr float maxDelayTimeMs = 2000.0f;
+    static constexpr float wowDepthSamples = 50.0f;
+    static constexpr float flutterDepthSamples = 5.0f;
+    static constexpr float jitterDepth = 0.3f; // of the flutter depth, noise in [-0.5, 0.5)
+    static constexpr int maxModulationSamples = 56;
+
+    // MIDI CC -> parameter map; controller events are applied at their exact sample
+    MidiControllerMap midiControllers;
+
+    // Message thread: tells the host about parameters MIDI controllers moved. The
+    // processor's timer calls it; exposed for hosts without a message loop and for tests.
+    void forwardControllerChanges();
+
+    // The default controller map (CC 20-34) is on unless switched off here. Saved with
+    // the state.
+    void setMidiControllersEnabled(bool shouldBeEnabled);
+    bool areMidiControllersEnabled() const;
+
     // Helper for IR loading
     void loadImpulseResponse(const juce::File& irFile, bool stereo = true);
     void loadDefaultIR();
 
-    // basic eq params
-    std::atomic<float>* bassParam = nullptr;
-    std::atomic<float>* trebleParam = nullptr;
-    std::vector<juce::IIRFilter> bassFilters;
-    std::vector<juce::IIRFilter> trebleFilters;
+    // The custom IR file the session uses; a default File for the stock reverb
+    juce::File getCustomIRFile() const;
+
+    // Saves the custom IR's file contents with the session, so it reopens where the file
+    // is missing or has changed. Stored in the state itself.
+    void setEmbedIRInState(bool shouldEmbed);
+    bool isEmbeddingIRInState() const;
+
+    // A restored session's IR loads in the background; true until it is installed
+    bool isLoadingImpulseResponse() { return irLoader.isLoading(); }
+    bool waitForImpulseResponse(int timeoutMs) { return irLoader.waitUntilIdle(timeoutMs); }
 
-    std::atomic<float>* inputGainParam = nullptr;
-    std::atomic<float> inputPeakLevel { 0.0f };
+    // === Audio -> GUI ===
+    // Meter frames (input/output peak and RMS, head levels, loop gain) every ~5 ms.
+    // Single consumer: the editor drains it on its timer.
+    TelemetryFifo telemetry;
+
+    // FFT of the wet bus, fed only while the editor has it active
+    SpectrumAnalyser wetSpectrum;
+
+    // True while input and tape have been silent long enough that processBlock
+    // skips rendering and outputs silence
+    bool isIdle() const noexcept { return idle.load(std::memory_order_relaxed); }
+
+    // Per-stage DSP time and deadline overruns over the last few hundred blocks.
+    // All zeros unless the build enables CTD201_DSP_STATS; call from one non-audio thread.
+    static constexpr bool hasDspLoadStatistics = DspLoadMonitor::isEnabled;
+    DspLoadMonitor::Statistics getDspLoadStatistics() { return loadMonitor.getStatistics(); }
+    void resetDspLoadStatistics() { loadMonitor.reset(); }
 
 private:
+    // Everything on the echo path that carries audio, in one sample type. The float and
+    // double processBlocks each run their own engine through the same processSlice
+    // template; only the engine matching the host's processing precision is allocated.
+    template <typename SampleType>
+    struct TapeEngine
+    {
+        TapeRingBuffer<SampleType> tape;
+        TapeReadKernel<SampleType> kernel;
+        ShelfFilterBank<SampleType> filters;
+        juce::AudioBuffer<SampleType> dryBuffer;
+        juce::AudioBuffer<SampleType> wetAccumulator;
+        juce::AudioBuffer<SampleType> echoBuffer;
+        juce::AudioBuffer<SampleType> feedbackScratch;
+
+        // Delays dry and wet by the reverb's latency so they line up with its return:
+        // channels [0, n) dry, [n, 2n) wet, one ring of `latency` samples each
+        juce::AudioBuffer<SampleType> latencyLine;
+        int latencyPosition = 0;
+
+        // 4x saturation for the high-quality profile. While the saturation changes rate
+        // both run and are crossfaded; the heads read loopLatency closer so the echoes
+        // keep their timing through the oversampling filters.
+        OversampledSaturator<SampleType> oversampledSaturator;
+        bool saturationOversampled = false;
+        int saturationFadeRemaining = 0;
+        juce::SmoothedValue<SampleType> loopLatency;
+
+        void prepare(int numChannels, int tapeLength, int blockSize, int latency, bool compactTape);
+        void release();
+        void delayDryAndWet(int numChannels, int numSamples) noexcept;
+
+        // Head interpolation. A change reads the heads both ways for a while and
+        // crossfades from the previous one.
+        TapeInterpolation::Quality interpolation = TapeInterpolation::Quality::linear;
+        TapeInterpolation::Quality previousInterpolation = TapeInterpolation::Quality::linear;
+        int interpolationFadeRemaining = 0;
+
+        // Crossfaded over saturationFadeSamples unless `immediately`
+        void setSaturationOversampled(bool shouldOversample, bool immediately) noexcept;
+
+        // Crossfaded over interpolationFadeSamples unless `immediately`. A new choice
+        // during a fade waits for it to finish, except a return to the previous one.
+        void setInterpolation(TapeInterpolation::Quality quality, bool immediately) noexcept;
+    };
+
+    static constexpr int saturationFadeSamples = 512;
+    static constexpr int interpolationFadeSamples = 512;
+
+    // What the "interpolation" choice comes to under the render profile and the quality tier
+    TapeInterpolation::Quality getEffectiveInterpolation(int choice, bool highQuality) const noexcept;
+
+    // Whether the governor runs for this block: switched on and not rendering offline
+    bool isGovernorActive() const noexcept;
+
+    // Message thread: forwards controller changes and publishes the governor's tier to
+    // the "qualityTier" parameter
+    void timerCallback() override;
+
+    // The profile the parameter and the host's realtime state ask for
+    bool wantsHighQuality() const noexcept;
+    std::atomic<bool> highQualityActive { false };
+
+    template <typename SampleType>
+    TapeEngine<SampleType>& getEngine() noexcept
+    {
+        if constexpr (std::is_same_v<SampleType, double>)
+            return doubleEngine;
+        else
+            return floatEngine;
+    }
+
+    // Splits the host block at controller events and EQ steps, then renders slice by slice
+    template <typename SampleType>
+    void processBlockInternal(juce::AudioBuffer<SampleType>& buffer, const juce::MidiBuffer& midiMessages);
+
+    // Renders one slice of at most preparedBlockSize samples
+    template <typename SampleType>
+    void processSlice(juce::AudioBuffer<SampleType>& buffer, TapeEngine<SampleType>& engine);
+
+    // Samples of silence on input and tape before nothing can still be ringing
+    juce::int64 getIdleHoldSamples() const noexcept;
+
+    // Hands a cached IR to the convolver and keeps it alive while in use, unless the IR
+    // choice has changed again since the load began (generation)
+    void installImpulseResponse(ImpulseResponseCache::Ptr ir, int generation);
+
+    // Invalidates loads still in flight for the old choice; returns the new generation
+    int setImpulseResponseReference(PluginState::ImpulseResponse reference);
+
+    // Loads the current IR choice at the given rate. A custom IR always loads on the
+    // loader thread; the stock one too unless loadDefaultNow.
+    void requestImpulseResponse(double sampleRate, bool loadDefaultNow);
+
+    // The file if it still matches the saved hash, else the copy embedded in the session
+    ImpulseResponseCache::Ptr resolveImpulseResponse(const PluginState::ImpulseResponse& reference, double sampleRate);
+
+    // One IR cache per process, shared by every instance
+    juce::SharedResourcePointer<ImpulseResponseCache> irCache;
+
+    // Which IR the session uses (what the state saves) and what is installed; the loader
+    // thread installs too, so both are guarded by irLock
+    mutable std::mutex irLock;
+    std::mutex irInstallLock;
+    PluginState::ImpulseResponse irReference;
+    ImpulseResponseCache::Ptr currentIR;
+    int irGeneration = 0;
+
+    // === Audio thread scratch (sized in prepareToPlay, never resized in processBlock) ===
+    int preparedBlockSize = 0;
+
+    // Reverb latency (and so the plugin's), fixed at prepareToPlay
+    int reverbLatency = 0;
+
+    // Samples rendered since prepareToPlay; while the shelves glide, slices end on
+    // multiples of controlInterval of this
+    static constexpr int controlInterval = 32;
+    juce::int64 renderPosition = 0;
+
+    // Tape, head reader, shelves and scratch, per sample type
+    TapeEngine<float> floatEngine;
+    TapeEngine<double> doubleEngine;
+
+    // The convolver is float-only; the double path converts the send and return here
+    juce::AudioBuffer<float> reverbInput;
+
+    // Parameters read once per slice, with cached and ramped derived values
+    ParameterSnapshot parameterSnapshot;
+
+    // Control-rate wow/flutter LFOs and seeded flutter noise
+    TapeModulator modulator;
+
+    // Feedback-path saturation (fast tanh, or ADAA when anti-aliasing is on), either precision
+    TapeSaturator saturator;
+
+    // Input and tape silence, for the idle skip
+    TailTracker tailTracker;
+    std::atomic<bool> idle { false };
+
+    // Folds slices into telemetry frames
+    TelemetryAccumulator telemetryAccumulator;
+
+    // Block and stage timings for getDspLoadStatistics() (empty when compiled out)
+    DspLoadMonitor loadMonitor;
+
+    // Block times against the deadline, and the quality tier they call for
+    QualityGovernor governor;
+
+    // Message thread: the "qualityTier" parameter, and the tier last sent to it (-1 until
+    // the first timer tick, so that one also overwrites whatever a restored state held)
+    juce::RangedAudioParameter* qualityTierParameter = nullptr;
+    int publishedTier = -1;
+
+    // Declared last: destroyed first, so no load job outlives what it installs into
+    ImpulseResponseLoader irLoader;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginProcessor)
     // We need 2 filters per channel (Bass + Treble).
     // Using a ProcessorChain is the cleanest way in JUCE DSP.
@@ -0,0 +1,112 @@
+#include "PluginState.h"
+
+namespace
+{
+    constexpr int makeTag(char a, char b, char c, char d) noexcept
+    {
+        return static_cast<int>(static_cast<juce::uint32>(a) | static_cast<juce::uint32>(b) << 8
+                                | static_cast<juce::uint32>(c) << 16 | static_cast<juce::uint32>(d) << 24);
+    }
+
+    constexpr int parametersTag = makeTag('P', 'A', 'R', 'M');
+    constexpr int impulseResponseTag = makeTag('I', 'R', 'E', 'F');
+    constexpr int impulseResponseDataTag = makeTag('I', 'R', 'D', 'A');
+
+    void writeSection(juce::MemoryOutputStream& stream, int tag, const juce::MemoryBlock& payload)
+    {
+        stream.writeInt(tag);
+        stream.writeInt64(static_cast<juce::int64>(payload.getSize()));
+        stream.write(payload.getData(), payload.getSize());
+    }
+}
+
+void PluginState::write(juce::MemoryBlock& destData) const
+{
+    juce::MemoryOutputStream stream(destData, false);
+    stream.writeInt(magic);
+    stream.writeInt(currentVersion);
+
+    {
+        juce::MemoryBlock payload;
+        juce::MemoryOutputStream section(payload, false);
+        parameters.writeToStream(section);
+        section.flush();
+        writeSection(stream, parametersTag, payload);
+    }
+
+    {
+        juce::MemoryBlock payload;
+        juce::MemoryOutputStream section(payload, false);
+        section.writeBool(impulseResponse.isCustom);
+        section.writeBool(impulseResponse.stereo);
+        section.writeString(impulseResponse.path);
+        section.writeInt64(impulseResponse.hash);
+        section.flush();
+        writeSection(stream, impulseResponseTag, payload);
+    }
+
+    if (impulseResponse.isCustom && impulseResponse.embeddedData != nullptr)
+        writeSection(stream, impulseResponseDataTag, *impulseResponse.embeddedData);
+
+    stream.flush();
+}
+
+bool PluginState::read(const void* data, int sizeInBytes)
+{
+    if (data == nullptr || sizeInBytes < 8)
+        return false;
+
+    juce::MemoryInputStream stream(data, static_cast<size_t>(sizeInBytes), false);
+    if (stream.readInt() != magic)
+        return false;
+
+    version = stream.readInt();
+    parameters = {};
+    impulseResponse = {};
+
+    while (stream.getNumBytesRemaining() >= 12)
+    {
+        const int tag = stream.readInt();
+        const auto size = stream.readInt64();
+        if (size < 0 || size > stream.getNumBytesRemaining())
+            return false; // truncated
+
+        const auto* payload = static_cast<const char*>(data) + stream.getPosition();
+        juce::MemoryInputStream section(payload, static_cast<size_t>(size), false);
+
+        if (tag == parametersTag)
+        {
+            parameters = juce::ValueTree::readFromStream(section);
+        }
+        else if (tag == impulseResponseTag)
+        {
+            impulseResponse.isCustom = section.readBool();
+            impulseResponse.stereo = section.readBool();
+            impulseResponse.path = section.readString();
+            impulseResponse.hash = section.readInt64();
+        }
+        else if (tag == impulseResponseDataTag)
+        {
+            impulseResponse.embeddedData = std::make_shared<const juce::MemoryBlock>(payload, static_cast<size_t>(size));
+        }
+
+        stream.skipNextBytes(size);
+    }
+
+    // Anything left over is a section header cut short
+    return stream.getNumBytesRemaining() == 0 && parameters.isValid();
+}
+
+juce::int64 PluginState::hashContent(const void* data, size_t size) noexcept
+{
+    auto hash = static_cast<juce::uint64>(0xcbf29ce484222325ull);
+    const auto* bytes = static_cast<const juce::uint8*>(data);
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+
+    return static_cast<juce::int64>(hash);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <juce_data_structures/juce_data_structures.h>
+#include <memory>
+
+// The plugin's saved state, in a compact versioned binary format.
+//
+//   "CTDS"  int32 magic
+//   int32   format version
+//   then sections, each  int32 tag | int64 size | size bytes
+//     'PARM'  the APVTS tree, juce::ValueTree::writeToStream (no XML round trip)
+//     'IREF'  impulse response reference: bool custom, bool stereo, path, int64 content hash
+//     'IRDA'  the custom IR file's bytes, only when embedding is on
+//
+// Readers skip sections they don't know, so later versions can add sections without
+// breaking older builds. Sessions saved before this format hold the APVTS as XML
+// (copyXmlToBinary); read() returns false for those and the processor falls back.
+struct PluginState
+{
+    static constexpr int magic = 0x53445443; // "CTDS" little endian
+    static constexpr int currentVersion = 1;
+
+    struct ImpulseResponse
+    {
+        bool isCustom = false;
+        bool stereo = true;
+        juce::String path;
+        juce::int64 hash = 0; // hashContent() of the file; 0 if unknown
+        std::shared_ptr<const juce::MemoryBlock> embeddedData; // file bytes, or null
+    };
+
+    int version = currentVersion;
+    juce::ValueTree parameters;
+    ImpulseResponse impulseResponse;
+
+    void write(juce::MemoryBlock& destData) const;
+
+    // False if the data is not in this format (e.g. an XML blob from an older session)
+    bool read(const void* data, int sizeInBytes);
+
+    // 64-bit FNV-1a, stable across platforms and builds
+    static juce::int64 hashContent(const void* data, size_t size) noexcept;
+};
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <cmath>
+
+// Steps processing quality down while this instance is expensive to run, and back up
+// once it is cheap again.
+//
+// The processor reports how long its own processBlock took against how long the block
+// lasts in real time. The load is smoothed over a few hundred milliseconds, so a single
+// slow block (a page fault, an IR being swapped) does nothing; only sustained pressure
+// counts. Tiers are cumulative, each cheaper than the one before:
+//
+//   full                   everything as configured
+//   shortReverbTail        the reverb stops convolving past the first second of the IR
+//   cheapInterpolation     and the heads read with at most Hermite interpolation
+//   controlRateModulation  and the flutter jitter is drawn per control interval
+//
+// Hysteresis keeps it from hunting: it steps down after the load has stayed above
+// stepDownLoad for holdDownSeconds, and up only after it has stayed below the much lower
+// stepUpLoad for the longer holdUpSeconds. Every step restarts both counts, so a tier gets
+// a chance to take effect before the next one is considered. The processor fades each
+// change in; the governor only decides.
+//
+// The load only covers this instance. Other plugins and the host share the same deadline
+// but are invisible here, beyond the time they preempt this thread. So the thresholds are not "the audio thread is nearly full" but "this one
+// instance takes a large share of it": a quarter of the block's real-time length to step
+// down, a tenth to step back up. A session that drops out with every instance below
+// that is not helped by the governor.
+//
+// addBlock() runs on the audio thread and never allocates or locks. getTier() and
+// getLoad() can be read from any thread.
+class QualityGovernor
+{
+public:
+    enum class Tier
+    {
+        full,
+        shortReverbTail,
+        cheapInterpolation,
+        controlRateModulation
+    };
+
+    static constexpr int numTiers = 4;
+
+    struct Settings
+    {
+        double stepDownLoad = 0.25;     // share of the block's real-time length
+        double stepUpLoad = 0.1;
+        double smoothingSeconds = 0.2;  // time constant of the load average
+        double holdDownSeconds = 0.5;
+        double holdUpSeconds = 4.0;
+    };
+
+    static const char* getTierName(Tier tier) noexcept
+    {
+        switch (tier)
+        {
+            case Tier::full:                  return "Full";
+            case Tier::shortReverbTail:       return "Short Reverb Tail";
+            case Tier::cheapInterpolation:    return "Cheap Interpolation";
+            case Tier::controlRateModulation: return "Control-Rate Modulation";
+        }
+
+        return "";
+    }
+
+    // Audio stopped (prepareToPlay)
+    void prepare(double newSampleRate) noexcept
+    {
+        sampleRate = newSampleRate > 0.0 ? newSampleRate : 44100.0;
+        reset();
+    }
+
+    // Back to full quality with no load history
+    void reset() noexcept
+    {
+        smoothedLoad = 0.0;
+        aboveFor = 0.0;
+        belowFor = 0.0;
+        tier.store(Tier::full, std::memory_order_relaxed);
+        load.store(0.0f, std::memory_order_relaxed);
+    }
+
+    // Audio stopped
+    void setSettings(const Settings& newSettings) noexcept { settings = newSettings; }
+    const Settings& getSettings() const noexcept { return settings; }
+
+    // Audio thread, once per host block: the time it took and the samples it rendered.
+    // A block rendered with the governor off (enabled false, seconds unused) drops the
+    // history and returns to full quality.
+    void addBlock(double seconds, int numSamples, bool enabled) noexcept
+    {
+        if (!enabled)
+        {
+            reset();
+            return;
+        }
+
+        if (numSamples <= 0) return;
+
+        const double duration = numSamples / sampleRate;
+        const double alpha = 1.0 - std::exp(-duration / settings.smoothingSeconds);
+        smoothedLoad += alpha * (seconds / duration - smoothedLoad);
+        load.store(static_cast<float>(smoothedLoad), std::memory_order_relaxed);
+
+        auto current = static_cast<int>(tier.load(std::memory_order_relaxed));
+
+        aboveFor = smoothedLoad > settings.stepDownLoad ? aboveFor + duration : 0.0;
+        belowFor = smoothedLoad < settings.stepUpLoad ? belowFor + duration : 0.0;
+
+        if (aboveFor >= settings.holdDownSeconds && current < numTiers - 1)
+            ++current;
+        else if (belowFor >= settings.holdUpSeconds && current > 0)
+            --current;
+        else
+            return;
+
+        aboveFor = belowFor = 0.0;
+        tier.store(static_cast<Tier>(current), std::memory_order_relaxed);
+    }
+
+    Tier getTier() const noexcept { return tier.load(std::memory_order_relaxed); }
+
+    // Smoothed block time / block duration
+    float getLoad() const noexcept { return load.load(std::memory_order_relaxed); }
+
+private:
+    Settings settings;
+    double sampleRate = 44100.0;
+
+    // Audio thread
+    double smoothedLoad = 0.0;
+    double aboveFor = 0.0; // seconds the load has been over stepDownLoad
+    double belowFor = 0.0; // seconds it has been under stepUpLoad
+
+    std::atomic<Tier> tier { Tier::full };
+    std::atomic<float> load { 0.0f };
+};
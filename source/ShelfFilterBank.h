@@ -0,0 +1,172 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+
+// Bass + treble shelves on the echo path, for every channel at once.
+//
+// Same maths (transposed direct form II, coefficients normalised by a0) as the
+// juce::SingleThreadedIIRFilter pair it replaces, but with the filter state stored per
+// channel in SIMD-sized groups: with four or more channels each group of four is
+// filtered in one register, sample by sample. Channels that don't fill a group (mono,
+// stereo, the last two of a 5.1 bus) run the scalar version of the same recursion.
+//
+// Templated on the sample type: the double bank keeps its state in double, two channels
+// per SSE register. The coefficients come from juce::IIRCoefficients (float) either way.
+// The state is snapped to zero after every block, as juce::dsp::IIR::Filter does.
+template <typename SampleType>
+class ShelfFilterBank
+{
+public:
+    using Vec = juce::dsp::SIMDRegister<SampleType>;
+
+    static constexpr int maxChannels = 8;
+    static constexpr int laneCount = static_cast<int>(Vec::size());
+    static constexpr int maxGroups = (maxChannels + laneCount - 1) / laneCount;
+
+    void prepare(int numChannelsToUse) noexcept
+    {
+        jassert(numChannelsToUse <= maxChannels);
+        numChannels = juce::jlimit(1, maxChannels, numChannelsToUse);
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        for (auto& stage : stages)
+            for (auto& group : stage.state)
+                group = {};
+    }
+
+    void setCoefficients(const juce::IIRCoefficients& bass, const juce::IIRCoefficients& treble) noexcept
+    {
+        stages[0].setCoefficients(bass);
+        stages[1].setCoefficients(treble);
+    }
+
+    int getNumChannels() const noexcept { return numChannels; }
+
+    // Filters channels[0..numChannelsToProcess) in place; every pointer must hold numSamples samples
+    void process(SampleType* const* channels, int numChannelsToProcess, int numSamples) noexcept
+    {
+        jassert(numChannelsToProcess <= numChannels);
+        const int channelsInUse = juce::jmin(numChannelsToProcess, numChannels);
+        const int vectorChannels = channelsInUse - channelsInUse % laneCount;
+
+        // --- Groups of laneCount channels: one register per sample ---
+        for (int first = 0; first < vectorChannels; first += laneCount)
+        {
+            const int group = first / laneCount;
+            auto& s0 = stages[0].state[static_cast<size_t>(group)];
+            auto& s1 = stages[1].state[static_cast<size_t>(group)];
+
+            Vec v1a = Vec::fromRawArray(s0.v1), v2a = Vec::fromRawArray(s0.v2);
+            Vec v1b = Vec::fromRawArray(s1.v1), v2b = Vec::fromRawArray(s1.v2);
+            const auto& a = stages[0].vector;
+            const auto& b = stages[1].vector;
+
+            alignas(sizeof(Vec)) SampleType lanes[laneCount];
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                for (int lane = 0; lane < laneCount; ++lane)
+                    lanes[lane] = channels[first + lane][i];
+
+                const auto in = Vec::fromRawArray(lanes);
+
+                const auto mid = a[0] * in + v1a;
+                v1a = a[1] * in - a[3] * mid + v2a;
+                v2a = a[2] * in - a[4] * mid;
+
+                const auto out = b[0] * mid + v1b;
+                v1b = b[1] * mid - b[3] * out + v2b;
+                v2b = b[2] * mid - b[4] * out;
+
+                out.copyToRawArray(lanes);
+                for (int lane = 0; lane < laneCount; ++lane)
+                    channels[first + lane][i] = lanes[lane];
+            }
+
+            v1a.copyToRawArray(s0.v1);
+            v2a.copyToRawArray(s0.v2);
+            v1b.copyToRawArray(s1.v1);
+            v2b.copyToRawArray(s1.v2);
+            snapToZero(s0);
+            snapToZero(s1);
+        }
+
+        // --- Leftover channels: scalar ---
+        for (int ch = vectorChannels; ch < channelsInUse; ++ch)
+        {
+            const int group = ch / laneCount;
+            const int lane = ch % laneCount;
+            auto& s0 = stages[0].state[static_cast<size_t>(group)];
+            auto& s1 = stages[1].state[static_cast<size_t>(group)];
+            const auto& a = stages[0].scalar;
+            const auto& b = stages[1].scalar;
+
+            SampleType v1a = s0.v1[lane], v2a = s0.v2[lane];
+            SampleType v1b = s1.v1[lane], v2b = s1.v2[lane];
+            SampleType* data = channels[ch];
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const SampleType in = data[i];
+
+                const SampleType mid = a[0] * in + v1a;
+                v1a = a[1] * in - a[3] * mid + v2a;
+                v2a = a[2] * in - a[4] * mid;
+
+                const SampleType out = b[0] * mid + v1b;
+                v1b = b[1] * mid - b[3] * out + v2b;
+                v2b = b[2] * mid - b[4] * out;
+
+                data[i] = out;
+            }
+
+            s0.v1[lane] = v1a;
+            s0.v2[lane] = v2a;
+            s1.v1[lane] = v1b;
+            s1.v2[lane] = v2b;
+            snapToZero(s0);
+            snapToZero(s1);
+        }
+    }
+
+private:
+    struct GroupState
+    {
+        alignas(sizeof(Vec)) SampleType v1[laneCount] {};
+        alignas(sizeof(Vec)) SampleType v2[laneCount] {};
+    };
+
+    struct Stage
+    {
+        // b0, b1, b2, a1, a2 (a0 already divided out by juce::IIRCoefficients)
+        std::array<SampleType, 5> scalar { 1, 0, 0, 0, 0 };
+        std::array<Vec, 5> vector { Vec::expand(1), Vec::expand(0), Vec::expand(0), Vec::expand(0), Vec::expand(0) };
+        std::array<GroupState, maxGroups> state {};
+
+        void setCoefficients(const juce::IIRCoefficients& c) noexcept
+        {
+            for (size_t k = 0; k < 5; ++k)
+            {
+                scalar[k] = static_cast<SampleType>(c.coefficients[k]);
+                vector[k] = Vec::expand(static_cast<SampleType>(c.coefficients[k]));
+            }
+        }
+    };
+
+    // Called once per block: a decayed state would otherwise keep recirculating as denormals
+    static void snapToZero(GroupState& group) noexcept
+    {
+        for (int lane = 0; lane < laneCount; ++lane)
+        {
+            juce::dsp::util::snapToZero(group.v1[lane]);
+            juce::dsp::util::snapToZero(group.v2[lane]);
+        }
+    }
+
+    std::array<Stage, 2> stages;
+    int numChannels = 1;
+};
@@ -0,0 +1,135 @@
+#include "SpectrumAnalyser.h"
+
+namespace
+{
+    // Bins fall back by this fraction of the distance per hop, and jump up immediately
+    constexpr float releaseCoefficient = 0.3f;
+    constexpr float changeThresholdDb = 0.01f;
+}
+
+SpectrumAnalyser::SpectrumAnalyser()
+    : juce::Thread("CTD201 Spectrum Analyser")
+{
+    fifoData.resize(static_cast<size_t>(fifoSize));
+    timeDomain.resize(static_cast<size_t>(fftSize));
+    fftData.resize(static_cast<size_t>(fftSize * 2));
+
+    // Periodic Hann, scaled so a full-scale sine reads 0 dB
+    window.resize(static_cast<size_t>(fftSize));
+    for (int i = 0; i < fftSize; ++i)
+    {
+        const float hann = 0.5f - 0.5f * std::cos(juce::MathConstants<float>::twoPi * static_cast<float>(i) / static_cast<float>(fftSize));
+        window[static_cast<size_t>(i)] = hann * 4.0f / static_cast<float>(fftSize);
+    }
+
+    smoothed.fill(floorDb);
+    published.fill(floorDb);
+}
+
+SpectrumAnalyser::~SpectrumAnalyser()
+{
+    active.store(false);
+    stopThread(2000);
+}
+
+void SpectrumAnalyser::prepare(double newSampleRate)
+{
+    sampleRate.store(newSampleRate > 0.0 ? newSampleRate : 44100.0, std::memory_order_relaxed);
+    resetRequested.store(true);
+}
+
+void SpectrumAnalyser::setActive(bool shouldBeActive)
+{
+    if (shouldBeActive == isActive())
+        return;
+
+    if (shouldBeActive)
+    {
+        resetRequested.store(true);
+        startThread(juce::Thread::Priority::low);
+        active.store(true);
+    }
+    else
+    {
+        active.store(false);
+        stopThread(2000);
+    }
+}
+
+bool SpectrumAnalyser::getLatestSpectrum(Spectrum& dest, juce::uint32& lastVersion) const
+{
+    const juce::SpinLock::ScopedLockType lock(publishLock);
+    if (publishedVersion == lastVersion)
+        return false;
+
+    dest = published;
+    lastVersion = publishedVersion;
+    return true;
+}
+
+void SpectrumAnalyser::run()
+{
+    while (!threadShouldExit())
+    {
+        if (resetRequested.exchange(false))
+        {
+            fifo.read(fifo.getNumReady());
+            std::fill(timeDomain.begin(), timeDomain.end(), 0.0f);
+            smoothed.fill(floorDb);
+            samplesInWindow = 0;
+        }
+
+        bool didWork = false;
+        while (!threadShouldExit() && analyseNextHop())
+            didWork = true;
+
+        // 2048 samples at 48 kHz is ~43 ms, so a ~30 Hz display never waits long
+        if (!didWork)
+            wait(15);
+    }
+}
+
+bool SpectrumAnalyser::analyseNextHop()
+{
+    if (fifo.getNumReady() < hopSize)
+        return false;
+
+    // Slide the window along by one hop
+    std::copy(timeDomain.begin() + hopSize, timeDomain.end(), timeDomain.begin());
+    {
+        const auto scope = fifo.read(hopSize);
+        auto* tail = timeDomain.data() + fftSize - hopSize;
+        std::copy_n(fifoData.data() + scope.startIndex1, scope.blockSize1, tail);
+        std::copy_n(fifoData.data() + scope.startIndex2, scope.blockSize2, tail + scope.blockSize1);
+    }
+
+    samplesInWindow = juce::jmin(fftSize, samplesInWindow + hopSize);
+    if (samplesInWindow < fftSize)
+        return true;
+
+    for (int i = 0; i < fftSize; ++i)
+        fftData[static_cast<size_t>(i)] = timeDomain[static_cast<size_t>(i)] * window[static_cast<size_t>(i)];
+    std::fill(fftData.begin() + fftSize, fftData.end(), 0.0f);
+
+    fft.performFrequencyOnlyForwardTransform(fftData.data());
+
+    float largestChange = 0.0f;
+    for (int bin = 0; bin < numBins; ++bin)
+    {
+        const float db = juce::Decibels::gainToDecibels(fftData[static_cast<size_t>(bin)], floorDb);
+        auto& current = smoothed[static_cast<size_t>(bin)];
+        const float next = db > current ? db : current + (db - current) * releaseCoefficient;
+
+        largestChange = juce::jmax(largestChange, std::abs(next - current));
+        current = next;
+    }
+
+    if (largestChange > changeThresholdDb)
+    {
+        const juce::SpinLock::ScopedLockType lock(publishLock);
+        published = smoothed;
+        ++publishedVersion;
+    }
+
+    return true;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <atomic>
+#include <vector>
+
+// Spectrum of the wet signal, computed off the audio thread.
+//
+// While active (the editor is open) the audio thread mixes the wet bus down to mono and
+// writes it into a lock-free sample FIFO; nothing else happens on the audio thread, and if
+// the FIFO is full the samples are dropped. A per-instance thread takes 2048-sample Hann
+// windows with 75% overlap, runs the FFT and publishes smoothed dB per bin together with a
+// version number. The version only moves when some bin moved by more than a hundredth of a
+// dB, so a settled or silent signal doesn't make the editor repaint.
+class SpectrumAnalyser : private juce::Thread
+{
+public:
+    static constexpr int fftOrder = 11;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int hopSize = fftSize / 4;
+    static constexpr int numBins = fftSize / 2;
+    static constexpr int fifoSize = 1 << 15;
+    static constexpr float floorDb = -100.0f;
+
+    using Spectrum = std::array<float, numBins>;
+
+    SpectrumAnalyser();
+    ~SpectrumAnalyser() override;
+
+    // Not concurrent with the audio callback; the analysis starts over at the new rate
+    void prepare(double sampleRate);
+
+    // Message thread: starts or stops the analysis thread (and the audio-thread feed)
+    void setActive(bool shouldBeActive);
+    bool isActive() const noexcept { return active.load(std::memory_order_relaxed); }
+
+    // Audio thread: mono sum of channels[0..numChannels). No-op while inactive.
+    template <typename SampleType>
+    void pushSamples(const SampleType* const* channels, int numChannels, int numSamples) noexcept
+    {
+        if (!isActive() || numChannels <= 0)
+            return;
+
+        const auto scale = SampleType(1) / static_cast<SampleType>(numChannels);
+        const auto scope = fifo.write(numSamples);
+        int source = 0;
+
+        // Whatever doesn't fit is dropped; the analyser just sees a gap
+        scope.forEach([&](int index) {
+            SampleType sum = 0;
+            for (int ch = 0; ch < numChannels; ++ch)
+                sum += channels[ch][source];
+
+            fifoData[static_cast<size_t>(index)] = static_cast<float>(sum * scale);
+            ++source;
+        });
+    }
+
+    // Copies the latest spectrum into dest if it is newer than lastVersion (and updates it)
+    bool getLatestSpectrum(Spectrum& dest, juce::uint32& lastVersion) const;
+
+    double getSampleRate() const noexcept { return sampleRate.load(std::memory_order_relaxed); }
+
+private:
+    void run() override;
+    bool analyseNextHop();
+
+    std::atomic<bool> active { false };
+    std::atomic<bool> resetRequested { false };
+    std::atomic<double> sampleRate { 44100.0 };
+
+    // Audio -> analysis thread
+    juce::AbstractFifo fifo { fifoSize };
+    std::vector<float> fifoData;
+
+    // Analysis thread
+    juce::dsp::FFT fft { fftOrder };
+    std::vector<float> window;
+    std::vector<float> timeDomain;
+    std::vector<float> fftData;
+    Spectrum smoothed {};
+    int samplesInWindow = 0;
+
+    // Analysis thread -> GUI
+    mutable juce::SpinLock publishLock;
+    Spectrum published {};
+    juce::uint32 publishedVersion = 0;
+
+    JUCE_DECLARE_NON_COPYABLE(SpectrumAnalyser)
+};
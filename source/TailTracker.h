@@ -0,0 +1,82 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <cmath>
+#include <limits>
+
+// How long the echo and reverb ring on, and whether they have stopped.
+//
+// estimateTailSeconds() is what getTailLengthSeconds() reports: the time for the
+// recirculating echo to fall 120 dB, plus the reverb IR on top. Each trip round the loop
+// takes at most the longest enabled head's delay and scales a small signal by the loop
+// gain (feedback x enabled head levels x saturation drive x any shelf boost). At a loop
+// gain of 1 or more the echo never dies away by itself, so the tail is infinite.
+//
+// On the audio thread the tracker counts how long the input and the signal written to
+// tape have both stayed below -120 dB. Once that is longer than the longest head delay
+// plus the IR, nothing audible can still be in flight and the processor may stop rendering
+// and output silence until the input comes back.
+class TailTracker
+{
+public:
+    static constexpr float silenceThreshold = 1.0e-6f; // -120 dB
+
+    static double getLoopGain(float feedback, float headLevelSum, float drive, float bassGain, float trebleGain) noexcept
+    {
+        return static_cast<double>(feedback) * headLevelSum * drive * juce::jmax(1.0f, bassGain) * juce::jmax(1.0f, trebleGain);
+    }
+
+    static double estimateTailSeconds(double longestDelaySeconds, double loopGain, double reverbSeconds) noexcept
+    {
+        if (loopGain >= 1.0)
+            return std::numeric_limits<double>::infinity();
+
+        // The first echo, then enough trips round the loop to fall by the threshold
+        double trips = 1.0;
+        if (loopGain > 0.0)
+            trips += std::ceil(std::log(static_cast<double>(silenceThreshold)) / std::log(loopGain));
+
+        return longestDelaySeconds * trips + reverbSeconds;
+    }
+
+    void reset() noexcept
+    {
+        silentInputSamples = 0;
+        silentTapeSamples = 0;
+    }
+
+    // Audio thread: peak of the slice's input and of what was written to tape
+    void addInput(float peak, int numSamples) noexcept
+    {
+        silentInputSamples = peak > silenceThreshold ? 0 : silentInputSamples + numSamples;
+    }
+
+    void addTapeWrite(float peak, int numSamples) noexcept
+    {
+        silentTapeSamples = peak > silenceThreshold ? 0 : silentTapeSamples + numSamples;
+    }
+
+    // True once both have been silent for longer than holdSamples (longest read + IR)
+    bool hasDecayed(juce::int64 holdSamples) const noexcept
+    {
+        return silentInputSamples > holdSamples && silentTapeSamples > holdSamples;
+    }
+
+    // True if no sample is above threshold (the idle check on a host block)
+    template <typename SampleType>
+    static bool isSilent(const SampleType* const* channels, int numChannels, int numSamples, float threshold) noexcept
+    {
+        const auto limit = static_cast<SampleType>(threshold);
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < numSamples; ++i)
+                if (std::abs(channels[ch][i]) > limit)
+                    return false;
+
+        return true;
+    }
+
+private:
+    juce::int64 silentInputSamples = 0;
+    juce::int64 silentTapeSamples = 0;
+};
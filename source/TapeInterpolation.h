@@ -0,0 +1,203 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <cmath>
+#include <type_traits>
+#include <utility>
+
+// Interpolation policies for the tape heads (TapeReadKernel::readHeads<Policy>).
+//
+// A head reads between two tape samples, index and index + 1, at a fraction in [0, 1).
+// Each policy looks at numTaps consecutive samples starting numTaps / 2 - 1 before the
+// index and weights them by the fraction:
+//
+//   Linear         2 taps    the original tape read; cheapest, rolls off the top octave
+//   Hermite        4 taps    3rd-order Catmull-Rom spline
+//   Lagrange<4>    4 taps    3rd-order Lagrange polynomial
+//   Lagrange<6>    6 taps    5th-order Lagrange polynomial
+//   WindowedSinc   16 taps   Kaiser-windowed sinc from a 512-phase table, for offline renders
+//
+// The policy is a template argument, so each one is its own inner loop with no per-sample
+// branching. All but the sinc are written once for scalars and SIMDRegisters; the sinc
+// looks its weights up per sample and runs scalar.
+class TapeInterpolation
+{
+public:
+    // Order of the "interpolation" parameter choices
+    enum class Quality
+    {
+        linear,
+        hermite,
+        lagrange4,
+        lagrange6,
+        sinc
+    };
+
+    // Widest policy; TapeRingBuffer needs at least this many guard samples
+    static constexpr int maxTaps = 16;
+
+    // A constant as a scalar or broadcast to every lane of a SIMDRegister
+    template <typename V>
+    static V splat(double value) noexcept
+    {
+        if constexpr (std::is_floating_point_v<V>)
+            return static_cast<V>(value);
+        else
+            return V::expand(static_cast<typename V::ElementType>(value));
+    }
+
+    struct Linear
+    {
+        static constexpr int numTaps = 2;
+        static constexpr bool isVectorised = true;
+
+        template <typename V>
+        static V interpolate(const V* taps, V frac) noexcept
+        {
+            return taps[0] + frac * (taps[1] - taps[0]);
+        }
+    };
+
+    struct Hermite
+    {
+        static constexpr int numTaps = 4;
+        static constexpr bool isVectorised = true;
+
+        template <typename V>
+        static V interpolate(const V* taps, V frac) noexcept
+        {
+            const V c1 = splat<V>(0.5) * (taps[2] - taps[0]);
+            const V c2 = taps[0] - splat<V>(2.5) * taps[1] + splat<V>(2.0) * taps[2] - splat<V>(0.5) * taps[3];
+            const V c3 = splat<V>(0.5) * (taps[3] - taps[0]) + splat<V>(1.5) * (taps[1] - taps[2]);
+            return ((c3 * frac + c2) * frac + c1) * frac + taps[1];
+        }
+    };
+
+    template <int NumTaps>
+    struct Lagrange
+    {
+        static_assert(NumTaps >= 2 && NumTaps % 2 == 0, "Lagrange interpolation needs an even number of taps");
+
+        static constexpr int numTaps = NumTaps;
+        static constexpr bool isVectorised = true;
+
+        // weight k = prod_{j != k} (frac - node j) / (node k - node j). Written as folds
+        // over the tap indices so every loop is unrolled, whatever the optimiser decides.
+        template <typename V>
+        static V interpolate(const V* taps, V frac) noexcept
+        {
+            return interpolate(taps, frac, std::make_integer_sequence<int, numTaps>());
+        }
+
+    private:
+        static constexpr int centre = numTaps / 2 - 1;
+
+        template <typename V, int... k>
+        static V interpolate(const V* taps, V frac, std::integer_sequence<int, k...>) noexcept
+        {
+            const std::array<V, numTaps> distance { (frac - splat<V>(k - centre))... };
+            return (... + (taps[k] * weight<k>(distance, std::make_integer_sequence<int, numTaps>())));
+        }
+
+        template <int k, typename V, int... j>
+        static V weight(const std::array<V, numTaps>& distance, std::integer_sequence<int, j...>) noexcept
+        {
+            return (splat<V>(1.0 / denominator(k)) * ... * (j == k ? splat<V>(1.0) : distance[static_cast<size_t>(j)]));
+        }
+
+        static constexpr double denominator(int k) noexcept
+        {
+            double product = 1.0;
+            for (int j = 0; j < numTaps; ++j)
+                if (j != k)
+                    product *= static_cast<double>(k - j);
+            return product;
+        }
+    };
+
+    struct WindowedSinc
+    {
+        static constexpr int numTaps = maxTaps;
+        static constexpr bool isVectorised = false;
+        static constexpr int numPhases = 512;
+        static constexpr double kaiserBeta = 8.0;
+
+        using Table = std::array<float, (numPhases + 1) * numTaps>;
+
+        // Built on first use; TapeReadKernel::prepare() touches it so that is never the audio thread
+        static const Table& getTable()
+        {
+            static const Table table = makeTable();
+            return table;
+        }
+
+        template <typename SampleType>
+        static SampleType interpolate(const SampleType* taps, SampleType frac) noexcept
+        {
+            static_assert(std::is_floating_point_v<SampleType>, "the sinc looks up weights per sample");
+
+            // Blend the two table phases either side of the fraction
+            const auto position = frac * static_cast<SampleType>(numPhases);
+            const int phase = juce::jlimit(0, numPhases - 1, static_cast<int>(position));
+            const auto blend = position - static_cast<SampleType>(phase);
+
+            const float* lower = getTable().data() + phase * numTaps;
+            const float* upper = lower + numTaps;
+
+            SampleType sum = 0;
+            for (int k = 0; k < numTaps; ++k)
+            {
+                const auto weight = static_cast<SampleType>(lower[k]) + blend * static_cast<SampleType>(upper[k] - lower[k]);
+                sum += taps[k] * weight;
+            }
+
+            return sum;
+        }
+
+    private:
+        // Zeroth-order modified Bessel function, for the Kaiser window
+        static double besselI0(double x) noexcept
+        {
+            double sum = 1.0, term = 1.0;
+            for (int k = 1; k < 32; ++k)
+            {
+                term *= (x * 0.5 / k) * (x * 0.5 / k);
+                sum += term;
+            }
+            return sum;
+        }
+
+        static Table makeTable()
+        {
+            Table table {};
+            const double halfWidth = numTaps / 2;
+            const double windowScale = 1.0 / besselI0(kaiserBeta);
+
+            for (int phase = 0; phase <= numPhases; ++phase)
+            {
+                const double frac = static_cast<double>(phase) / numPhases;
+                std::array<double, numTaps> weights {};
+                double total = 0.0;
+
+                for (int k = 0; k < numTaps; ++k)
+                {
+                    // Distance from tap k to the read position
+                    const double x = static_cast<double>(k - (numTaps / 2 - 1)) - frac;
+                    const double sinc = std::abs(x) < 1.0e-12 ? 1.0 : std::sin(juce::MathConstants<double>::pi * x) / (juce::MathConstants<double>::pi * x);
+                    const double ratio = juce::jlimit(-1.0, 1.0, x / halfWidth);
+                    const double window = besselI0(kaiserBeta * std::sqrt(1.0 - ratio * ratio)) * windowScale;
+
+                    weights[static_cast<size_t>(k)] = sinc * window;
+                    total += weights[static_cast<size_t>(k)];
+                }
+
+                // Normalised per phase so DC passes at exactly unity gain
+                for (int k = 0; k < numTaps; ++k)
+                    table[static_cast<size_t>(phase * numTaps + k)] = static_cast<float>(weights[static_cast<size_t>(k)] / total);
+            }
+
+            return table;
+        }
+    };
+};
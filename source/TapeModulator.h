@@ -0,0 +1,193 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <cmath>
+#include <cstdint>
+
+// Wow & flutter for the tape transport.
+//
+// The two LFOs are recursive quadrature oscillators (a rotating cos/sin pair) that only
+// step once per control interval; in between, the output is linearly interpolated to
+// audio rate. Flutter jitter comes from a per-instance xorshift32 generator instead of
+// std::rand, so there is no shared global state and a render is bit-reproducible.
+//
+// Nothing in process() calls into libm. The control-interval phase carries over between
+// calls, so the output does not depend on how the host splits its blocks.
+//
+// To save time under CPU pressure the jitter can be drawn once per control interval as
+// well, and ramped like the LFOs (setControlRateNoise). That takes the serial xorshift
+// chain out of the per-sample loop, which is then three independent ramps the compiler
+// can vectorise; the jitter loses its top octaves, which the flutter mostly masks.
+class TapeModulator
+{
+public:
+    static constexpr int defaultControlInterval = 32;
+    static constexpr std::uint32_t defaultSeed = 0x2011CAFEu;
+
+    void prepare(double newSampleRate, int newControlInterval = defaultControlInterval)
+    {
+        sampleRate = newSampleRate > 0.0 ? newSampleRate : 44100.0;
+        controlInterval = juce::jmax(1, newControlInterval);
+
+        // Force the rotations to be recomputed for the new rate / interval
+        wow.frequency = -1.0f;
+        flutter.frequency = -1.0f;
+        setRates(wowRate, flutterRate);
+
+        reset();
+    }
+
+    // Back to phase 0 and the start of the noise sequence
+    void reset() noexcept
+    {
+        wow.resetPhase();
+        flutter.resetPhase();
+        samplesUntilTick = 0;
+        noiseState = seed;
+        noise = {};
+    }
+
+    void setSeed(std::uint32_t newSeed) noexcept
+    {
+        seed = newSeed != 0 ? newSeed : defaultSeed; // xorshift must not start at 0
+        noiseState = seed;
+    }
+
+    // Cheap to call every block: the rotations are only recomputed when a rate changes
+    void setRates(float wowHz, float flutterHz) noexcept
+    {
+        wowRate = wowHz;
+        flutterRate = flutterHz;
+        wow.setFrequency(wowHz, sampleRate, controlInterval);
+        flutter.setFrequency(flutterHz, sampleRate, controlInterval);
+    }
+
+    // Takes effect at the next control tick. Switching on ramps from the last sample of
+    // jitter, so the modulation stays continuous.
+    void setControlRateNoise(bool shouldUseControlRate) noexcept { controlRateNoise = shouldUseControlRate; }
+    bool isNoiseAtControlRate() const noexcept { return controlRateNoise; }
+
+    // Fills `modulation` with wow * wowDepth + flutter * flutterDepth + noise * noiseDepth,
+    // where wow and flutter are in [-1, 1] and noise is uniform in [-0.5, 0.5)
+    template <typename SampleType>
+    void process(SampleType* modulation, int numSamples, float wowDepth, float flutterDepth, float noiseDepth) noexcept
+    {
+        int done = 0;
+        while (done < numSamples)
+        {
+            if (samplesUntilTick == 0)
+            {
+                wow.tick(controlInterval);
+                flutter.tick(controlInterval);
+                samplesUntilTick = controlInterval;
+
+                noiseRamping = controlRateNoise;
+                noise.step = noiseRamping ? (nextNoise() - noise.value) / static_cast<float>(controlInterval) : 0.0f;
+            }
+
+            const int n = juce::jmin(samplesUntilTick, numSamples - done);
+            SampleType* out = modulation + done;
+
+            if (noiseRamping)
+            {
+                for (int i = 0; i < n; ++i)
+                {
+                    out[i] = static_cast<SampleType>(wow.value * wowDepth + flutter.value * flutterDepth + noise.value * noiseDepth);
+                    wow.value += wow.step;
+                    flutter.value += flutter.step;
+                    noise.value += noise.step;
+                }
+            }
+            else
+            {
+                for (int i = 0; i < n; ++i)
+                {
+                    noise.value = nextNoise();
+                    out[i] = static_cast<SampleType>(wow.value * wowDepth + flutter.value * flutterDepth + noise.value * noiseDepth);
+                    wow.value += wow.step;
+                    flutter.value += flutter.step;
+                }
+            }
+
+            samplesUntilTick -= n;
+            done += n;
+        }
+    }
+
+private:
+    struct QuadratureOscillator
+    {
+        // cos/sin of the phase, rotated by the per-tick angle
+        double c = 1.0, s = 0.0;
+        double rotationCos = 1.0, rotationSin = 0.0;
+        float frequency = 0.0f;
+
+        // Interpolated audio-rate output
+        float value = 0.0f;
+        float step = 0.0f;
+
+        void resetPhase() noexcept
+        {
+            c = 1.0;
+            s = 0.0;
+            value = 0.0f;
+            step = 0.0f;
+        }
+
+        void setFrequency(float hz, double sampleRate, int interval) noexcept
+        {
+            if (hz == frequency) return;
+            frequency = hz;
+
+            const double angle = juce::MathConstants<double>::twoPi * hz * interval / sampleRate;
+            rotationCos = std::cos(angle);
+            rotationSin = std::sin(angle);
+        }
+
+        // Lands exactly on the previous target, then heads for sin of the next phase
+        void tick(int interval) noexcept
+        {
+            value = static_cast<float>(s);
+
+            const double nextC = c * rotationCos - s * rotationSin;
+            const double nextS = s * rotationCos + c * rotationSin;
+
+            // First-order correction keeps |(c, s)| at 1 without a sqrt
+            const double gain = 1.5 - 0.5 * (nextC * nextC + nextS * nextS);
+            c = nextC * gain;
+            s = nextS * gain;
+
+            step = (static_cast<float>(s) - value) / static_cast<float>(interval);
+        }
+    };
+
+    float nextNoise() noexcept
+    {
+        noiseState ^= noiseState << 13;
+        noiseState ^= noiseState >> 17;
+        noiseState ^= noiseState << 5;
+        return static_cast<float>(noiseState >> 8) * (1.0f / 16777216.0f) - 0.5f;
+    }
+
+    double sampleRate = 44100.0;
+    int controlInterval = defaultControlInterval;
+    int samplesUntilTick = 0;
+
+    float wowRate = 0.0f;
+    float flutterRate = 0.0f;
+    QuadratureOscillator wow;
+    QuadratureOscillator flutter;
+
+    std::uint32_t seed = defaultSeed;
+    std::uint32_t noiseState = defaultSeed;
+
+    // Jitter: the last sample drawn, or while ramping, the value heading for the next draw
+    struct
+    {
+        float value = 0.0f;
+        float step = 0.0f;
+    } noise;
+
+    bool controlRateNoise = false;
+    bool noiseRamping = false; // controlRateNoise as of the last tick
+};
@@ -0,0 +1,314 @@
+#pragma once
+
+#include "TapeInterpolation.h"
+#include "TapeRingBuffer.h"
+#include <juce_dsp/juce_dsp.h>
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <type_traits>
+
+// Block-oriented reader for the three playback heads.
+//
+// Instead of working out every head offset per sample, processBlock first fills
+// the per-sample motor delay and wow/flutter offsets for the whole slice. From those
+// the kernel computes integer read indices, fractions and gains per head
+// (computeHeadPositions), then each channel gathers its taps and interpolates all
+// heads in SIMD registers. How many taps and how they are weighted is the
+// interpolation policy (TapeInterpolation).
+//
+// Both the policy and the set of playing heads are template arguments: every policy has
+// its own reader for each of the 7 non-empty head masks, so the hot loops carry no
+// per-head checks. readHeads() picks one per call. A head that was switched on or off
+// is still in the mask while its gain fades, and with no head in the mask at all the
+// caller skips reading entirely (getActiveHeads() == 0).
+//
+// The feedback write is still sample-accurate: getSafeRunLength() says how many samples
+// can be read ahead before a head would reach tape that has not been written yet.
+//
+// SampleType is the tape's sample type (float or double); positions, fractions and the
+// interpolation all run in it, and the register width follows (4 floats or 2 doubles on SSE).
+// The tape itself may be stored more compactly (TapeRingBuffer::Storage::compact16); the
+// readers are also templated on the stored type and widen each tap while gathering it.
+template <typename SampleType>
+class TapeReadKernel
+{
+public:
+    static constexpr int numHeads = 3;
+    static constexpr std::array<float, numHeads> headRatios = { 0.364f, 0.691f, 1.000f };
+
+    using Vec = juce::dsp::SIMDRegister<SampleType>;
+
+    // Gain of one head across the slice, applied per sample as a linear ramp. A head
+    // at zero on both ends is off.
+    struct HeadGain
+    {
+        float start = 0.0f;
+        float end = 0.0f;
+
+        bool isActive() const noexcept { return start > 0.0f || end > 0.0f; }
+    };
+
+    void prepare(int maxBlockSize)
+    {
+        maxSamples = juce::jmax(1, maxBlockSize);
+
+        // SoA scratch, each channel starts SIMD-aligned
+        scratch = juce::dsp::AudioBlock<SampleType>(scratchMemory, numScratchChannels, static_cast<size_t>(maxSamples));
+        scratch.clear();
+
+        readIndices.allocate(static_cast<size_t>(numHeads * maxSamples), true);
+        minReadDistance = 0.0f;
+        tapeMask = 0;
+        activeHeads = 0;
+
+        TapeInterpolation::WindowedSinc::getTable();
+    }
+
+    // Per-sample motor delay (in samples) and wow/flutter offset, filled by the caller
+    SampleType* getDelayArray() noexcept { return scratch.getChannelPointer(delayChannel); }
+    SampleType* getModulationArray() noexcept { return scratch.getChannelPointer(modulationChannel); }
+
+    // Turns the delay/modulation arrays into masked read index, fraction and gain per
+    // active head. writeIndex is the tape position of sample 0 of the slice, mask comes
+    // from TapeRingBuffer.
+    void computeHeadPositions(const std::array<HeadGain, numHeads>& gains, int writeIndex, int mask, int numSamples) noexcept
+    {
+        jassert(numSamples <= maxSamples);
+        tapeMask = mask;
+        activeHeads = 0;
+
+        const SampleType* delay = getDelayArray();
+        const SampleType* modulation = getModulationArray();
+        auto shortest = static_cast<SampleType>(std::numeric_limits<float>::max());
+
+        for (int head = 0; head < numHeads; ++head)
+        {
+            const auto& gain = gains[static_cast<size_t>(head)];
+            if (!gain.isActive()) continue;
+
+            activeHeads |= 1 << head;
+            headGainPeaks[static_cast<size_t>(head)] = juce::jmax(gain.start, gain.end);
+
+            const auto ratio = static_cast<SampleType>(headRatios[static_cast<size_t>(head)]);
+            int* index = readIndices.get() + head * maxSamples;
+            SampleType* frac = scratch.getChannelPointer(static_cast<size_t>(head));
+            SampleType* gainRamp = scratch.getChannelPointer(firstGainChannel + static_cast<size_t>(head));
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const SampleType distance = delay[i] * ratio - modulation[i];
+                shortest = juce::jmin(shortest, distance);
+
+                // Split the distance instead of forming (writeIndex - distance) as a float:
+                // no wrap branches, and the fraction keeps its precision on long tapes.
+                const int whole = static_cast<int>(distance);
+                const SampleType part = distance - static_cast<SampleType>(whole);
+                const int carry = part > SampleType(0) ? 1 : 0;
+
+                index[i] = (writeIndex + i - whole - carry) & tapeMask;
+                frac[i] = static_cast<SampleType>(carry) - part;
+            }
+
+            // A fade is spread over the slice so it never depends on how runs are cut
+            const auto step = static_cast<SampleType>((gain.end - gain.start) / static_cast<float>(numSamples));
+            for (int i = 0; i < numSamples; ++i)
+                gainRamp[i] = static_cast<SampleType>(gain.start) + step * static_cast<SampleType>(i);
+        }
+
+        minReadDistance = static_cast<float>(shortest);
+    }
+
+    // Bit n set if head n plays in this slice (or is fading); 0 means nothing to read
+    int getActiveHeads() const noexcept { return activeHeads; }
+
+    // Largest run of samples whose reads only touch tape written before the run starts.
+    // A policy with numTaps reads numTaps / 2 samples past the head position, so wider
+    // interpolators give shorter runs. Rounded down to whole SIMD vectors so every run
+    // after the first stays aligned.
+    int getSafeRunLength(int numSamples, int numTaps = TapeInterpolation::Linear::numTaps) const noexcept
+    {
+        const int lookahead = numTaps / 2;
+        if (minReadDistance - static_cast<float>(lookahead) >= static_cast<float>(numSamples)) return numSamples;
+
+        const int safe = static_cast<int>(minReadDistance) - lookahead;
+        if (safe < static_cast<int>(Vec::size())) return juce::jmax(1, safe);
+        return safe - safe % static_cast<int>(Vec::size());
+    }
+
+    static int getNumTaps(TapeInterpolation::Quality quality) noexcept
+    {
+        switch (quality)
+        {
+            case TapeInterpolation::Quality::hermite:   return TapeInterpolation::Hermite::numTaps;
+            case TapeInterpolation::Quality::lagrange4: return TapeInterpolation::Lagrange<4>::numTaps;
+            case TapeInterpolation::Quality::lagrange6: return TapeInterpolation::Lagrange<6>::numTaps;
+            case TapeInterpolation::Quality::sinc:      return TapeInterpolation::WindowedSinc::numTaps;
+            case TapeInterpolation::Quality::linear:
+            default:                                    return TapeInterpolation::Linear::numTaps;
+        }
+    }
+
+    // Picks the policy once per call; everything below it is compiled per policy
+    template <typename TapeSample>
+    const SampleType* readHeads(TapeInterpolation::Quality quality, const TapeSample* tape, int start, int num) noexcept
+    {
+        switch (quality)
+        {
+            case TapeInterpolation::Quality::hermite:   return readHeads<TapeInterpolation::Hermite>(tape, start, num);
+            case TapeInterpolation::Quality::lagrange4: return readHeads<TapeInterpolation::Lagrange<4>>(tape, start, num);
+            case TapeInterpolation::Quality::lagrange6: return readHeads<TapeInterpolation::Lagrange<6>>(tape, start, num);
+            case TapeInterpolation::Quality::sinc:      return readHeads<TapeInterpolation::WindowedSinc>(tape, start, num);
+            case TapeInterpolation::Quality::linear:
+            default:                                    return readHeads<TapeInterpolation::Linear>(tape, start, num);
+        }
+    }
+
+    // Gathers and interpolates every active head for samples [start, start + num) of the
+    // slice. `tape` must come from TapeRingBuffer::getReadPointer (or
+    // getCompactReadPointer) with at least Policy::numTaps guard samples, so no tap ever
+    // needs wrapping. Returns a pointer to the summed echo for that range (silence if no
+    // head is active).
+    template <typename Policy, typename TapeSample>
+    const SampleType* readHeads(const TapeSample* tape, int start, int num) noexcept
+    {
+        switch (activeHeads)
+        {
+            case 1:  return readHeadMask<Policy, 1>(tape, start, num);
+            case 2:  return readHeadMask<Policy, 2>(tape, start, num);
+            case 3:  return readHeadMask<Policy, 3>(tape, start, num);
+            case 4:  return readHeadMask<Policy, 4>(tape, start, num);
+            case 5:  return readHeadMask<Policy, 5>(tape, start, num);
+            case 6:  return readHeadMask<Policy, 6>(tape, start, num);
+            case 7:  return readHeadMask<Policy, 7>(tape, start, num);
+            default: return readHeadMask<Policy, 0>(tape, start, num);
+        }
+    }
+
+    // Loudest sample each head played (times its gain) since the last reset, for metering
+    const std::array<float, numHeads>& getHeadPeaks() const noexcept { return headPeaks; }
+    void resetHeadPeaks() noexcept { headPeaks.fill(0.0f); }
+
+private:
+    template <typename Policy, int headMask, typename TapeSample>
+    const SampleType* readHeadMask(const TapeSample* tape, int start, int num) noexcept
+    {
+        static_assert(headMask >= 0 && headMask < (1 << numHeads));
+
+        SampleType* echo = scratch.getChannelPointer(echoChannel) + start;
+        std::fill(echo, echo + num, SampleType(0));
+
+        if constexpr ((headMask & 1) != 0) readHead<Policy>(0, tape, echo, start, num);
+        if constexpr ((headMask & 2) != 0) readHead<Policy>(1, tape, echo, start, num);
+        if constexpr ((headMask & 4) != 0) readHead<Policy>(2, tape, echo, start, num);
+
+        return echo;
+    }
+
+    // echo[i] += gain[i] * policy(taps, frac[i]) for one head
+    template <typename Policy, typename TapeSample>
+    void readHead(int head, const TapeSample* tape, SampleType* echo, int start, int num) noexcept
+    {
+        static_assert(Policy::numTaps <= TapeInterpolation::maxTaps);
+        constexpr int numTaps = Policy::numTaps;
+        constexpr int tapsBefore = numTaps / 2 - 1; // taps[tapsBefore] is the sample at the index
+
+        const int* index = readIndices.get() + head * maxSamples + start;
+        const SampleType* frac = scratch.getChannelPointer(static_cast<size_t>(head)) + start;
+        const SampleType* gain = scratch.getChannelPointer(firstGainChannel + static_cast<size_t>(head)) + start;
+
+        // Starting tapsBefore early keeps every tap at a non-negative offset from a
+        // masked index, inside the guard
+        SampleType peak = 0;
+
+        if constexpr (!Policy::isVectorised)
+        {
+            // Weights looked up per sample: read the taps straight off a native tape,
+            // through a small widened copy off a compact one
+            for (int i = 0; i < num; ++i)
+            {
+                const TapeSample* tap = tape + ((index[i] - tapsBefore) & tapeMask);
+
+                if constexpr (std::is_same_v<TapeSample, SampleType>)
+                {
+                    peak = juce::jmax(peak, std::abs(tap[tapsBefore]));
+                    echo[i] += gain[i] * Policy::interpolate(tap, frac[i]);
+                }
+                else
+                {
+                    std::array<SampleType, numTaps> tapValues;
+                    for (int k = 0; k < numTaps; ++k)
+                        tapValues[static_cast<size_t>(k)] = Tape::toSample(tap[k]);
+
+                    peak = juce::jmax(peak, std::abs(tapValues[static_cast<size_t>(tapsBefore)]));
+                    echo[i] += gain[i] * Policy::interpolate(tapValues.data(), frac[i]);
+                }
+            }
+        }
+        else
+        {
+            std::array<SampleType*, numTaps> taps;
+            for (int k = 0; k < numTaps; ++k)
+                taps[static_cast<size_t>(k)] = scratch.getChannelPointer(firstTapChannel + static_cast<size_t>(k)) + start;
+
+            // Gather: the one part that has to stay scalar. A compact tape is widened
+            // here, so the interpolation below never sees the stored type.
+            for (int i = 0; i < num; ++i)
+            {
+                const TapeSample* tap = tape + ((index[i] - tapsBefore) & tapeMask);
+                for (int k = 0; k < numTaps; ++k)
+                    taps[static_cast<size_t>(k)][i] = Tape::toSample(tap[k]);
+                peak = juce::jmax(peak, std::abs(taps[static_cast<size_t>(tapsBefore)][i]));
+            }
+
+            // Interpolate and accumulate
+            const bool aligned = (start % static_cast<int>(Vec::size())) == 0;
+            const int vectorEnd = aligned ? num - num % static_cast<int>(Vec::size()) : 0;
+
+            for (int i = 0; i < vectorEnd; i += static_cast<int>(Vec::size()))
+            {
+                std::array<Vec, numTaps> tapVectors;
+                for (int k = 0; k < numTaps; ++k)
+                    tapVectors[static_cast<size_t>(k)] = Vec::fromRawArray(taps[static_cast<size_t>(k)] + i);
+
+                auto out = Vec::fromRawArray(echo + i);
+                out += Vec::fromRawArray(gain + i) * Policy::interpolate(tapVectors.data(), Vec::fromRawArray(frac + i));
+                out.copyToRawArray(echo + i);
+            }
+
+            for (int i = vectorEnd; i < num; ++i)
+            {
+                std::array<SampleType, numTaps> tapValues;
+                for (int k = 0; k < numTaps; ++k)
+                    tapValues[static_cast<size_t>(k)] = taps[static_cast<size_t>(k)][i];
+
+                echo[i] += gain[i] * Policy::interpolate(tapValues.data(), frac[i]);
+            }
+        }
+
+        auto& headPeak = headPeaks[static_cast<size_t>(head)];
+        headPeak = juce::jmax(headPeak, headGainPeaks[static_cast<size_t>(head)] * static_cast<float>(peak));
+    }
+
+    using Tape = TapeRingBuffer<SampleType>;
+
+    // Channels 0..numHeads-1 hold the per-head fractions, then the per-head gains,
+    // then one channel per tap
+    static constexpr size_t firstGainChannel = numHeads;
+    static constexpr size_t firstTapChannel = firstGainChannel + numHeads;
+    static constexpr size_t echoChannel = firstTapChannel + TapeInterpolation::maxTaps;
+    static constexpr size_t delayChannel = echoChannel + 1;
+    static constexpr size_t modulationChannel = echoChannel + 2;
+    static constexpr size_t numScratchChannels = echoChannel + 3;
+
+    int maxSamples = 0;
+    int tapeMask = 0;
+    int activeHeads = 0;
+    float minReadDistance = 0.0f;
+    std::array<float, numHeads> headPeaks {};
+    std::array<float, numHeads> headGainPeaks {};
+
+    juce::HeapBlock<char> scratchMemory;
+    juce::dsp::AudioBlock<SampleType> scratch;
+    juce::HeapBlock<int> readIndices;
+};
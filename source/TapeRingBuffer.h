@@ -0,0 +1,200 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <cstdint>
+
+// Multi-channel circular tape with power-of-two capacity.
+//
+// Indices wrap with a mask instead of % or while loops, and the first guardSamples
+// of every channel are mirrored past the end. A reader can therefore take
+// getReadPointer(ch)[index + k] for any masked index and k < guardSamples without
+// ever wrapping, which keeps interpolation kernels branch-free.
+//
+// All channels live in one contiguous allocation made in prepare().
+//
+// Storage::compact16 keeps the tape as 16-bit integers at full scale +-1 (what the
+// feedback saturator can print), a quarter of a double tape and half of a float one.
+// Writes add TPDF dither from a counter hash, so the quantisation stays uncorrelated
+// noise around -96 dBFS, well under the hiss of the tape being modelled; the write loop
+// has no carried state and vectorises. Readers use getCompactReadPointer() and widen
+// with toSample() as they gather.
+template <typename SampleType>
+class TapeRingBuffer
+{
+public:
+    static constexpr int defaultGuardSamples = 8;
+
+    enum class Storage
+    {
+        native,
+        compact16
+    };
+
+    using CompactSample = std::int16_t;
+    static constexpr SampleType compactFullScale = SampleType(32767);
+
+    static SampleType toSample(SampleType value) noexcept { return value; }
+    static SampleType toSample(CompactSample value) noexcept { return static_cast<SampleType>(value) * (SampleType(1) / compactFullScale); }
+
+    void prepare(int numChannelsToUse, int minimumLength, int guardSamplesToUse = defaultGuardSamples, Storage storageToUse = Storage::native)
+    {
+        jassert(numChannelsToUse > 0 && minimumLength > 0);
+
+        numChannels = numChannelsToUse;
+        capacity = static_cast<int>(juce::nextPowerOfTwo(juce::jmax(minimumLength, guardSamplesToUse)));
+        mask = capacity - 1;
+        guardSamples = guardSamplesToUse;
+        channelStride = capacity + guardSamples;
+        storageType = storageToUse;
+
+        const auto numStored = static_cast<size_t>(numChannels * channelStride);
+        if (storageType == Storage::compact16)
+        {
+            storage.free();
+            compactStorage.allocate(numStored, true);
+        }
+        else
+        {
+            compactStorage.free();
+            storage.allocate(numStored, true);
+        }
+
+        writePosition = 0;
+        ditherCounter = 0;
+    }
+
+    void release()
+    {
+        storage.free();
+        compactStorage.free();
+        numChannels = capacity = guardSamples = channelStride = 0;
+        mask = 0;
+        writePosition = 0;
+    }
+
+    void clear() noexcept
+    {
+        const auto numStored = static_cast<size_t>(numChannels * channelStride);
+        if (storage.get() != nullptr)
+            storage.clear(numStored);
+        if (compactStorage.get() != nullptr)
+            compactStorage.clear(numStored);
+        writePosition = 0;
+    }
+
+    bool isEmpty() const noexcept { return capacity == 0; }
+    bool isCompact() const noexcept { return storageType == Storage::compact16; }
+    int getNumChannels() const noexcept { return numChannels; }
+    int getCapacity() const noexcept { return capacity; }
+    int getMask() const noexcept { return mask; }
+    int getGuardSamples() const noexcept { return guardSamples; }
+
+    // Bytes held for the tape itself
+    size_t getSizeInBytes() const noexcept
+    {
+        return static_cast<size_t>(numChannels * channelStride) * (isCompact() ? sizeof(CompactSample) : sizeof(SampleType));
+    }
+
+    // Record head position (index of the next sample to be written)
+    int getWritePosition() const noexcept { return writePosition; }
+    void advance(int numSamples) noexcept { writePosition = (writePosition + numSamples) & mask; }
+
+    int wrap(int index) const noexcept { return index & mask; }
+
+    // Valid for [0, capacity + guardSamples); native storage only
+    const SampleType* getReadPointer(int channel) const noexcept
+    {
+        jassert(juce::isPositiveAndBelow(channel, numChannels) && !isCompact());
+        return storage.get() + channel * channelStride;
+    }
+
+    // Valid for [0, capacity + guardSamples); compact storage only
+    const CompactSample* getCompactReadPointer(int channel) const noexcept
+    {
+        jassert(juce::isPositiveAndBelow(channel, numChannels) && isCompact());
+        return compactStorage.get() + channel * channelStride;
+    }
+
+    // One sample at a masked index, in either storage
+    SampleType read(int channel, int index) const noexcept
+    {
+        return isCompact() ? toSample(getCompactReadPointer(channel)[index]) : getReadPointer(channel)[index];
+    }
+
+    // Writes one sample at a masked index, keeping the mirrored guard in sync
+    void write(int channel, int index, SampleType value) noexcept
+    {
+        write(channel, index, &value, 1);
+    }
+
+    // Writes `num` samples from a masked index on, wrapping at the end of the tape
+    void write(int channel, int index, const SampleType* source, int num) noexcept
+    {
+        jassert(juce::isPositiveAndBelow(index, capacity) && num <= capacity);
+
+        const int firstPart = juce::jmin(num, capacity - index);
+        writeRange(channel, index, source, firstPart);
+        if (firstPart < num)
+            writeRange(channel, 0, source + firstPart, num - firstPart);
+    }
+
+private:
+    // No wrap inside; the part that lands in [0, guardSamples) is mirrored
+    void writeRange(int channel, int index, const SampleType* source, int num) noexcept
+    {
+        if (isCompact())
+        {
+            CompactSample* data = compactStorage.get() + channel * channelStride;
+            quantise(data + index, source, num);
+            for (int i = index; i < juce::jmin(index + num, guardSamples); ++i)
+                data[i + capacity] = data[i];
+        }
+        else
+        {
+            SampleType* data = storage.get() + channel * channelStride;
+            std::copy(source, source + num, data + index);
+            for (int i = index; i < juce::jmin(index + num, guardSamples); ++i)
+                data[i + capacity] = data[i];
+        }
+    }
+
+    void quantise(CompactSample* destination, const SampleType* source, int num) noexcept
+    {
+        const std::uint32_t counter = ditherCounter;
+        for (int i = 0; i < num; ++i)
+        {
+            // Two 16-bit uniforms from one hash of the sample count; their difference is
+            // triangular over +-1 LSB
+            const auto hash = hashCounter(counter + static_cast<std::uint32_t>(i));
+            const auto dither = static_cast<SampleType>(static_cast<int>(hash & 0xffffu) - static_cast<int>(hash >> 16)) * (SampleType(1) / SampleType(65536));
+
+            auto scaled = source[i] * compactFullScale + dither;
+            scaled = juce::jlimit(-compactFullScale, compactFullScale, scaled);
+            destination[i] = static_cast<CompactSample>(scaled + (scaled >= SampleType(0) ? SampleType(0.5) : SampleType(-0.5)));
+        }
+
+        ditherCounter = counter + static_cast<std::uint32_t>(num);
+    }
+
+    // Integer finaliser (lowbias32): every input bit reaches every output bit
+    static std::uint32_t hashCounter(std::uint32_t x) noexcept
+    {
+        x ^= x >> 16;
+        x *= 0x7feb352du;
+        x ^= x >> 15;
+        x *= 0x846ca68bu;
+        x ^= x >> 16;
+        return x;
+    }
+
+    juce::HeapBlock<SampleType> storage;
+    juce::HeapBlock<CompactSample> compactStorage;
+    Storage storageType = Storage::native;
+    int numChannels = 0;
+    int capacity = 0;
+    int mask = 0;
+    int guardSamples = 0;
+    int channelStride = 0;
+    int writePosition = 0;
+    std::uint32_t ditherCounter = 0;
+};
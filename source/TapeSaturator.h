@@ -0,0 +1,134 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// Saturation for the tape feedback path.
+//
+// Replaces the per-sample std::tanh(x * drive) with a block kernel. Two modes:
+//
+//   fast         [7/6] Pade approximant of tanh, input clamped to +-5, output to +-1.
+//                Max absolute error vs std::tanh is below 1e-4 over the whole real line.
+//                Blocks are clamped with FloatVectorOperations and the rational runs as a
+//                plain arithmetic loop the compiler vectorises (SIMDRegister has no divide).
+//
+//   antialiased  First-order antiderivative anti-aliasing (ADAA):
+//                    y[n] = (F(x[n]) - F(x[n-1])) / (x[n] - x[n-1]),   F(x) = log(cosh(x))
+//                which suppresses the aliasing of hard drive at the cost of a half-sample
+//                delay and one exp/log1p per sample. Stateful, one history value per channel.
+//
+// The block functions are templated on the sample type so the float and double
+// processBlock paths share them; the ADAA history is kept in double for both.
+class TapeSaturator
+{
+public:
+    enum class Mode
+    {
+        fast,
+        antialiased
+    };
+
+    // Largest |x| the approximant is evaluated at: it reaches 1 there
+    static constexpr float clampLevel = 5.0f;
+
+    template <typename SampleType>
+    static SampleType fastTanh(SampleType x) noexcept
+    {
+        const auto limit = static_cast<SampleType>(clampLevel);
+        return juce::jlimit(SampleType(-1), SampleType(1), pade(juce::jlimit(-limit, limit, x)));
+    }
+
+    // log(cosh(x)), written so it neither overflows nor loses precision for large |x|
+    static double tanhAntiderivative(double x) noexcept
+    {
+        const double ax = std::abs(x);
+        return ax + std::log1p(std::exp(-2.0 * ax)) - 0.69314718055994530942;
+    }
+
+    void prepare(int numChannels)
+    {
+        previousInput.assign(static_cast<size_t>(juce::jmax(1, numChannels)), 0.0);
+        previousAntiderivative.assign(previousInput.size(), 0.0);
+    }
+
+    void reset() noexcept
+    {
+        std::fill(previousInput.begin(), previousInput.end(), 0.0);
+        std::fill(previousAntiderivative.begin(), previousAntiderivative.end(), 0.0);
+    }
+
+    void setMode(Mode newMode) noexcept
+    {
+        // Switching into ADAA starts from silence rather than a stale history
+        if (newMode != mode && newMode == Mode::antialiased)
+            reset();
+
+        mode = newMode;
+    }
+
+    Mode getMode() const noexcept { return mode; }
+
+    // Saturates `data` in place: data[i] = tanh(data[i] * drive)
+    template <typename SampleType>
+    void process(int channel, SampleType* data, int numSamples, float drive) noexcept
+    {
+        if (mode == Mode::fast)
+        {
+            processFast(data, numSamples, drive);
+            return;
+        }
+
+        jassert(juce::isPositiveAndBelow(channel, static_cast<int>(previousInput.size())));
+        auto& x1 = previousInput[static_cast<size_t>(channel)];
+        auto& f1 = previousAntiderivative[static_cast<size_t>(channel)];
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const double x = static_cast<double>(data[i]) * drive;
+            const double f = tanhAntiderivative(x);
+            const double dx = x - x1;
+
+            // Nearly equal inputs: the quotient is ill-conditioned, use the midpoint instead
+            data[i] = std::abs(dx) > 1.0e-5
+                          ? static_cast<SampleType>((f - f1) / dx)
+                          : fastTanh(static_cast<SampleType>(0.5 * (x + x1)));
+
+            x1 = x;
+            f1 = f;
+        }
+    }
+
+    template <typename SampleType>
+    static void processFast(SampleType* data, int numSamples, float drive) noexcept
+    {
+        // Same maths as fastTanh, split so each pass vectorises: the clamps through
+        // FloatVectorOperations, the rational as a loop with no comparisons in it
+        const auto limit = static_cast<SampleType>(clampLevel);
+        juce::FloatVectorOperations::multiply(data, static_cast<SampleType>(drive), numSamples);
+        juce::FloatVectorOperations::clip(data, data, -limit, limit, numSamples);
+
+        for (int i = 0; i < numSamples; ++i)
+            data[i] = pade(data[i]);
+
+        juce::FloatVectorOperations::clip(data, data, SampleType(-1), SampleType(1), numSamples);
+    }
+
+private:
+    // [7/6] Pade approximant of tanh, accurate on [-clampLevel, clampLevel]
+    template <typename SampleType>
+    static SampleType pade(SampleType x) noexcept
+    {
+        const SampleType x2 = x * x;
+        const SampleType numerator = x * (SampleType(135135) + x2 * (SampleType(17325) + x2 * (SampleType(378) + x2)));
+        const SampleType denominator = SampleType(135135) + x2 * (SampleType(62370) + x2 * (SampleType(3150) + SampleType(28) * x2));
+        return numerator / denominator;
+    }
+
+    Mode mode = Mode::fast;
+
+    // Per channel, in double: F(x[n]) - F(x[n-1]) cancels badly in float
+    std::vector<double> previousInput;
+    std::vector<double> previousAntiderivative;
+};
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <cmath>
+
+// Meter data for the editor, decimated to one frame per few milliseconds of audio.
+//
+// The audio thread folds every slice into a TelemetryAccumulator and pushes a finished
+// frame into a TelemetryFifo. The FIFO is single-producer/single-consumer and never blocks:
+// if the editor is closed or falls behind, new frames are dropped, never waited on. The
+// editor drains it on its timer, so a transient that lands between two timer ticks still
+// shows up as the peak of one of the frames.
+struct TelemetryFrame
+{
+    static constexpr int numHeads = 3;
+
+    float inputPeak = 0.0f;  // after input gain, all channels
+    float inputRms = 0.0f;
+    float outputPeak = 0.0f; // after master gain
+    float outputRms = 0.0f;
+
+    // Peak playback of each head (times its level); zero while the head is off
+    std::array<float, numHeads> headLevels {};
+
+    // Small-signal echo round trip: feedback x sum of the enabled head levels.
+    // At or above 1 the loop self-oscillates (saturation then holds it).
+    float feedbackGain = 0.0f;
+
+    int numSamples = 0;
+};
+
+class TelemetryFifo
+{
+public:
+    static constexpr int capacity = 1024;
+
+    // Audio thread. Returns false (and drops the frame) when the FIFO is full.
+    bool push(const TelemetryFrame& frame) noexcept
+    {
+        const auto scope = fifo.write(1);
+        if (scope.blockSize1 == 0)
+        {
+            numDropped.store(numDropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        frames[static_cast<size_t>(scope.startIndex1)] = frame;
+        return true;
+    }
+
+    // Consumer thread. Calls fn(const TelemetryFrame&) for every queued frame, oldest first.
+    template <typename Fn>
+    int popAll(Fn&& fn)
+    {
+        const auto scope = fifo.read(fifo.getNumReady());
+        scope.forEach([&](int index) { fn(frames[static_cast<size_t>(index)]); });
+        return scope.blockSize1 + scope.blockSize2;
+    }
+
+    int getNumReady() const noexcept { return fifo.getNumReady(); }
+    juce::uint64 getNumDropped() const noexcept { return numDropped.load(std::memory_order_relaxed); }
+
+private:
+    juce::AbstractFifo fifo { capacity };
+    std::array<TelemetryFrame, capacity> frames {};
+    std::atomic<juce::uint64> numDropped { 0 };
+};
+
+// Audio-thread side: merges slices until a frame's worth of samples is in
+class TelemetryAccumulator
+{
+public:
+    static constexpr double frameSeconds = 0.005;
+
+    void prepare(double sampleRate) noexcept
+    {
+        frameLength = juce::jmax(1, static_cast<int>(sampleRate * frameSeconds));
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        frame = {};
+        inputSquares = outputSquares = 0.0;
+        inputValues = outputValues = 0;
+    }
+
+    template <typename SampleType>
+    void addInput(const SampleType* const* channels, int numChannels, int numSamples) noexcept
+    {
+        measure(channels, numChannels, numSamples, frame.inputPeak, inputSquares);
+        inputValues += numChannels * numSamples;
+    }
+
+    template <typename SampleType>
+    void addOutput(const SampleType* const* channels, int numChannels, int numSamples) noexcept
+    {
+        measure(channels, numChannels, numSamples, frame.outputPeak, outputSquares);
+        outputValues += numChannels * numSamples;
+    }
+
+    void addHeadLevels(const std::array<float, TelemetryFrame::numHeads>& levels) noexcept
+    {
+        for (size_t head = 0; head < levels.size(); ++head)
+            frame.headLevels[head] = juce::jmax(frame.headLevels[head], levels[head]);
+    }
+
+    void setFeedbackGain(float gain) noexcept { frame.feedbackGain = gain; }
+
+    // Closes a slice; once the frame is long enough it goes to the FIFO and a new one starts
+    void endSlice(int numSamples, TelemetryFifo& fifo) noexcept
+    {
+        frame.numSamples += numSamples;
+        if (frame.numSamples < frameLength)
+            return;
+
+        frame.inputRms = inputValues > 0 ? static_cast<float>(std::sqrt(inputSquares / inputValues)) : 0.0f;
+        frame.outputRms = outputValues > 0 ? static_cast<float>(std::sqrt(outputSquares / outputValues)) : 0.0f;
+        fifo.push(frame);
+
+        const float feedbackGain = frame.feedbackGain;
+        reset();
+        frame.feedbackGain = feedbackGain;
+    }
+
+    int getFrameLength() const noexcept { return frameLength; }
+
+private:
+    template <typename SampleType>
+    static void measure(const SampleType* const* channels, int numChannels, int numSamples, float& peak, double& squares) noexcept
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const SampleType* data = channels[ch];
+            SampleType channelPeak = 0, channelSquares = 0;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                channelPeak = juce::jmax(channelPeak, std::abs(data[i]));
+                channelSquares += data[i] * data[i];
+            }
+
+            peak = juce::jmax(peak, static_cast<float>(channelPeak));
+            squares += static_cast<double>(channelSquares);
+        }
+    }
+
+    int frameLength = 240;
+    TelemetryFrame frame;
+    double inputSquares = 0.0, outputSquares = 0.0;
+    int inputValues = 0, outputValues = 0;
+};
@@ -0,0 +1,189 @@
+#pragma once
+
+#include "SpectrumAnalyser.h"
+#include "Telemetry.h"
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <array>
+
+// Rolling trace of what each playback head puts out, one column per telemetry frame
+// (~2 s across the component). Frames are pushed in by the editor timer; refresh() only
+// repaints when a frame with signal arrived or old signal is still scrolling out, so an
+// idle or silent plugin leaves the scope alone.
+class TapeScope : public juce::Component, public juce::SettableTooltipClient
+{
+public:
+    static constexpr int historySize = 400;
+    static constexpr float floorDb = -60.0f;
+
+    void addFrame(const TelemetryFrame& frame)
+    {
+        auto& slot = history[static_cast<size_t>(writeIndex)];
+        const bool audible = isAudible(frame.headLevels);
+
+        if (audible || audibleFrames > 0)
+            dirty = true;
+
+        audibleFrames += (audible ? 1 : 0) - (isAudible(slot) ? 1 : 0);
+        slot = frame.headLevels;
+        writeIndex = (writeIndex + 1) % historySize;
+
+        // The loop gain readout only changes in steps of 0.01
+        const float gain = std::round(frame.feedbackGain * 100.0f) / 100.0f;
+        if (gain != feedbackGain)
+        {
+            feedbackGain = gain;
+            dirty = true;
+        }
+    }
+
+    // Called after a batch of frames; repaints at most once, and only if needed
+    void refresh()
+    {
+        if (!dirty) return;
+        dirty = false;
+        repaint();
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        auto bounds = getLocalBounds().toFloat();
+        g.setColour(juce::Colour(0xff101810));
+        g.fillRoundedRectangle(bounds, 4.0f);
+
+        auto traces = bounds.reduced(4.0f);
+        const auto footer = traces.removeFromBottom(14.0f);
+        const float laneHeight = traces.getHeight() / static_cast<float>(TelemetryFrame::numHeads);
+        const float columnWidth = traces.getWidth() / static_cast<float>(historySize);
+
+        static const std::array<juce::Colour, TelemetryFrame::numHeads> colours {
+            juce::Colour(0xff7cfc8a), juce::Colour(0xfffce77c), juce::Colour(0xfffc9a7c)
+        };
+
+        for (int head = 0; head < TelemetryFrame::numHeads; ++head)
+        {
+            const auto lane = traces.withY(traces.getY() + laneHeight * static_cast<float>(head)).withHeight(laneHeight);
+            const float centre = lane.getCentreY();
+
+            g.setColour(juce::Colours::white.withAlpha(0.1f));
+            g.drawHorizontalLine(juce::roundToInt(centre), lane.getX(), lane.getRight());
+
+            // Mirrored envelope, oldest frame on the left
+            juce::Path envelope;
+            envelope.startNewSubPath(lane.getX(), centre);
+            for (int i = 0; i < historySize; ++i)
+            {
+                const auto& levels = history[static_cast<size_t>((writeIndex + i) % historySize)];
+                const float height = toHeight(levels[static_cast<size_t>(head)]) * lane.getHeight() * 0.45f;
+                envelope.lineTo(lane.getX() + columnWidth * static_cast<float>(i), centre - height);
+            }
+            for (int i = historySize - 1; i >= 0; --i)
+            {
+                const auto& levels = history[static_cast<size_t>((writeIndex + i) % historySize)];
+                const float height = toHeight(levels[static_cast<size_t>(head)]) * lane.getHeight() * 0.45f;
+                envelope.lineTo(lane.getX() + columnWidth * static_cast<float>(i), centre + height);
+            }
+            envelope.closeSubPath();
+
+            g.setColour(colours[static_cast<size_t>(head)].withAlpha(0.8f));
+            g.fillPath(envelope);
+        }
+
+        // Loop gain at or above 1 means the echoes build up on their own
+        g.setFont(11.0f);
+        g.setColour(feedbackGain >= 1.0f ? juce::Colours::red : juce::Colours::lightgrey);
+        g.drawText("Loop gain " + juce::String(feedbackGain, 2), footer, juce::Justification::centredRight, false);
+        g.setColour(juce::Colours::lightgrey);
+        g.drawText("Heads 1-3", footer, juce::Justification::centredLeft, false);
+    }
+
+private:
+    using Levels = std::array<float, TelemetryFrame::numHeads>;
+
+    static bool isAudible(const Levels& levels) noexcept
+    {
+        for (auto level : levels)
+            if (level > 1.0e-3f) return true;
+        return false;
+    }
+
+    // 0..1 over floorDb..0 dB
+    static float toHeight(float level) noexcept
+    {
+        const float db = juce::Decibels::gainToDecibels(level, floorDb);
+        return juce::jlimit(0.0f, 1.0f, 1.0f - db / floorDb);
+    }
+
+    std::array<Levels, historySize> history {};
+    int writeIndex = 0;
+    int audibleFrames = 0;
+    float feedbackGain = 0.0f;
+    bool dirty = true;
+};
+
+// Wet-signal spectrum, log frequency from 20 Hz to 20 kHz. refresh() pulls the analyser's
+// latest result and repaints only when it published a new one.
+class SpectrumView : public juce::Component, public juce::SettableTooltipClient
+{
+public:
+    static constexpr float minDb = -90.0f;
+    static constexpr float minFrequency = 20.0f;
+    static constexpr float maxFrequency = 20000.0f;
+
+    SpectrumView() { spectrum.fill(SpectrumAnalyser::floorDb); }
+
+    void refresh(const SpectrumAnalyser& analyser)
+    {
+        if (analyser.getLatestSpectrum(spectrum, version))
+        {
+            sampleRate = analyser.getSampleRate();
+            repaint();
+        }
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        auto bounds = getLocalBounds().toFloat();
+        g.setColour(juce::Colour(0xff101810));
+        g.fillRoundedRectangle(bounds, 4.0f);
+
+        auto plot = bounds.reduced(4.0f);
+        const float binWidth = static_cast<float>(sampleRate) / static_cast<float>(SpectrumAnalyser::fftSize);
+        const float logSpan = std::log(maxFrequency / minFrequency);
+
+        juce::Path curve;
+        bool started = false;
+
+        for (int bin = 1; bin < SpectrumAnalyser::numBins; ++bin)
+        {
+            const float frequency = binWidth * static_cast<float>(bin);
+            if (frequency < minFrequency) continue;
+            if (frequency > maxFrequency) break;
+
+            const float x = plot.getX() + plot.getWidth() * std::log(frequency / minFrequency) / logSpan;
+            const float level = juce::jlimit(0.0f, 1.0f, 1.0f - spectrum[static_cast<size_t>(bin)] / minDb);
+            const float y = plot.getBottom() - plot.getHeight() * level;
+
+            if (!started)
+            {
+                curve.startNewSubPath(x, y);
+                started = true;
+            }
+            else
+            {
+                curve.lineTo(x, y);
+            }
+        }
+
+        g.setColour(juce::Colour(0xff7cfc8a));
+        g.strokePath(curve, juce::PathStrokeType(1.2f));
+
+        g.setFont(11.0f);
+        g.setColour(juce::Colours::lightgrey);
+        g.drawText("Wet", plot.removeFromTop(14.0f), juce::Justification::centredLeft, false);
+    }
+
+private:
+    SpectrumAnalyser::Spectrum spectrum {};
+    juce::uint32 version = 0;
+    double sampleRate = 44100.0;
+};
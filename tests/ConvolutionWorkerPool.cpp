@@ -0,0 +1,95 @@
+#include <ConvolutionWorkerPool.h>
+#include <catch2/catch_test_macros.hpp>
+#include <thread>
+
+namespace
+{
+    struct CountingClient : ConvolutionWorkerPool::Client
+    {
+        bool runBackgroundWork() override
+        {
+            const int previous = insideRun.fetch_add(1);
+            overlapped = overlapped || previous != 0;
+            runs.fetch_add(1);
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+            insideRun.fetch_sub(1);
+            return true;
+        }
+
+        std::atomic<int> runs { 0 };
+        std::atomic<int> insideRun { 0 };
+        std::atomic<bool> overlapped { false };
+    };
+
+    template <typename Condition>
+    bool waitFor(Condition condition)
+    {
+        for (int i = 0; i < 2000 && !condition(); ++i)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        return condition();
+    }
+}
+
+TEST_CASE ("Convolution worker pool", "[reverb]")
+{
+    juce::SharedResourcePointer<ConvolutionWorkerPool> pool;
+    REQUIRE(pool->getNumWorkers() >= 1);
+
+    SECTION ("a notified client runs on a worker")
+    {
+        CountingClient client;
+        const int slot = pool->add(&client);
+        REQUIRE(slot >= 0);
+
+        pool->notify(slot);
+        CHECK(waitFor([&] { return client.runs.load() >= 1; }));
+
+        pool->remove(slot);
+    }
+
+    SECTION ("a client never runs on two workers at once")
+    {
+        CountingClient client;
+        const int slot = pool->add(&client);
+
+        for (int i = 0; i < 200; ++i)
+        {
+            pool->notify(slot);
+            std::this_thread::sleep_for(std::chrono::microseconds(20));
+        }
+
+        CHECK(waitFor([&] { return client.runs.load() >= 2; }));
+        pool->remove(slot);
+        CHECK_FALSE(client.overlapped.load());
+    }
+
+    SECTION ("after remove the client is not called again")
+    {
+        CountingClient client;
+        const int slot = pool->add(&client);
+        pool->notify(slot);
+        pool->remove(slot);
+
+        CHECK(client.insideRun.load() == 0);
+        const int runs = client.runs.load();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        CHECK(client.runs.load() == runs);
+    }
+
+    SECTION ("clients share the pool")
+    {
+        std::array<CountingClient, 6> clients;
+        std::array<int, 6> slots {};
+        for (size_t i = 0; i < clients.size(); ++i)
+            slots[i] = pool->add(&clients[i]);
+
+        for (auto slot : slots)
+            pool->notify(slot);
+
+        for (auto& client : clients)
+            CHECK(waitFor([&] { return client.runs.load() >= 1; }));
+
+        for (auto slot : slots)
+            pool->remove(slot);
+    }
+}
@@ -0,0 +1,129 @@
+#include <PluginProcessor.h>
+#include <ShelfFilterBank.h>
+#include <TapeSaturator.h>
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+
+namespace
+{
+    // Renders an impulse through a fresh plugin at the given precision, channel 0 only
+    template <typename SampleType>
+    std::vector<SampleType> renderImpulse(juce::AudioProcessor::ProcessingPrecision precision, int numBlocks)
+    {
+        PluginProcessor plugin;
+        if (auto* reverbMix = plugin.parameters.getParameter("reverbMix"))
+            reverbMix->setValueNotifyingHost(0.0f);
+
+        plugin.setProcessingPrecision(precision);
+        plugin.setRateAndBufferSizeDetails(48000.0, 128);
+        plugin.prepareToPlay(48000.0, 128);
+
+        juce::AudioBuffer<SampleType> buffer(2, 128);
+        juce::MidiBuffer midi;
+        std::vector<SampleType> output;
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            buffer.clear();
+            if (block == 0)
+                buffer.setSample(0, 0, SampleType(0.5));
+
+            plugin.processBlock(buffer, midi);
+            output.insert(output.end(), buffer.getReadPointer(0), buffer.getReadPointer(0) + 128);
+        }
+
+        return output;
+    }
+}
+
+TEST_CASE ("Double precision processing", "[precision]")
+{
+    PluginProcessor plugin;
+    CHECK(plugin.supportsDoublePrecisionProcessing());
+
+    // ~1 s, enough for the first few echoes at the default delay
+    constexpr int numBlocks = 375;
+    const auto single = renderImpulse<float>(juce::AudioProcessor::singlePrecision, numBlocks);
+    const auto twice = renderImpulse<double>(juce::AudioProcessor::doublePrecision, numBlocks);
+    REQUIRE(single.size() == twice.size());
+
+    double maxDifference = 0.0, energy = 0.0;
+    for (size_t i = 0; i < single.size(); ++i)
+    {
+        maxDifference = juce::jmax(maxDifference, std::abs(twice[i] - static_cast<double>(single[i])));
+        energy += twice[i] * twice[i];
+    }
+
+    // Same algorithm, so the two only differ by float rounding
+    CHECK(energy > 0.0);
+    CHECK(maxDifference < 1.0e-3);
+}
+
+TEST_CASE ("Tape DSP blocks run in double", "[precision]")
+{
+    SECTION ("shelves match the float bank")
+    {
+        const auto bass = juce::IIRCoefficients::makeLowShelf(48000.0, 250.0, 1.0, 2.0f);
+        const auto treble = juce::IIRCoefficients::makeHighShelf(48000.0, 3000.0, 1.0, 0.5f);
+
+        ShelfFilterBank<float> floatBank;
+        ShelfFilterBank<double> doubleBank;
+        floatBank.prepare(3);
+        doubleBank.prepare(3);
+        floatBank.setCoefficients(bass, treble);
+        doubleBank.setCoefficients(bass, treble);
+
+        juce::AudioBuffer<float> floats(3, 500);
+        juce::AudioBuffer<double> doubles(3, 500);
+        juce::Random random(7);
+        for (int ch = 0; ch < 3; ++ch)
+            for (int i = 0; i < 500; ++i)
+            {
+                const float x = random.nextFloat() - 0.5f;
+                floats.setSample(ch, i, x);
+                doubles.setSample(ch, i, x);
+            }
+
+        floatBank.process(floats.getArrayOfWritePointers(), 3, 500);
+        doubleBank.process(doubles.getArrayOfWritePointers(), 3, 500);
+
+        double maxError = 0.0;
+        for (int ch = 0; ch < 3; ++ch)
+            for (int i = 0; i < 500; ++i)
+                maxError = juce::jmax(maxError, std::abs(doubles.getSample(ch, i) - static_cast<double>(floats.getSample(ch, i))));
+
+        CHECK(maxError < 1.0e-5);
+    }
+
+    SECTION ("saturation matches the float path")
+    {
+        for (auto mode : { TapeSaturator::Mode::fast, TapeSaturator::Mode::antialiased })
+        {
+            TapeSaturator floatSaturator, doubleSaturator;
+            floatSaturator.prepare(1);
+            doubleSaturator.prepare(1);
+            floatSaturator.setMode(mode);
+            doubleSaturator.setMode(mode);
+
+            std::vector<float> floats(256);
+            std::vector<double> doubles(256);
+            for (size_t i = 0; i < floats.size(); ++i)
+            {
+                floats[i] = 1.5f * std::sin(0.05f * static_cast<float>(i));
+                doubles[i] = floats[i];
+            }
+
+            floatSaturator.process(0, floats.data(), 256, 3.0f);
+            doubleSaturator.process(0, doubles.data(), 256, 3.0f);
+
+            double maxError = 0.0;
+            for (size_t i = 0; i < floats.size(); ++i)
+            {
+                CHECK(std::abs(doubles[i]) <= 1.0);
+                maxError = juce::jmax(maxError, std::abs(doubles[i] - static_cast<double>(floats[i])));
+            }
+
+            CHECK(maxError < 1.0e-3);
+        }
+    }
+}
@@ -0,0 +1,86 @@
+#include <DspLoadMonitor.h>
+#include <catch2/catch_test_macros.hpp>
+
+namespace
+{
+    using Stage = DspLoadMonitor::Stage;
+
+    // One block split over two stages; sleeping makes it miss its deadline
+    void runBlock(DspLoadMonitor& monitor, int numSamples, int sleepMs)
+    {
+        monitor.beginBlock(numSamples);
+        monitor.startStage(Stage::input);
+        monitor.startStage(Stage::tapeLoop);
+        if (sleepMs > 0)
+            juce::Thread::sleep(sleepMs);
+        monitor.stopStage();
+        monitor.endBlock();
+    }
+}
+
+TEST_CASE ("DSP load monitor", "[dspload]")
+{
+    DspLoadMonitor monitor;
+    monitor.prepare(48000.0);
+
+    if (!DspLoadMonitor::isEnabled)
+    {
+        // Compiled out: nothing is measured and nothing is reported
+        runBlock(monitor, 64, 0);
+        const auto stats = monitor.getStatistics();
+        CHECK(stats.numBlocks == 0);
+        CHECK(stats.windowSize == 0);
+        return;
+    }
+
+    SECTION ("no blocks, no statistics")
+    {
+        const auto stats = monitor.getStatistics();
+        CHECK(stats.numBlocks == 0);
+        CHECK(stats.windowSize == 0);
+        CHECK(stats.meanLoad == 0.0);
+    }
+
+    SECTION ("overruns are counted against the block duration")
+    {
+        // 8192 samples is ~170 ms of budget, 64 samples ~1.3 ms
+        for (int i = 0; i < 10; ++i)
+            runBlock(monitor, 8192, 0);
+
+        runBlock(monitor, 64, 5);
+        runBlock(monitor, 64, 5);
+
+        const auto stats = monitor.getStatistics();
+        CHECK(stats.numBlocks == 12);
+        CHECK(stats.numOverruns == 2);
+        CHECK(stats.windowSize == 12);
+        CHECK(stats.peakLoad > 1.0);
+
+        CHECK(stats.total.min <= stats.total.mean);
+        CHECK(stats.total.mean <= stats.total.max);
+        CHECK(stats.total.p99 <= stats.total.max);
+        CHECK(stats.total.max >= 0.005);
+
+        // The sleep is booked to the stage it happened in
+        CHECK(stats[Stage::tapeLoop].max >= 0.005);
+        CHECK(stats[Stage::reverb].max == 0.0);
+        CHECK(stats[Stage::tapeLoop].max <= stats.total.max);
+
+        monitor.reset();
+        const auto cleared = monitor.getStatistics();
+        CHECK(cleared.numBlocks == 0);
+        CHECK(cleared.numOverruns == 0);
+        CHECK(cleared.windowSize == 0);
+    }
+
+    SECTION ("the window keeps only recent blocks and drops what the reader missed")
+    {
+        for (int i = 0; i < DspLoadMonitor::fifoSize + 100; ++i)
+            runBlock(monitor, 8192, 0);
+
+        const auto stats = monitor.getStatistics();
+        CHECK(stats.numBlocks == static_cast<juce::uint64>(DspLoadMonitor::fifoSize + 100));
+        CHECK(stats.windowSize == DspLoadMonitor::historySize);
+        CHECK(stats.numOverruns == 0);
+    }
+}
@@ -0,0 +1,164 @@
+#include <PluginProcessor.h>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+
+// Deterministic renders of fixed signals through the whole plugin.
+//
+// Each signal is rendered with a reference block size, then with other block sizes, fixed
+// and varying, and must match the reference render: slicing, ramps, the modulator and the
+// convolver may not depend on how the host cuts its buffers. Bypassed, the plugin must
+// null against its input.
+namespace
+{
+    enum class Signal
+    {
+        impulse,
+        sweep,
+        noiseBurst
+    };
+
+    constexpr double renderSeconds = 1.5;
+    constexpr int referenceBlockSize = 512;
+    constexpr std::uint32_t flutterSeed = 201;
+
+    const char* getName(Signal signal)
+    {
+        switch (signal)
+        {
+            case Signal::impulse:    return "impulse";
+            case Signal::sweep:      return "sweep";
+            case Signal::noiseBurst: return "noise_burst";
+        }
+
+        return "";
+    }
+
+    // Stereo input followed by silence, so the echoes and the reverb ring out inside the render
+    juce::AudioBuffer<float> makeInput(Signal signal, double sampleRate)
+    {
+        const int numSamples = static_cast<int>(renderSeconds * sampleRate);
+        juce::AudioBuffer<float> input(2, numSamples);
+        input.clear();
+
+        if (signal == Signal::impulse)
+        {
+            input.setSample(0, 0, 0.5f);
+            input.setSample(1, 0, 0.5f);
+        }
+        else if (signal == Signal::sweep)
+        {
+            // Exponential sine sweep over 0.5 s, 20 Hz to just below Nyquist
+            const int length = static_cast<int>(0.5 * sampleRate);
+            const double start = 20.0, end = juce::jmin(20000.0, 0.45 * sampleRate);
+            const double rate = std::log(end / start);
+            const double duration = length / sampleRate;
+
+            for (int i = 0; i < length; ++i)
+            {
+                const double t = i / sampleRate;
+                const double phase = juce::MathConstants<double>::twoPi * start * duration / rate * (std::exp(t * rate / duration) - 1.0);
+                const auto sample = static_cast<float>(0.4 * std::sin(phase));
+                input.setSample(0, i, sample);
+                input.setSample(1, i, -sample);
+            }
+        }
+        else
+        {
+            // 100 ms of white noise, different on each side
+            juce::Random random(12345);
+            for (int i = 0; i < static_cast<int>(0.1 * sampleRate); ++i)
+                for (int ch = 0; ch < 2; ++ch)
+                    input.setSample(ch, i, 0.5f * (random.nextFloat() - 0.5f));
+        }
+
+        return input;
+    }
+
+    // Renders in place through a fresh plugin with default parameters. blockSize is what
+    // prepareToPlay is told; with varyBlockSizes the host then sends anything up to it.
+    juce::AudioBuffer<float> render(const juce::AudioBuffer<float>& input, double sampleRate, int blockSize, bool varyBlockSizes = false)
+    {
+        PluginProcessor plugin;
+        plugin.setFlutterSeed(flutterSeed);
+
+        // Rendered offline, so the reverb waits for late worker jobs instead of dropping
+        // them, but with the realtime profile sessions play with
+        plugin.setNonRealtime(true);
+        auto* renderMode = plugin.parameters.getParameter("renderMode");
+        renderMode->setValueNotifyingHost(renderMode->convertTo0to1(static_cast<float>(PluginProcessor::RenderMode::realtime)));
+
+        plugin.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        plugin.prepareToPlay(sampleRate, blockSize);
+        REQUIRE(plugin.waitForImpulseResponse(10000));
+
+        juce::AudioBuffer<float> output(input);
+        juce::MidiBuffer midi;
+        juce::Random blockSizes(99);
+
+        for (int start = 0; start < output.getNumSamples();)
+        {
+            int num = varyBlockSizes ? 1 + blockSizes.nextInt(blockSize) : blockSize;
+            num = juce::jmin(num, output.getNumSamples() - start);
+
+            juce::AudioBuffer<float> block(output.getArrayOfWritePointers(), 2, start, num);
+            plugin.processBlock(block, midi);
+            start += num;
+        }
+
+        plugin.releaseResources();
+        return output;
+    }
+
+    float maxDifference(const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& b)
+    {
+        REQUIRE(a.getNumChannels() == b.getNumChannels());
+        REQUIRE(a.getNumSamples() == b.getNumSamples());
+
+        float difference = 0.0f;
+        for (int ch = 0; ch < a.getNumChannels(); ++ch)
+            for (int i = 0; i < a.getNumSamples(); ++i)
+                difference = juce::jmax(difference, std::abs(a.getSample(ch, i) - b.getSample(ch, i)));
+
+        return difference;
+    }
+}
+
+TEST_CASE ("Renders do not depend on the block size", "[golden]")
+{
+    constexpr double sampleRate = 48000.0;
+
+    for (const auto signal : { Signal::impulse, Signal::sweep, Signal::noiseBurst })
+    {
+        const auto input = makeInput(signal, sampleRate);
+        const auto reference = render(input, sampleRate, referenceBlockSize);
+
+        for (const int blockSize : { 16, 113, 2048 })
+        {
+            INFO(getName(signal) << ", " << blockSize << "-sample blocks");
+            CHECK(maxDifference(render(input, sampleRate, blockSize), reference) < 1.0e-4f);
+        }
+
+        INFO(getName(signal) << ", varying blocks");
+        CHECK(maxDifference(render(input, sampleRate, referenceBlockSize, true), reference) < 1.0e-4f);
+    }
+}
+
+TEST_CASE ("Bypass nulls against the input", "[golden]")
+{
+    const auto input = makeInput(Signal::noiseBurst, 48000.0);
+
+    PluginProcessor plugin;
+    plugin.parameters.getParameter("bypass")->setValueNotifyingHost(1.0f);
+    plugin.setRateAndBufferSizeDetails(48000.0, referenceBlockSize);
+    plugin.prepareToPlay(48000.0, referenceBlockSize);
+
+    juce::AudioBuffer<float> output(input);
+    juce::MidiBuffer midi;
+    for (int start = 0; start < output.getNumSamples(); start += referenceBlockSize)
+    {
+        juce::AudioBuffer<float> block(output.getArrayOfWritePointers(), 2, start, juce::jmin(referenceBlockSize, output.getNumSamples() - start));
+        plugin.processBlock(block, midi);
+    }
+
+    CHECK(maxDifference(output, input) < 1.0e-6f);
+}
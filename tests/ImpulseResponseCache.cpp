@@ -0,0 +1,72 @@
+#include <ImpulseResponseCache.h>
+#include <PluginProcessor.h>
+#include <catch2/catch_test_macros.hpp>
+#include <array>
+#include <thread>
+
+TEST_CASE ("Impulse response cache", "[reverb]")
+{
+    juce::SharedResourcePointer<ImpulseResponseCache> cache;
+
+    SECTION ("the same IR, rate and channel mode is decoded once")
+    {
+        auto first = cache->getDefault(48000.0, true);
+        auto second = cache->getDefault(48000.0, true);
+
+        REQUIRE(first != nullptr);
+        CHECK(first.get() == second.get());
+        CHECK(first->sampleRate == 48000.0);
+        CHECK(first->buffer.getNumSamples() > 0);
+    }
+
+    SECTION ("lookups at the same time share one decode")
+    {
+        // Two rates at once as well, which decode side by side
+        std::array<ImpulseResponseCache::Ptr, 8> results;
+        std::array<std::thread, 8> threads;
+        for (size_t i = 0; i < threads.size(); ++i)
+            threads[i] = std::thread([&, i] { results[i] = cache->getDefault(i % 2 == 0 ? 88200.0 : 32000.0, true); });
+        for (auto& thread : threads)
+            thread.join();
+
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            REQUIRE(results[i] != nullptr);
+            CHECK(results[i].get() == results[i % 2].get());
+        }
+        CHECK(results[0].get() != results[1].get());
+        CHECK(cache->getNumEntries() == 2);
+    }
+
+    SECTION ("different sample rates get their own resampled copy")
+    {
+        auto at48k = cache->getDefault(48000.0, true);
+        auto at96k = cache->getDefault(96000.0, true);
+
+        CHECK(at48k.get() != at96k.get());
+        CHECK(std::abs(at96k->buffer.getNumSamples() - 2 * at48k->buffer.getNumSamples()) <= 2);
+    }
+
+    SECTION ("entries are released with their last user")
+    {
+        {
+            auto held = cache->getDefault(44100.0, false);
+            CHECK(cache->getNumEntries() >= 1);
+        }
+        CHECK(cache->getNumEntries() == 0);
+    }
+
+    SECTION ("instances share one entry")
+    {
+        PluginProcessor a, b;
+        a.prepareToPlay(48000.0, 256);
+        b.prepareToPlay(48000.0, 256);
+
+        CHECK(cache->getNumEntries() == 1);
+    }
+
+    SECTION ("unreadable files return nothing")
+    {
+        CHECK(cache->getFromFile(juce::File(), 48000.0, true, true) == nullptr);
+    }
+}
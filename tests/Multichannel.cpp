@@ -0,0 +1,141 @@
+#include <PluginProcessor.h>
+#include <ShelfFilterBank.h>
+#include <catch2/catch_test_macros.hpp>
+
+namespace
+{
+    bool prepareWithLayout(PluginProcessor& plugin, const juce::AudioChannelSet& channels)
+    {
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add(channels);
+        layout.outputBuses.add(channels);
+
+        if (!plugin.setBusesLayout(layout))
+            return false;
+
+        plugin.setRateAndBufferSizeDetails(48000.0, 64);
+        plugin.prepareToPlay(48000.0, 64);
+        return true;
+    }
+}
+
+TEST_CASE ("Supported bus layouts", "[multichannel]")
+{
+    PluginProcessor plugin;
+
+    auto supports = [&](const juce::AudioChannelSet& in, const juce::AudioChannelSet& out) {
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add(in);
+        layout.outputBuses.add(out);
+        return plugin.checkBusesLayoutSupported(layout);
+    };
+
+    CHECK(supports(juce::AudioChannelSet::mono(), juce::AudioChannelSet::mono()));
+    CHECK(supports(juce::AudioChannelSet::stereo(), juce::AudioChannelSet::stereo()));
+    CHECK(supports(juce::AudioChannelSet::create5point1(), juce::AudioChannelSet::create5point1()));
+    CHECK(supports(juce::AudioChannelSet::create7point1(), juce::AudioChannelSet::create7point1()));
+
+    CHECK_FALSE(supports(juce::AudioChannelSet::stereo(), juce::AudioChannelSet::mono()));
+    CHECK_FALSE(supports(juce::AudioChannelSet::discreteChannels(10), juce::AudioChannelSet::discreteChannels(10)));
+}
+
+TEST_CASE ("One tape per channel", "[multichannel]")
+{
+    PluginProcessor plugin;
+
+    SECTION ("mono allocates a single tape")
+    {
+        REQUIRE(prepareWithLayout(plugin, juce::AudioChannelSet::mono()));
+        CHECK(plugin.getNumTapeChannels() == 1);
+    }
+
+    SECTION ("7.1 gets eight")
+    {
+        REQUIRE(prepareWithLayout(plugin, juce::AudioChannelSet::create7point1()));
+        CHECK(plugin.getNumTapeChannels() == 8);
+    }
+}
+
+TEST_CASE ("Surround channels echo independently", "[multichannel]")
+{
+    PluginProcessor plugin;
+    if (auto* reverbMix = plugin.parameters.getParameter("reverbMix"))
+        reverbMix->setValueNotifyingHost(0.0f);
+
+    REQUIRE(prepareWithLayout(plugin, juce::AudioChannelSet::create7point1()));
+
+    constexpr int impulseChannel = 5;
+    juce::AudioBuffer<float> buffer(8, 64);
+    juce::MidiBuffer midi;
+
+    std::array<float, 8> energy {};
+    for (int block = 0; block < 400; ++block)
+    {
+        buffer.clear();
+        if (block == 0)
+            buffer.setSample(impulseChannel, 0, 1.0f);
+
+        plugin.processBlock(buffer, midi);
+
+        // Skip the dry impulse itself
+        if (block == 0) continue;
+
+        for (int ch = 0; ch < 8; ++ch)
+            for (int i = 0; i < 64; ++i)
+                energy[static_cast<size_t>(ch)] += buffer.getSample(ch, i) * buffer.getSample(ch, i);
+    }
+
+    for (int ch = 0; ch < 8; ++ch)
+    {
+        if (ch == impulseChannel)
+            CHECK(energy[static_cast<size_t>(ch)] > 0.0f);
+        else
+            CHECK(energy[static_cast<size_t>(ch)] == 0.0f);
+    }
+}
+
+TEST_CASE ("Shelf filter bank matches per-channel IIR filters", "[multichannel]")
+{
+    constexpr int numChannels = 7; // one full SIMD group plus scalar leftovers
+    constexpr int numSamples = 1000;
+
+    const auto bass = juce::IIRCoefficients::makeLowShelf(48000.0, 150.0, 0.707, juce::Decibels::decibelsToGain(5.0f));
+    const auto treble = juce::IIRCoefficients::makeHighShelf(48000.0, 3000.0, 0.707, juce::Decibels::decibelsToGain(-4.0f));
+
+    juce::AudioBuffer<float> input(numChannels, numSamples);
+    juce::Random random(99);
+    for (int ch = 0; ch < numChannels; ++ch)
+        for (int i = 0; i < numSamples; ++i)
+            input.setSample(ch, i, random.nextFloat() - 0.5f);
+
+    juce::AudioBuffer<float> expected(input);
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        juce::SingleThreadedIIRFilter bassFilter, trebleFilter;
+        bassFilter.setCoefficients(bass);
+        trebleFilter.setCoefficients(treble);
+
+        for (int i = 0; i < numSamples; ++i)
+            expected.setSample(ch, i, trebleFilter.processSingleSampleRaw(bassFilter.processSingleSampleRaw(input.getSample(ch, i))));
+    }
+
+    ShelfFilterBank<float> bank;
+    bank.prepare(numChannels);
+    bank.setCoefficients(bass, treble);
+
+    // Two calls, so the state carries over between slices
+    juce::AudioBuffer<float> output(input);
+    bank.process(output.getArrayOfWritePointers(), numChannels, 300);
+
+    float* rest[numChannels];
+    for (int ch = 0; ch < numChannels; ++ch)
+        rest[ch] = output.getWritePointer(ch, 300);
+    bank.process(rest, numChannels, numSamples - 300);
+
+    float maxError = 0.0f;
+    for (int ch = 0; ch < numChannels; ++ch)
+        for (int i = 0; i < numSamples; ++i)
+            maxError = juce::jmax(maxError, std::abs(output.getSample(ch, i) - expected.getSample(ch, i)));
+
+    CHECK(maxError < 1.0e-5f);
+}
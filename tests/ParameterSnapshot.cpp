@@ -0,0 +1,146 @@
+#include <ParameterSnapshot.h>
+#include <PluginProcessor.h>
+#include <catch2/catch_test_macros.hpp>
+
+namespace
+{
+    void setParameter(PluginProcessor& plugin, const juce::String& id, float value)
+    {
+        auto* parameter = plugin.parameters.getParameter(id);
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    }
+
+    // One slice as processBlock runs it: pick up the parameters, then move the ramps
+    void process(ParameterSnapshot& snapshot, int numSamples)
+    {
+        snapshot.pull();
+        snapshot.advance(numSamples);
+    }
+}
+
+TEST_CASE ("Parameter snapshot", "[parameters]")
+{
+    PluginProcessor plugin;
+    ParameterSnapshot snapshot;
+    snapshot.attach(plugin.parameters);
+    snapshot.prepare(48000.0);
+
+    // First slice hands the initial coefficients to the filters, then nothing to do
+    process(snapshot, 64);
+    CHECK(snapshot.haveFilterCoefficientsChanged());
+    const int initialUpdates = snapshot.getNumCoefficientUpdates();
+
+    for (int i = 0; i < 100; ++i)
+        process(snapshot, 64);
+
+    CHECK(snapshot.getNumCoefficientUpdates() == initialUpdates);
+    CHECK_FALSE(snapshot.haveFilterCoefficientsChanged());
+    CHECK_FALSE(snapshot.getMasterGain().isRamping());
+
+    SECTION ("EQ coefficients are rebuilt only while the dB value ramps")
+    {
+        setParameter(plugin, "bass", 6.0f);
+
+        process(snapshot, 64);
+        CHECK(snapshot.haveFilterCoefficientsChanged());
+
+        // 50 ms at 48 kHz is under 40 slices of 64
+        for (int i = 0; i < 40; ++i)
+            process(snapshot, 64);
+
+        const int settledUpdates = snapshot.getNumCoefficientUpdates();
+        for (int i = 0; i < 100; ++i)
+            process(snapshot, 64);
+
+        CHECK(snapshot.getNumCoefficientUpdates() == settledUpdates);
+
+        // Landed exactly on the target shelf
+        const auto expected = juce::IIRCoefficients::makeLowShelf(48000.0,
+            ParameterSnapshot::bassFrequency,
+            ParameterSnapshot::shelfQ,
+            juce::Decibels::decibelsToGain(6.0f));
+
+        for (int i = 0; i < 5; ++i)
+            CHECK(std::abs(snapshot.getBassCoefficients().coefficients[i] - expected.coefficients[i]) < 1.0e-6f);
+    }
+
+    SECTION ("gain changes ramp to the new value")
+    {
+        setParameter(plugin, "masterGain", -6.0f);
+
+        process(snapshot, 64);
+        const auto ramp = snapshot.getMasterGain();
+        CHECK(ramp.isRamping());
+        CHECK(ramp.start == 1.0f);
+        CHECK(ramp.end < 1.0f);
+
+        for (int i = 0; i < 20; ++i)
+            process(snapshot, 64);
+
+        CHECK_FALSE(snapshot.getMasterGain().isRamping());
+        CHECK(std::abs(snapshot.getMasterGain().end - juce::Decibels::decibelsToGain(-6.0f)) < 1.0e-6f);
+    }
+
+    SECTION ("bypass ramps the mix to fully dry")
+    {
+        setParameter(plugin, "bypass", 1.0f);
+
+        for (int i = 0; i < 20; ++i)
+            process(snapshot, 64);
+
+        CHECK(snapshot.getValues().bypass);
+        CHECK(snapshot.getDryGain().end == 1.0f);
+        CHECK(snapshot.getWetGain().end == 0.0f);
+    }
+
+    SECTION ("feedback ramps the same however the slices are cut")
+    {
+        // One 480-sample slice against the same span cut into 7 + 473 samples
+        ParameterSnapshot split;
+        split.attach(plugin.parameters);
+        split.prepare(48000.0);
+        process(split, 64);
+
+        setParameter(plugin, "feedback", 0.8f);
+        split.pull();
+
+        process(snapshot, 480);
+        CHECK(snapshot.getFeedback().isRamping());
+        CHECK(snapshot.getFeedback().start == 0.2f);
+
+        split.advance(7);
+        const auto first = split.getFeedback();
+        split.advance(473);
+        const auto second = split.getFeedback();
+
+        CHECK(first.start == 0.2f);
+        CHECK(first.end == second.start);
+        CHECK(std::abs(second.end - snapshot.getFeedback().end) < 1.0e-6f);
+
+        // 20 ms later it sits on the new value
+        for (int i = 0; i < 20; ++i)
+            process(snapshot, 64);
+
+        CHECK_FALSE(snapshot.getFeedback().isRamping());
+        CHECK(std::abs(snapshot.getFeedback().end - 0.8f) < 1.0e-6f);
+    }
+
+    SECTION ("switching a head off fades it out")
+    {
+        CHECK(snapshot.getHeadGain(1).end == 1.0f);
+
+        setParameter(plugin, "head2", 0.0f);
+
+        process(snapshot, 64);
+        CHECK(snapshot.getHeadGain(1).start == 1.0f);
+        CHECK(snapshot.getHeadGain(1).end > 0.0f);
+        CHECK(snapshot.getHeadGain(1).end < 1.0f);
+        CHECK_FALSE(snapshot.getHeadGain(0).isRamping());
+
+        for (int i = 0; i < 20; ++i)
+            process(snapshot, 64);
+
+        CHECK_FALSE(snapshot.getHeadGain(1).isRamping());
+        CHECK(snapshot.getHeadGain(1).end == 0.0f);
+    }
+}
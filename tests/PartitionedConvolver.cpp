@@ -0,0 +1,311 @@
+#include <PartitionedConvolver.h>
+#include <PluginProcessor.h>
+#include <catch2/catch_test_macros.hpp>
+
+namespace
+{
+    ImpulseResponseCache::Ptr makeDecayingNoiseIR(int length, int numChannels)
+    {
+        auto ir = std::make_shared<ImpulseResponseCache::ImpulseResponse>();
+        ir->identity = "test";
+        ir->sampleRate = 48000.0;
+        ir->stereo = numChannels > 1;
+        ir->buffer.setSize(numChannels, length);
+
+        juce::Random random(7);
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < length; ++i)
+                ir->buffer.setSample(ch, i, (random.nextFloat() - 0.5f) * std::exp(-3.0f * static_cast<float>(i) / static_cast<float>(length)));
+
+        return ir;
+    }
+
+    // Largest difference from direct convolution over a long render, the output shifted
+    // back by the convolver's latency
+    float renderError(int latency)
+    {
+        // Long enough to use every stage, including the background tail
+        constexpr int irLength = 12000;
+        constexpr int numSamples = 20000;
+        constexpr int numChannels = 2;
+
+        auto ir = makeDecayingNoiseIR(irLength, numChannels);
+
+        juce::AudioBuffer<float> input(numChannels, numSamples);
+        juce::Random random(3);
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < numSamples; ++i)
+                input.setSample(ch, i, random.nextFloat() - 0.5f);
+
+        // Odd host block size so partition boundaries fall in the middle of blocks
+        constexpr int blockSize = 37;
+
+        // Offline: rendered faster than realtime, late jobs are waited for, not dropped
+        PartitionedConvolver convolver;
+        convolver.setNonRealtime(true);
+        convolver.prepare({ 48000.0, static_cast<juce::uint32>(blockSize), static_cast<juce::uint32>(numChannels) }, latency);
+        convolver.loadImpulseResponse(ir);
+        CHECK(convolver.getLatencySamples() == latency);
+
+        juce::AudioBuffer<float> output(input);
+        for (int start = 0; start < numSamples; start += blockSize)
+        {
+            const int n = juce::jmin(blockSize, numSamples - start);
+            auto block = juce::dsp::AudioBlock<float>(output).getSubBlock(static_cast<size_t>(start), static_cast<size_t>(n));
+            convolver.process(juce::dsp::ProcessContextReplacing<float>(block));
+        }
+
+        CHECK(convolver.getCurrentIRSize() == irLength);
+
+        float maxError = 0.0f;
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const float* x = input.getReadPointer(ch);
+            const float* h = ir->buffer.getReadPointer(ch);
+
+            for (int i = 0; i < latency; ++i)
+                maxError = juce::jmax(maxError, std::abs(output.getSample(ch, i)));
+
+            for (int i = 0; i + latency < numSamples; i += 7)
+            {
+                double expected = 0.0;
+                for (int k = 0; k < juce::jmin(irLength, i + 1); ++k)
+                    expected += static_cast<double>(h[k]) * x[i - k];
+
+                maxError = juce::jmax(maxError, std::abs(static_cast<float>(expected) - output.getSample(ch, i + latency)));
+            }
+        }
+
+        return maxError;
+    }
+
+    // First output sample that is not silent, for an impulse into the plugin
+    int firstSoundingSample(bool offloadReverb)
+    {
+        PluginProcessor plugin;
+        plugin.setReverbOffloaded(offloadReverb);
+        plugin.setRateAndBufferSizeDetails(48000.0, 256);
+        plugin.prepareToPlay(48000.0, 256);
+        CHECK(plugin.getLatencySamples() == (offloadReverb ? PartitionedConvolver::getOffloadLatency(256) : 0));
+
+        juce::AudioBuffer<float> buffer(2, 256);
+        juce::MidiBuffer midi;
+        for (int blockStart = 0; blockStart < 48000; blockStart += 256)
+        {
+            buffer.clear();
+            if (blockStart == 0)
+            {
+                buffer.setSample(0, 0, 0.5f);
+                buffer.setSample(1, 0, 0.5f);
+            }
+
+            plugin.processBlock(buffer, midi);
+
+            for (int i = 0; i < 256; ++i)
+                if (buffer.getSample(0, i) != 0.0f)
+                    return blockStart + i;
+        }
+
+        return -1;
+    }
+}
+
+TEST_CASE ("Partitioned convolver matches direct convolution", "[reverb]")
+{
+    CHECK(renderError(0) < 1.0e-3f);
+}
+
+TEST_CASE ("Partitioned convolver with latency runs every stage on the pool", "[reverb]")
+{
+    CHECK(PartitionedConvolver::getOffloadLatency(37) == 1024);
+    CHECK(PartitionedConvolver::getOffloadLatency(1000) == 2048);
+
+    // Same result, delayed by exactly the reported latency
+    CHECK(renderError(PartitionedConvolver::getOffloadLatency(37)) < 1.0e-3f);
+}
+
+TEST_CASE ("Offloaded reverb delays the whole plugin by its reported latency", "[reverb]")
+{
+    const int direct = firstSoundingSample(false);
+    REQUIRE(direct >= 0);
+    CHECK(firstSoundingSample(true) == direct + PartitionedConvolver::getOffloadLatency(256));
+}
+
+TEST_CASE ("Reset drops the tail and the jobs in flight", "[reverb]")
+{
+    constexpr int irLength = 20000;
+    constexpr int numChannels = 2;
+    constexpr int blockSize = 37;
+    constexpr int resetAt = 37 * 811; // a block boundary, with jobs of every stage in flight
+    constexpr int numSamples = 60000;
+    const int latency = PartitionedConvolver::getOffloadLatency(blockSize);
+
+    auto ir = makeDecayingNoiseIR(irLength, numChannels);
+
+    juce::AudioBuffer<float> input(numChannels, numSamples);
+    juce::Random random(5);
+    for (int ch = 0; ch < numChannels; ++ch)
+        for (int i = 0; i < numSamples; ++i)
+            input.setSample(ch, i, random.nextFloat() - 0.5f);
+
+    PartitionedConvolver convolver;
+    convolver.setNonRealtime(true);
+    convolver.prepare({ 48000.0, static_cast<juce::uint32>(blockSize), static_cast<juce::uint32>(numChannels) }, latency);
+    convolver.loadImpulseResponse(ir);
+
+    juce::AudioBuffer<float> output(input);
+    for (int start = 0; start < numSamples; start += blockSize)
+    {
+        if (start == resetAt)
+            convolver.reset();
+
+        const int n = juce::jmin(blockSize, numSamples - start);
+        auto block = juce::dsp::AudioBlock<float>(output).getSubBlock(static_cast<size_t>(start), static_cast<size_t>(n));
+        convolver.process(juce::dsp::ProcessContextReplacing<float>(block));
+    }
+
+    // From the reset on, exactly the convolution of what came after it
+    float maxError = 0.0f;
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        const float* x = input.getReadPointer(ch, resetAt);
+        const float* h = ir->buffer.getReadPointer(ch);
+
+        for (int i = 0; i < latency; ++i)
+            maxError = juce::jmax(maxError, std::abs(output.getSample(ch, resetAt + i)));
+
+        for (int i = 0; resetAt + latency + i < numSamples; i += 7)
+        {
+            double expected = 0.0;
+            for (int k = 0; k < juce::jmin(irLength, i + 1); ++k)
+                expected += static_cast<double>(h[k]) * x[i - k];
+
+            maxError = juce::jmax(maxError, std::abs(static_cast<float>(expected) - output.getSample(ch, resetAt + latency + i)));
+        }
+    }
+
+    CHECK(maxError < 1.0e-3f);
+}
+
+TEST_CASE ("IR swaps keep working without a worker pool slot", "[reverb]")
+{
+    // Take every slot, so the convolver runs all its jobs on the audio thread
+    struct IdleClient : ConvolutionWorkerPool::Client
+    {
+        bool runBackgroundWork() override { return false; }
+    } idleClient;
+
+    juce::SharedResourcePointer<ConvolutionWorkerPool> pool;
+    std::vector<int> takenSlots;
+    for (int slot = pool->add(&idleClient); slot >= 0; slot = pool->add(&idleClient))
+        takenSlots.push_back(slot);
+
+    {
+        constexpr int blockSize = 256;
+        PartitionedConvolver convolver;
+        convolver.prepare({ 48000.0, static_cast<juce::uint32>(blockSize), 2 }, 0);
+
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        for (const int irLength : { 4000, 6000, 8000, 10000 })
+        {
+            convolver.loadImpulseResponse(makeDecayingNoiseIR(irLength, 2));
+
+            // Well past the crossfade, so the old engine is retired before the next swap
+            for (int block = 0; block < 64; ++block)
+            {
+                buffer.clear();
+                juce::dsp::AudioBlock<float> audioBlock(buffer);
+                convolver.process(juce::dsp::ProcessContextReplacing<float>(audioBlock));
+            }
+
+            CHECK(convolver.getCurrentIRSize() == irLength);
+        }
+    }
+
+    for (auto slot : takenSlots)
+        pool->remove(slot);
+}
+
+TEST_CASE ("Tail limit stops the convolution short and fades the tail back in", "[reverb]")
+{
+    constexpr int irLength = 20000;
+    constexpr int numChannels = 2;
+    constexpr int blockSize = 37;
+    constexpr int limit = 8192 + 4096; // the first partition of the background stage
+    constexpr int liftedAt = 20000;
+    constexpr int numSamples = 70000;
+
+    auto ir = makeDecayingNoiseIR(irLength, numChannels);
+
+    juce::AudioBuffer<float> input(numChannels, numSamples);
+    juce::Random random(3);
+    for (int ch = 0; ch < numChannels; ++ch)
+        for (int i = 0; i < numSamples; ++i)
+            input.setSample(ch, i, random.nextFloat() - 0.5f);
+
+    PartitionedConvolver convolver;
+    convolver.setNonRealtime(true);
+    convolver.prepare({ 48000.0, static_cast<juce::uint32>(blockSize), static_cast<juce::uint32>(numChannels) });
+    convolver.loadImpulseResponse(ir);
+    convolver.setTailLimit(limit);
+
+    juce::AudioBuffer<float> output(input);
+    for (int start = 0; start < numSamples; start += blockSize)
+    {
+        if (start >= liftedAt)
+            convolver.setTailLimit(0);
+
+        const int n = juce::jmin(blockSize, numSamples - start);
+        auto block = juce::dsp::AudioBlock<float>(output).getSubBlock(static_cast<size_t>(start), static_cast<size_t>(n));
+        convolver.process(juce::dsp::ProcessContextReplacing<float>(block));
+    }
+
+    // Direct convolution with the first `length` samples of the IR
+    auto errorAgainst = [&](int length, int from, int to) {
+        float maxError = 0.0f;
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const float* x = input.getReadPointer(ch);
+            const float* h = ir->buffer.getReadPointer(ch);
+
+            for (int i = from; i < to; i += 7)
+            {
+                double expected = 0.0;
+                for (int k = 0; k < juce::jmin(length, i + 1); ++k)
+                    expected += static_cast<double>(h[k]) * x[i - k];
+
+                maxError = juce::jmax(maxError, std::abs(static_cast<float>(expected) - output.getSample(ch, i)));
+            }
+        }
+        return maxError;
+    };
+
+    // A limit set before the first job applies at once: the IR is simply shorter
+    CHECK(errorAgainst(limit, 0, liftedAt) < 1.0e-3f);
+
+    // Once the fade is over the whole IR is back, with its full history
+    CHECK(errorAgainst(irLength, liftedAt + 12 * 4096, numSamples) < 1.0e-3f);
+}
+
+TEST_CASE ("Convolvers with the same IR share its partition spectra", "[reverb]")
+{
+    auto ir = makeDecayingNoiseIR(12000, 2);
+
+    // The tail stage's segment; built on the first request, the same data after that
+    const auto tail = ir->getSpectra(4096, 8192, 12000);
+    REQUIRE(tail == ir->getSpectra(4096, 8192, 12000));
+    CHECK(tail->numPartitions == 1);
+    CHECK(tail->channels.size() == 2);
+
+    // Whatever their latency or channel count, instances hold the IR's copy, not their own
+    const auto holders = tail.use_count();
+    PartitionedConvolver stereo, offloaded, surround;
+    stereo.prepare({ 48000.0, 256, 2 }, 0);
+    offloaded.prepare({ 48000.0, 256, 2 }, PartitionedConvolver::getOffloadLatency(256));
+    surround.prepare({ 48000.0, 256, 8 }, 0);
+
+    for (auto* convolver : { &stereo, &offloaded, &surround })
+        convolver->loadImpulseResponse(ir);
+
+    CHECK(tail.use_count() == holders + 3);
+}
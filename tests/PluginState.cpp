@@ -0,0 +1,221 @@
+#include <PluginProcessor.h>
+#include <PluginState.h>
+#include <catch2/catch_test_macros.hpp>
+
+namespace
+{
+    PluginState makeState()
+    {
+        PluginState state;
+        state.parameters = juce::ValueTree("Parameters");
+        state.parameters.setProperty("reverbOffload", true, nullptr);
+
+        juce::ValueTree parameter("PARAM");
+        parameter.setProperty("id", "feedback", nullptr);
+        parameter.setProperty("value", 0.7f, nullptr);
+        state.parameters.appendChild(parameter, nullptr);
+
+        state.impulseResponse.isCustom = true;
+        state.impulseResponse.stereo = false;
+        state.impulseResponse.path = "/tmp/hall.wav";
+        state.impulseResponse.hash = 1234567890123LL;
+        return state;
+    }
+
+    // Processes clicks (silence would let the plugin go idle) until the condition holds or
+    // a few seconds have passed. The convolver swaps IRs on the audio thread, one
+    // crossfade at a time, so a new IR can take several blocks to show up.
+    template <typename Condition>
+    bool processUntil(PluginProcessor& plugin, Condition condition)
+    {
+        juce::AudioBuffer<float> buffer(2, 256);
+        juce::MidiBuffer midi;
+        for (int block = 0; block < 2000 && !condition(); ++block)
+        {
+            buffer.clear();
+            buffer.setSample(0, 0, 0.1f);
+            plugin.processBlock(buffer, midi);
+            juce::Thread::sleep(1);
+        }
+        return condition();
+    }
+
+    // A short decaying-noise IR written as a WAV file
+    juce::File writeTestIR(const juce::File& file, int length)
+    {
+        juce::AudioBuffer<float> buffer(2, length);
+        juce::Random random(5);
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 0; i < length; ++i)
+                buffer.setSample(ch, i, (random.nextFloat() - 0.5f) * std::exp(-4.0f * static_cast<float>(i) / static_cast<float>(length)));
+
+        file.deleteFile();
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(new juce::FileOutputStream(file), 48000.0, 2, 24, {}, 0));
+        writer->writeFromAudioSampleBuffer(buffer, 0, length);
+        return file;
+    }
+}
+
+TEST_CASE ("Binary plugin state", "[state]")
+{
+    SECTION ("round trips parameters and the IR reference")
+    {
+        const auto saved = makeState();
+        juce::MemoryBlock data;
+        saved.write(data);
+
+        PluginState restored;
+        REQUIRE(restored.read(data.getData(), static_cast<int>(data.getSize())));
+        CHECK(restored.version == PluginState::currentVersion);
+        CHECK(restored.parameters.isEquivalentTo(saved.parameters));
+        CHECK(restored.impulseResponse.isCustom);
+        CHECK_FALSE(restored.impulseResponse.stereo);
+        CHECK(restored.impulseResponse.path == saved.impulseResponse.path);
+        CHECK(restored.impulseResponse.hash == saved.impulseResponse.hash);
+        CHECK(restored.impulseResponse.embeddedData == nullptr);
+    }
+
+    SECTION ("carries an embedded IR")
+    {
+        auto saved = makeState();
+        const char bytes[] = "RIFF....WAVEfmt ";
+        saved.impulseResponse.embeddedData = std::make_shared<const juce::MemoryBlock>(bytes, sizeof(bytes));
+
+        juce::MemoryBlock data;
+        saved.write(data);
+
+        PluginState restored;
+        REQUIRE(restored.read(data.getData(), static_cast<int>(data.getSize())));
+        REQUIRE(restored.impulseResponse.embeddedData != nullptr);
+        CHECK(*restored.impulseResponse.embeddedData == *saved.impulseResponse.embeddedData);
+    }
+
+    SECTION ("skips sections it does not know")
+    {
+        juce::MemoryBlock data;
+        makeState().write(data);
+
+        // A section from a later version, appended after the known ones
+        juce::MemoryOutputStream stream(data, true);
+        stream.writeInt(0x5458454e); // "NEXT"
+        stream.writeInt64(3);
+        stream.write("abc", 3);
+        stream.flush();
+
+        PluginState restored;
+        CHECK(restored.read(data.getData(), static_cast<int>(data.getSize())));
+        CHECK(restored.impulseResponse.path == "/tmp/hall.wav");
+    }
+
+    SECTION ("rejects other formats and truncated data")
+    {
+        juce::MemoryBlock xml;
+        juce::AudioProcessor::copyXmlToBinary(juce::XmlElement("Parameters"), xml);
+
+        PluginState restored;
+        CHECK_FALSE(restored.read(xml.getData(), static_cast<int>(xml.getSize())));
+
+        juce::MemoryBlock data;
+        makeState().write(data);
+        CHECK_FALSE(restored.read(data.getData(), static_cast<int>(data.getSize()) - 5));
+    }
+
+    SECTION ("content hash is stable")
+    {
+        CHECK(PluginState::hashContent("", 0) == static_cast<juce::int64>(0xcbf29ce484222325ull));
+        CHECK(PluginState::hashContent("a", 1) == static_cast<juce::int64>(0xaf63dc4c8601ec8cull));
+        CHECK(PluginState::hashContent("ab", 2) != PluginState::hashContent("ba", 2));
+    }
+}
+
+TEST_CASE ("Processor state", "[state]")
+{
+    SECTION ("parameters survive a save and restore")
+    {
+        PluginProcessor saved;
+        saved.parameters.getParameter("feedback")->setValueNotifyingHost(0.25f);
+        saved.setEmbedIRInState(true);
+
+        juce::MemoryBlock data;
+        saved.getStateInformation(data);
+
+        PluginProcessor restored;
+        restored.setStateInformation(data.getData(), static_cast<int>(data.getSize()));
+        CHECK(restored.parameters.getParameter("feedback")->getValue() == saved.parameters.getParameter("feedback")->getValue());
+        CHECK(restored.isEmbeddingIRInState());
+    }
+
+    SECTION ("sessions saved as XML still load")
+    {
+        PluginProcessor saved;
+        saved.parameters.getParameter("feedback")->setValueNotifyingHost(0.25f);
+
+        juce::MemoryBlock data;
+        juce::AudioProcessor::copyXmlToBinary(*saved.parameters.copyState().createXml(), data);
+
+        PluginProcessor restored;
+        restored.setStateInformation(data.getData(), static_cast<int>(data.getSize()));
+        CHECK(restored.parameters.getParameter("feedback")->getValue() == saved.parameters.getParameter("feedback")->getValue());
+    }
+
+    SECTION ("sessions saved as XML bring back the stock IR")
+    {
+        const auto file = writeTestIR(juce::File::getSpecialLocation(juce::File::tempDirectory).getChildFile("ctd201-legacy-test.wav"), 9000);
+
+        PluginProcessor stock;
+        stock.prepareToPlay(48000.0, 256);
+        REQUIRE(processUntil(stock, [&] { return stock.reverbConvolver.getCurrentIRSize() > 0; }));
+        const int stockIRSize = stock.reverbConvolver.getCurrentIRSize();
+
+        PluginProcessor restored;
+        restored.prepareToPlay(48000.0, 256);
+        restored.loadImpulseResponse(file);
+        REQUIRE(restored.getCustomIRFile() == file);
+        REQUIRE(processUntil(restored, [&] { return restored.reverbConvolver.getCurrentIRSize() > 0
+                                                    && restored.reverbConvolver.getCurrentIRSize() != stockIRSize; }));
+
+        juce::MemoryBlock data;
+        juce::AudioProcessor::copyXmlToBinary(*stock.parameters.copyState().createXml(), data);
+        restored.setStateInformation(data.getData(), static_cast<int>(data.getSize()));
+        CHECK(restored.getCustomIRFile() == juce::File());
+
+        REQUIRE(restored.waitForImpulseResponse(5000));
+        CHECK(processUntil(restored, [&] { return restored.reverbConvolver.getCurrentIRSize() == stockIRSize; }));
+
+        file.deleteFile();
+    }
+
+    SECTION ("a custom IR reopens from the session when its file is gone")
+    {
+        const auto file = writeTestIR(juce::File::getSpecialLocation(juce::File::tempDirectory).getChildFile("ctd201-state-test.wav"), 9000);
+
+        juce::MemoryBlock data;
+        int savedIRSize = 0;
+        {
+            PluginProcessor saved;
+            saved.prepareToPlay(48000.0, 256);
+            saved.loadImpulseResponse(file);
+            saved.setEmbedIRInState(true);
+            savedIRSize = saved.reverbConvolver.getCurrentIRSize();
+            saved.getStateInformation(data);
+        }
+
+        REQUIRE(savedIRSize > 0);
+        file.deleteFile();
+
+        PluginProcessor restored;
+        restored.prepareToPlay(48000.0, 256);
+        restored.setStateInformation(data.getData(), static_cast<int>(data.getSize()));
+
+        // Queued, not loaded inside setStateInformation
+        REQUIRE(restored.waitForImpulseResponse(5000));
+        CHECK(restored.getCustomIRFile() == file);
+
+        juce::AudioBuffer<float> buffer(2, 256);
+        juce::MidiBuffer midi;
+        buffer.clear();
+        restored.processBlock(buffer, midi);
+        CHECK(restored.reverbConvolver.getCurrentIRSize() == savedIRSize);
+    }
+}
@@ -0,0 +1,147 @@
+#include <PluginProcessor.h>
+#include <QualityGovernor.h>
+#include <catch2/catch_test_macros.hpp>
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 480; // 10 ms
+
+    // Feeds `seconds` of blocks that each took `load` of their real-time length
+    void run(QualityGovernor& governor, double load, double seconds, bool enabled = true)
+    {
+        const double blockSeconds = blockSize / sampleRate;
+        for (int i = 0; i < static_cast<int>(seconds / blockSeconds); ++i)
+            governor.addBlock(load * blockSeconds, blockSize, enabled);
+    }
+
+    int tierIndex(const QualityGovernor& governor)
+    {
+        return static_cast<int>(governor.getTier());
+    }
+}
+
+TEST_CASE ("Governor steps down under sustained load, one tier at a time", "[governor]")
+{
+    QualityGovernor governor;
+    governor.prepare(sampleRate);
+    const auto& settings = governor.getSettings();
+
+    // Comfortable: stays at full quality
+    run(governor, 0.05, 10.0);
+    CHECK(governor.getTier() == QualityGovernor::Tier::full);
+    CHECK(governor.getLoad() < 0.06f);
+
+    // Overloaded: one step per hold time (plus the time the average takes to get there)
+    run(governor, 0.9, settings.holdDownSeconds + 0.5);
+    CHECK(governor.getTier() == QualityGovernor::Tier::shortReverbTail);
+
+    run(governor, 0.9, settings.holdDownSeconds);
+    CHECK(governor.getTier() == QualityGovernor::Tier::cheapInterpolation);
+
+    run(governor, 0.9, 10.0);
+    CHECK(governor.getTier() == QualityGovernor::Tier::controlRateModulation);
+}
+
+TEST_CASE ("Governor ignores short spikes", "[governor]")
+{
+    QualityGovernor governor;
+    governor.prepare(sampleRate);
+
+    // A few blocks over the deadline now and then never add up to sustained pressure
+    for (int i = 0; i < 20; ++i)
+    {
+        run(governor, 2.0, 0.05);
+        run(governor, 0.05, 1.0);
+    }
+
+    CHECK(governor.getTier() == QualityGovernor::Tier::full);
+}
+
+TEST_CASE ("Governor steps back up only after lasting headroom", "[governor]")
+{
+    QualityGovernor governor;
+    governor.prepare(sampleRate);
+    const auto& settings = governor.getSettings();
+
+    run(governor, 0.9, 10.0);
+    REQUIRE(governor.getTier() == QualityGovernor::Tier::controlRateModulation);
+
+    // Between the thresholds: holds the tier whichever way it came from
+    run(governor, 0.15, 20.0);
+    CHECK(governor.getTier() == QualityGovernor::Tier::controlRateModulation);
+
+    // Light load: one step up per (longer) hold time
+    run(governor, 0.03, settings.holdUpSeconds + 1.0);
+    CHECK(tierIndex(governor) == QualityGovernor::numTiers - 2);
+
+    run(governor, 0.03, 3.0 * settings.holdUpSeconds);
+    CHECK(governor.getTier() == QualityGovernor::Tier::full);
+}
+
+TEST_CASE ("Governor does not hunt around a steady load", "[governor]")
+{
+    QualityGovernor governor;
+    governor.prepare(sampleRate);
+
+    // Load that drops once quality does: steps down to where it fits, then stays
+    int changes = 0;
+    auto previous = governor.getTier();
+    for (int i = 0; i < 6000; ++i) // a minute
+    {
+        const double load = 0.4 - 0.1 * tierIndex(governor);
+        governor.addBlock(load * blockSize / sampleRate, blockSize, true);
+
+        changes += governor.getTier() != previous ? 1 : 0;
+        previous = governor.getTier();
+    }
+
+    CHECK(governor.getTier() == QualityGovernor::Tier::cheapInterpolation);
+    CHECK(changes == 2);
+}
+
+TEST_CASE ("Switching the governor off restores full quality", "[governor]")
+{
+    QualityGovernor governor;
+    governor.prepare(sampleRate);
+
+    run(governor, 0.9, 10.0);
+    REQUIRE(governor.getTier() != QualityGovernor::Tier::full);
+
+    governor.addBlock(0.0, blockSize, false);
+    CHECK(governor.getTier() == QualityGovernor::Tier::full);
+    CHECK(governor.getLoad() == 0.0f);
+
+    // Off, no amount of load moves it
+    run(governor, 0.9, 10.0, false);
+    CHECK(governor.getTier() == QualityGovernor::Tier::full);
+}
+
+TEST_CASE ("Quality tier is published as a read-only parameter", "[governor]")
+{
+    PluginProcessor plugin;
+
+    auto* tier = plugin.parameters.getParameter("qualityTier");
+    REQUIRE(tier != nullptr);
+    CHECK_FALSE(tier->isAutomatable());
+    CHECK(tier->getNumSteps() == QualityGovernor::numTiers);
+    CHECK(plugin.getQualityTier() == QualityGovernor::Tier::full);
+
+    // Offline renders have no deadline: switched on, a bounce still runs at full quality
+    plugin.parameters.getParameter("adaptiveQuality")->setValueNotifyingHost(1.0f);
+    plugin.setNonRealtime(true);
+    plugin.setRateAndBufferSizeDetails(48000.0, 512);
+    plugin.prepareToPlay(48000.0, 512);
+
+    juce::AudioBuffer<float> buffer(2, 512);
+    juce::MidiBuffer midi;
+    for (int block = 0; block < 200; ++block)
+    {
+        buffer.clear();
+        buffer.setSample(0, 0, 0.5f);
+        plugin.processBlock(buffer, midi);
+    }
+
+    CHECK(plugin.getQualityTier() == QualityGovernor::Tier::full);
+    CHECK(plugin.getGovernorLoad() == 0.0f);
+}
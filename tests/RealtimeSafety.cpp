@@ -0,0 +1,296 @@
+#include "helpers/test_helpers.h"
+#include <PluginProcessor.h>
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdlib>
+#include <new>
+
+#if defined(__GLIBC__)
+#include <dlfcn.h>
+#include <pthread.h>
+#include <semaphore.h>
+#endif
+
+/* Counts heap allocations, and locks or waits, made on the current thread while a
+ * RealtimeMonitor is alive.
+ *
+ * Global operator new covers std::vector & friends. JUCE's HeapBlock (and so AudioBuffer)
+ * goes straight to std::malloc, so on glibc we also interpose malloc/calloc/realloc.
+ * Locks are counted on glibc only, where every mutex, condition variable and semaphore
+ * wait goes through the pthread/semaphore functions interposed below (std::mutex,
+ * juce::CriticalSection and juce::WaitableEvent included). Posting a semaphore is not a
+ * lock and isn't counted. Other threads (e.g. the convolution loader) are ignored.
+ */
+namespace
+{
+    thread_local bool monitoring = false;
+    std::atomic<int> allocationCount { 0 };
+    std::atomic<int> lockCount { 0 };
+
+    void noteAllocation()
+    {
+        if (monitoring)
+            allocationCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    [[maybe_unused]] void noteLock()
+    {
+        if (monitoring)
+            lockCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    struct RealtimeMonitor
+    {
+        RealtimeMonitor()
+        {
+            allocationCount = 0;
+            lockCount = 0;
+            monitoring = true;
+        }
+        ~RealtimeMonitor() { monitoring = false; }
+        int allocations() const { return allocationCount.load(); }
+        int locks() const { return lockCount.load(); }
+    };
+}
+
+#if defined(__GLIBC__)
+extern "C" void* __libc_malloc(size_t);
+extern "C" void* __libc_calloc(size_t, size_t);
+extern "C" void* __libc_realloc(void*, size_t);
+
+extern "C" void* malloc(size_t size) noexcept
+{
+    noteAllocation();
+    return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t num, size_t size) noexcept
+{
+    noteAllocation();
+    return __libc_calloc(num, size);
+}
+
+extern "C" void* realloc(void* ptr, size_t size) noexcept
+{
+    noteAllocation();
+    return __libc_realloc(ptr, size);
+}
+
+namespace
+{
+    // The C library's own function (dlsym locks nothing that is counted here)
+    template <typename Function>
+    Function* findNext(const char* name)
+    {
+        return reinterpret_cast<Function*>(dlsym(RTLD_NEXT, name));
+    }
+}
+
+extern "C" int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept
+{
+    static auto* next = findNext<int(pthread_mutex_t*)>("pthread_mutex_lock");
+    noteLock();
+    return next(mutex);
+}
+
+extern "C" int pthread_cond_wait(pthread_cond_t* condition, pthread_mutex_t* mutex)
+{
+    static auto* next = findNext<int(pthread_cond_t*, pthread_mutex_t*)>("pthread_cond_wait");
+    noteLock();
+    return next(condition, mutex);
+}
+
+extern "C" int pthread_cond_timedwait(pthread_cond_t* condition, pthread_mutex_t* mutex, const timespec* time)
+{
+    static auto* next = findNext<int(pthread_cond_t*, pthread_mutex_t*, const timespec*)>("pthread_cond_timedwait");
+    noteLock();
+    return next(condition, mutex, time);
+}
+
+extern "C" int sem_wait(sem_t* semaphore)
+{
+    static auto* next = findNext<int(sem_t*)>("sem_wait");
+    noteLock();
+    return next(semaphore);
+}
+
+extern "C" int sem_timedwait(sem_t* semaphore, const timespec* time)
+{
+    static auto* next = findNext<int(sem_t*, const timespec*)>("sem_timedwait");
+    noteLock();
+    return next(semaphore, time);
+}
+#endif
+
+void* operator new(std::size_t size)
+{
+#if !defined(__GLIBC__)
+    noteAllocation(); // on glibc the malloc hook above already counts this
+#endif
+    if (auto* ptr = std::malloc(size == 0 ? 1 : size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace
+{
+    struct Violations
+    {
+        int allocations = 0;
+        int locks = 0;
+    };
+
+    // Processes numBlocks of noise and returns the allocations and locks the processBlock
+    // calls made. With `moving`, every block carries MIDI controller moves, and what the
+    // message thread does meanwhile (switching the render mode and adaptive quality,
+    // passing the controller moves on to the host) runs between blocks, outside the count.
+    // Every few blocks it pauses long enough for idle convolution workers to park, so
+    // waking them from the audio thread is covered as well.
+    template <typename SampleType>
+    Violations processWhileMonitoring(PluginProcessor& plugin, int blockSize, int numBlocks, bool moving)
+    {
+        juce::AudioBuffer<SampleType> buffer(2, blockSize);
+        juce::MidiBuffer midi;
+        juce::Random random(1234);
+        Violations violations;
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                for (int i = 0; i < blockSize; ++i)
+                    buffer.setSample(ch, i, static_cast<SampleType>(random.nextFloat() * 0.5f - 0.25f));
+
+            midi.clear();
+            if (moving)
+            {
+                // Feedback, delay time and head 2
+                midi.addEvent(juce::MidiMessage::controllerEvent(1, 21, block % 100), 0);
+                midi.addEvent(juce::MidiMessage::controllerEvent(1, 20, (block * 7) % 128), blockSize / 2);
+                midi.addEvent(juce::MidiMessage::controllerEvent(1, 33, block % 2 == 0 ? 0 : 127), blockSize - 1);
+
+                if (block % 20 == 0)
+                {
+                    auto* renderMode = plugin.parameters.getParameter("renderMode");
+                    renderMode->setValueNotifyingHost(renderMode->convertTo0to1(static_cast<float>((block / 20) % 3)));
+                    plugin.parameters.getParameter("adaptiveQuality")->setValueNotifyingHost((block / 20) % 2 == 0 ? 1.0f : 0.0f);
+                    plugin.forwardControllerChanges();
+                }
+
+                if (block % 10 == 0)
+                    juce::Thread::sleep(20);
+            }
+
+            RealtimeMonitor monitor;
+            plugin.processBlock(buffer, midi);
+            violations.allocations += monitor.allocations();
+            violations.locks += monitor.locks();
+        }
+
+        return violations;
+    }
+}
+
+TEST_CASE ("processBlock does not allocate or lock", "[realtime]")
+{
+    PluginProcessor plugin;
+    plugin.setRateAndBufferSizeDetails(48000.0, 64);
+    plugin.prepareToPlay(48000.0, 64);
+
+    juce::MidiBuffer midi;
+    juce::AudioBuffer<float> buffer(2, 1024);
+
+    auto fillWithNoise = [&](int numSamples) {
+        juce::Random random(1234);
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            for (int i = 0; i < numSamples; ++i)
+                buffer.setSample(ch, i, random.nextFloat() * 0.5f - 0.25f);
+    };
+
+    // Warm up: lets the convolution engine install its impulse response
+    for (int i = 0; i < 32; ++i)
+    {
+        juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), 2, 0, 64);
+        fillWithNoise(64);
+        plugin.processBlock(block, midi);
+    }
+
+    SECTION ("at the prepared block size")
+    {
+        juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), 2, 0, 64);
+        RealtimeMonitor monitor;
+
+        for (int i = 0; i < 100; ++i)
+            plugin.processBlock(block, midi);
+
+        REQUIRE(monitor.allocations() == 0);
+        REQUIRE(monitor.locks() == 0);
+    }
+
+    SECTION ("when the host sends a larger block than announced")
+    {
+        juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), 2, 0, 1024);
+        fillWithNoise(1024);
+        RealtimeMonitor monitor;
+
+        for (int i = 0; i < 10; ++i)
+            plugin.processBlock(block, midi);
+
+        REQUIRE(monitor.allocations() == 0);
+        REQUIRE(monitor.locks() == 0);
+    }
+
+    plugin.releaseResources();
+}
+
+TEST_CASE ("processBlock does not allocate or lock while controllers and modes move", "[realtime]")
+{
+    PluginProcessor plugin;
+    plugin.setRateAndBufferSizeDetails(48000.0, 256);
+
+    auto prepare = [&](juce::AudioProcessor::ProcessingPrecision precision, bool offloaded) {
+        plugin.setProcessingPrecision(precision);
+        plugin.setReverbOffloaded(offloaded);
+        plugin.prepareToPlay(48000.0, 256);
+    };
+
+    SECTION ("single precision")
+    {
+        prepare(juce::AudioProcessor::singlePrecision, false);
+        processWhileMonitoring<float>(plugin, 256, 32, false); // warm up
+        const auto violations = processWhileMonitoring<float>(plugin, 256, 200, true);
+        CHECK(violations.allocations == 0);
+        CHECK(violations.locks == 0);
+    }
+
+    SECTION ("single precision, reverb offloaded")
+    {
+        prepare(juce::AudioProcessor::singlePrecision, true);
+        processWhileMonitoring<float>(plugin, 256, 32, false);
+        const auto violations = processWhileMonitoring<float>(plugin, 256, 200, true);
+        CHECK(violations.allocations == 0);
+        CHECK(violations.locks == 0);
+    }
+
+    SECTION ("double precision")
+    {
+        prepare(juce::AudioProcessor::doublePrecision, false);
+        processWhileMonitoring<double>(plugin, 256, 32, false);
+        const auto violations = processWhileMonitoring<double>(plugin, 256, 200, true);
+        CHECK(violations.allocations == 0);
+        CHECK(violations.locks == 0);
+    }
+
+    SECTION ("double precision, reverb offloaded")
+    {
+        prepare(juce::AudioProcessor::doublePrecision, true);
+        processWhileMonitoring<double>(plugin, 256, 32, false);
+        const auto violations = processWhileMonitoring<double>(plugin, 256, 200, true);
+        CHECK(violations.allocations == 0);
+        CHECK(violations.locks == 0);
+    }
+
+    plugin.releaseResources();
+}
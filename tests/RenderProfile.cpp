@@ -0,0 +1,135 @@
+#include <PluginProcessor.h>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    void setRenderMode(PluginProcessor& plugin, PluginProcessor::RenderMode mode)
+    {
+        auto* parameter = plugin.parameters.getParameter("renderMode");
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(static_cast<float>(mode)));
+    }
+
+    void prepare(PluginProcessor& plugin, int blockSize)
+    {
+        // Only the longest head, a steady motor and no reverb: one clean echo per pass
+        for (const auto* id : { "head1", "head2", "reverbMix", "wow", "flutter" })
+            plugin.parameters.getParameter(id)->setValueNotifyingHost(0.0f);
+
+        plugin.setRateAndBufferSizeDetails(48000.0, blockSize);
+        plugin.prepareToPlay(48000.0, blockSize);
+    }
+
+    // Channel 0 of `input` through the plugin in blocks; `beforeBlock` runs ahead of each
+    template <typename Callback>
+    std::vector<float> render(PluginProcessor& plugin, const std::vector<float>& input, int blockSize, Callback beforeBlock)
+    {
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        juce::MidiBuffer midi;
+        std::vector<float> output;
+
+        for (size_t start = 0; start < input.size(); start += static_cast<size_t>(blockSize))
+        {
+            beforeBlock(static_cast<int>(start));
+
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < blockSize; ++i)
+                    buffer.setSample(ch, i, start + static_cast<size_t>(i) < input.size() ? input[start + static_cast<size_t>(i)] : 0.0f);
+
+            plugin.processBlock(buffer, midi);
+            output.insert(output.end(), buffer.getReadPointer(0), buffer.getReadPointer(0) + blockSize);
+        }
+
+        return output;
+    }
+
+    size_t loudestSampleAfter(const std::vector<float>& output, size_t from)
+    {
+        size_t loudest = from;
+        for (size_t i = from; i < output.size(); ++i)
+            if (std::abs(output[i]) > std::abs(output[loudest]))
+                loudest = i;
+
+        return loudest;
+    }
+}
+
+TEST_CASE ("Render profile follows the host and the override", "[quality]")
+{
+    PluginProcessor plugin;
+    prepare(plugin, 256);
+
+    juce::AudioBuffer<float> buffer(2, 256);
+    juce::MidiBuffer midi;
+    auto process = [&] {
+        buffer.clear();
+        plugin.processBlock(buffer, midi);
+        return plugin.isRenderingHighQuality();
+    };
+
+    CHECK_FALSE(process());
+
+    plugin.setNonRealtime(true);
+    CHECK(process());
+
+    setRenderMode(plugin, PluginProcessor::RenderMode::realtime);
+    CHECK_FALSE(process());
+
+    plugin.setNonRealtime(false);
+    setRenderMode(plugin, PluginProcessor::RenderMode::highQuality);
+    CHECK(process());
+}
+
+TEST_CASE ("High quality keeps the echo on time", "[quality]")
+{
+    std::vector<float> impulse(48000, 0.0f);
+    impulse[100] = 0.5f;
+
+    auto firstEcho = [&](PluginProcessor::RenderMode mode) {
+        PluginProcessor plugin;
+        setRenderMode(plugin, mode);
+        prepare(plugin, 512);
+
+        // Everything after the dry impulse is echo; 300 ms on the longest head
+        const auto output = render(plugin, impulse, 512, [](int) {});
+        return loudestSampleAfter(output, 200);
+    };
+
+    const auto realtime = firstEcho(PluginProcessor::RenderMode::realtime);
+    const auto highQuality = firstEcho(PluginProcessor::RenderMode::highQuality);
+    CHECK(realtime == 100 + 300 * 48);
+
+    // The oversampling filters smear the impulse by a fraction of a sample, no more
+    CHECK(highQuality + 1 >= realtime);
+    CHECK(highQuality <= realtime + 1);
+}
+
+TEST_CASE ("Switching profiles does not click", "[quality]")
+{
+    // A steady tone, so every echo overlaps the switches
+    std::vector<float> tone(96000);
+    for (size_t i = 0; i < tone.size(); ++i)
+        tone[i] = 0.4f * std::sin(0.0288f * static_cast<float>(i));
+
+    auto largestStep = [](const std::vector<float>& output) {
+        float step = 0.0f;
+        for (size_t i = 1; i < output.size(); ++i)
+            step = juce::jmax(step, std::abs(output[i] - output[i - 1]));
+        return step;
+    };
+
+    PluginProcessor steady;
+    prepare(steady, 256);
+    const float steadyStep = largestStep(render(steady, tone, 256, [](int) {}));
+
+    PluginProcessor switching;
+    prepare(switching, 256);
+    const auto output = render(switching, tone, 256, [&](int start) {
+        // Back and forth every ~100 ms, sometimes mid-fade
+        const bool highQuality = (start / 4864) % 2 == 1;
+        setRenderMode(switching, highQuality ? PluginProcessor::RenderMode::highQuality : PluginProcessor::RenderMode::realtime);
+    });
+
+    CHECK(largestStep(output) < steadyStep * 1.25f);
+}
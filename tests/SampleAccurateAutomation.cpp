@@ -0,0 +1,140 @@
+#include <PluginProcessor.h>
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+
+namespace
+{
+    struct ControllerEvent
+    {
+        int samplePosition;
+        int controller;
+        int value;
+    };
+
+    // Renders the same input and controller timeline with the given block size
+    std::vector<float> render(int blockSize, const std::vector<ControllerEvent>& events, int numSamples)
+    {
+        PluginProcessor plugin;
+        if (auto* reverbMix = plugin.parameters.getParameter("reverbMix"))
+            reverbMix->setValueNotifyingHost(0.0f);
+
+        plugin.setRateAndBufferSizeDetails(48000.0, blockSize);
+        plugin.prepareToPlay(48000.0, blockSize);
+
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        juce::MidiBuffer midi;
+        std::vector<float> output;
+
+        for (int blockStart = 0; blockStart < numSamples; blockStart += blockSize)
+        {
+            for (int i = 0; i < blockSize; ++i)
+            {
+                // A 220 Hz tone burst every 100 ms, so there is something to echo
+                const int t = blockStart + i;
+                const float tone = (t % 4800) < 960 ? 0.3f * std::sin(0.0288f * static_cast<float>(t)) : 0.0f;
+                buffer.setSample(0, i, tone);
+                buffer.setSample(1, i, tone);
+            }
+
+            midi.clear();
+            for (const auto& event : events)
+                if (event.samplePosition >= blockStart && event.samplePosition < blockStart + blockSize)
+                    midi.addEvent(juce::MidiMessage::controllerEvent(1, event.controller, event.value), event.samplePosition - blockStart);
+
+            plugin.processBlock(buffer, midi);
+            output.insert(output.end(), buffer.getReadPointer(0), buffer.getReadPointer(0) + blockSize);
+        }
+
+        return output;
+    }
+}
+
+TEST_CASE ("MIDI controllers move their parameters", "[automation]")
+{
+    PluginProcessor plugin;
+    plugin.setRateAndBufferSizeDetails(48000.0, 256);
+    plugin.prepareToPlay(48000.0, 256);
+
+    juce::AudioBuffer<float> buffer(2, 256);
+    buffer.clear();
+    juce::MidiBuffer midi;
+    midi.addEvent(juce::MidiMessage::controllerEvent(1, 21, 127), 100); // feedback
+    midi.addEvent(juce::MidiMessage::controllerEvent(1, 33, 0), 200);   // head 2 off
+    midi.addEvent(juce::MidiMessage::controllerEvent(1, 90, 64), 10);   // unmapped
+    midi.addEvent(juce::MidiMessage::noteOn(1, 60, 1.0f), 50);
+
+    plugin.processBlock(buffer, midi);
+
+    // The audio thread only queues the changes for the host
+    CHECK(plugin.parameters.getParameter("feedback")->getValue() < 1.0f);
+    plugin.forwardControllerChanges();
+
+    CHECK(std::abs(plugin.parameters.getParameter("feedback")->getValue() - 1.0f) < 1.0e-6f);
+    CHECK(plugin.parameters.getParameter("head2")->getValue() == 0.0f);
+    CHECK(plugin.parameters.getParameter("head1")->getValue() == 1.0f);
+
+    SECTION ("remapping and unmapping")
+    {
+        plugin.midiControllers.setMapping(90, plugin.parameters.getParameter("wow"));
+        plugin.midiControllers.setMapping(21, nullptr);
+
+        midi.clear();
+        midi.addEvent(juce::MidiMessage::controllerEvent(1, 90, 0), 0);
+        midi.addEvent(juce::MidiMessage::controllerEvent(1, 21, 0), 0);
+        plugin.processBlock(buffer, midi);
+        plugin.forwardControllerChanges();
+
+        CHECK(plugin.parameters.getParameter("wow")->getValue() == 0.0f);
+        CHECK(std::abs(plugin.parameters.getParameter("feedback")->getValue() - 1.0f) < 1.0e-6f);
+    }
+
+    SECTION ("switched off")
+    {
+        plugin.setMidiControllersEnabled(false);
+
+        midi.clear();
+        midi.addEvent(juce::MidiMessage::controllerEvent(1, 21, 0), 0);
+        plugin.processBlock(buffer, midi);
+        plugin.forwardControllerChanges();
+
+        CHECK(std::abs(plugin.parameters.getParameter("feedback")->getValue() - 1.0f) < 1.0e-6f);
+
+        // Saved with the state
+        juce::MemoryBlock state;
+        plugin.getStateInformation(state);
+
+        PluginProcessor restored;
+        restored.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+        CHECK_FALSE(restored.areMidiControllersEnabled());
+        CHECK_FALSE(restored.midiControllers.isEnabled());
+    }
+}
+
+TEST_CASE ("Controller automation does not depend on the block size", "[automation]")
+{
+    // Feedback, echo level, master gain, a head toggle and a bass sweep, none of them on
+    // a block boundary of either size
+    const std::vector<ControllerEvent> events {
+        { 3001, 21, 110 },
+        { 5333, 25, 20 },
+        { 7777, 28, 90 },
+        { 9001, 34, 0 },
+        { 10555, 29, 127 },
+        { 14000, 25, 127 },
+    };
+
+    constexpr int numSamples = 2048 * 12;
+    const auto small = render(64, events, numSamples);
+    const auto large = render(2048, events, numSamples);
+    REQUIRE(small.size() == large.size());
+
+    float maxDifference = 0.0f, peak = 0.0f;
+    for (size_t i = 0; i < small.size(); ++i)
+    {
+        maxDifference = juce::jmax(maxDifference, std::abs(small[i] - large[i]));
+        peak = juce::jmax(peak, std::abs(small[i]));
+    }
+
+    CHECK(peak > 0.05f);
+    CHECK(maxDifference < 1.0e-4f);
+}
@@ -0,0 +1,122 @@
+#include <PluginProcessor.h>
+#include <TailTracker.h>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+
+namespace
+{
+    void setParameter(PluginProcessor& plugin, const juce::String& id, float value)
+    {
+        auto* parameter = plugin.parameters.getParameter(id);
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    }
+}
+
+TEST_CASE ("Tail estimate", "[tail]")
+{
+    SECTION ("echo falls 120 dB, then the reverb rings on")
+    {
+        // Loop gain 0.2: nine trips to -120 dB, plus the first echo
+        CHECK(std::abs(TailTracker::estimateTailSeconds(0.5, 0.2, 0.0) - 5.0) < 1.0e-9);
+        CHECK(std::abs(TailTracker::estimateTailSeconds(0.5, 0.2, 2.0) - 7.0) < 1.0e-9);
+        CHECK(std::abs(TailTracker::estimateTailSeconds(0.5, 0.0, 2.0) - 2.5) < 1.0e-9);
+    }
+
+    SECTION ("a loop gain of one never dies away")
+    {
+        CHECK(std::isinf(TailTracker::estimateTailSeconds(0.5, 1.0, 2.0)));
+    }
+
+    SECTION ("drive and shelf boosts count towards the loop gain, cuts don't")
+    {
+        CHECK(std::abs(TailTracker::getLoopGain(0.5f, 1.0f, 2.0f, 1.0f, 1.0f) - 1.0) < 1.0e-6);
+        CHECK(std::abs(TailTracker::getLoopGain(0.5f, 1.0f, 1.0f, 2.0f, 0.5f) - 1.0) < 1.0e-6);
+    }
+}
+
+TEST_CASE ("Silence tracking", "[tail]")
+{
+    TailTracker tracker;
+
+    tracker.addInput(0.5f, 100);
+    tracker.addTapeWrite(0.5f, 100);
+    CHECK_FALSE(tracker.hasDecayed(1000));
+
+    for (int i = 0; i < 10; ++i)
+    {
+        tracker.addInput(0.0f, 100);
+        tracker.addTapeWrite(i < 5 ? 1.0e-3f : 1.0e-7f, 100);
+    }
+
+    // The input has been silent for 1000 samples, the tape only for 500
+    CHECK_FALSE(tracker.hasDecayed(999));
+    CHECK(tracker.hasDecayed(499));
+
+    float quiet[] = { 0.0f, 1.0e-7f, -1.0e-7f };
+    float loud[] = { 0.0f, 1.0e-3f, 0.0f };
+    const float* quietChannels[] = { quiet };
+    const float* loudChannels[] = { quiet, loud };
+    CHECK(TailTracker::isSilent(quietChannels, 1, 3, TailTracker::silenceThreshold));
+    CHECK_FALSE(TailTracker::isSilent(loudChannels, 2, 3, TailTracker::silenceThreshold));
+}
+
+TEST_CASE ("Processor tail and idle skip", "[tail]")
+{
+    PluginProcessor plugin;
+    setParameter(plugin, "reverbMix", 0.0f);
+    setParameter(plugin, "delayTime", 100.0f);
+    setParameter(plugin, "saturation", 0.0f);
+    plugin.setRateAndBufferSizeDetails(48000.0, 512);
+    plugin.prepareToPlay(48000.0, 512);
+
+    SECTION ("the reported tail follows delay and feedback")
+    {
+        const double tail = plugin.getTailLengthSeconds();
+        CHECK(tail > 0.1);
+
+        setParameter(plugin, "feedback", 0.5f);
+        CHECK(plugin.getTailLengthSeconds() > tail);
+
+        // Feedback x head levels x drive above 1: self-oscillation
+        setParameter(plugin, "saturation", 1.0f);
+        CHECK(std::isinf(plugin.getTailLengthSeconds()));
+
+        setParameter(plugin, "bypass", 1.0f);
+        CHECK(plugin.getTailLengthSeconds() == 0.0);
+    }
+
+    SECTION ("silence puts the plugin to sleep, signal wakes it")
+    {
+        juce::AudioBuffer<float> buffer(2, 512);
+        juce::MidiBuffer midi;
+
+        buffer.clear();
+        buffer.setSample(0, 0, 0.8f);
+        plugin.processBlock(buffer, midi);
+        CHECK_FALSE(plugin.isIdle());
+
+        // Feedback 0.2 at 100 ms dies away within a second or so
+        int blocksUntilIdle = 0;
+        for (; blocksUntilIdle < 400 && !plugin.isIdle(); ++blocksUntilIdle)
+        {
+            buffer.clear();
+            plugin.processBlock(buffer, midi);
+        }
+
+        CHECK(plugin.isIdle());
+        CHECK(blocksUntilIdle > 10);
+
+        // While idle the output is silence
+        buffer.clear();
+        plugin.processBlock(buffer, midi);
+        CHECK(plugin.isIdle());
+        CHECK(buffer.getMagnitude(0, 512) == 0.0f);
+
+        // A new impulse is heard straight away
+        buffer.clear();
+        buffer.setSample(1, 10, 0.5f);
+        plugin.processBlock(buffer, midi);
+        CHECK_FALSE(plugin.isIdle());
+        CHECK(buffer.getMagnitude(1, 0, 512) > 0.1f);
+    }
+}
@@ -0,0 +1,180 @@
+#include <TapeInterpolation.h>
+#include <TapeReadKernel.h>
+#include <TapeRingBuffer.h>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    // Evaluates a policy at `position` on a signal given as a function of the sample index
+    template <typename Policy, typename Signal>
+    double interpolateAt(double position, Signal signal)
+    {
+        const auto index = static_cast<int>(std::floor(position));
+        std::array<double, Policy::numTaps> taps;
+        for (int k = 0; k < Policy::numTaps; ++k)
+            taps[static_cast<size_t>(k)] = signal(index - (Policy::numTaps / 2 - 1) + k);
+
+        return Policy::interpolate(taps.data(), position - index);
+    }
+
+    // RMS error reading a sine of `cyclesPerSample` at fractional positions
+    template <typename Policy>
+    double sineError(double cyclesPerSample)
+    {
+        const auto sine = [=](int n) { return std::sin(juce::MathConstants<double>::twoPi * cyclesPerSample * n); };
+
+        double sum = 0.0;
+        constexpr int numPoints = 1000;
+        for (int i = 0; i < numPoints; ++i)
+        {
+            const double position = 100.0 + i * 0.137;
+            const double error = interpolateAt<Policy>(position, sine) - std::sin(juce::MathConstants<double>::twoPi * cyclesPerSample * position);
+            sum += error * error;
+        }
+
+        return std::sqrt(sum / numPoints);
+    }
+
+    // Reads one head through the kernel across the end of the tape and compares every sample
+    // with the policy evaluated directly at the same position on what the tape holds
+    template <typename Policy>
+    double kernelError(TapeRingBuffer<float>::Storage storage = TapeRingBuffer<float>::Storage::native)
+    {
+        constexpr int numSamples = 61; // not a whole number of SIMD vectors
+        const auto signal = [](int n) { return static_cast<float>(0.7 * std::sin(0.05 * n) + 0.2 * std::sin(0.71 * n)); };
+
+        TapeRingBuffer<float> tape;
+        tape.prepare(1, 1000, TapeInterpolation::maxTaps, storage);
+        for (int i = 0; i < tape.getCapacity(); ++i)
+            tape.write(0, i, signal(i));
+
+        // Reads land on the last few hundred samples of the tape and the first few
+        tape.advance(20);
+        const int writeIndex = tape.getWritePosition();
+
+        TapeReadKernel<float> kernel;
+        kernel.prepare(64);
+        for (int i = 0; i < numSamples; ++i)
+        {
+            kernel.getDelayArray()[i] = 40.0f + 0.37f * static_cast<float>(i);
+            kernel.getModulationArray()[i] = 0.0f;
+        }
+
+        kernel.computeHeadPositions({ { {}, {}, { 1.0f, 1.0f } } }, writeIndex, tape.getMask(), numSamples);
+        const float* echo = tape.isCompact() ? kernel.readHeads<Policy>(tape.getCompactReadPointer(0), 0, numSamples)
+                                             : kernel.readHeads<Policy>(tape.getReadPointer(0), 0, numSamples);
+
+        // The tape is periodic in its capacity, so the wrapped signal is its sample n & mask
+        const auto wrapped = [&](int n) { return static_cast<double>(tape.read(0, n & tape.getMask())); };
+
+        double maxError = 0.0;
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const double position = writeIndex + i - static_cast<double>(kernel.getDelayArray()[i]);
+            maxError = juce::jmax(maxError, std::abs(echo[i] - interpolateAt<Policy>(position, wrapped)));
+        }
+
+        return maxError;
+    }
+}
+
+TEST_CASE ("Interpolation policies", "[dsp][interpolation]")
+{
+    SECTION ("DC passes at unity gain")
+    {
+        const auto dc = [](int) { return 0.5; };
+        for (double position : { 10.0, 10.25, 10.5, 10.999 })
+        {
+            CHECK(std::abs(interpolateAt<TapeInterpolation::Linear>(position, dc) - 0.5) < 1.0e-12);
+            CHECK(std::abs(interpolateAt<TapeInterpolation::Hermite>(position, dc) - 0.5) < 1.0e-12);
+            CHECK(std::abs(interpolateAt<TapeInterpolation::Lagrange<4>>(position, dc) - 0.5) < 1.0e-12);
+            CHECK(std::abs(interpolateAt<TapeInterpolation::Lagrange<6>>(position, dc) - 0.5) < 1.0e-12);
+            CHECK(std::abs(interpolateAt<TapeInterpolation::WindowedSinc>(position, dc) - 0.5) < 1.0e-6);
+        }
+    }
+
+    SECTION ("whole samples come back unchanged")
+    {
+        const auto noise = [](int n) { return std::sin(12.9898 * n) * 43758.5453 - std::floor(std::sin(12.9898 * n) * 43758.5453); };
+        CHECK(interpolateAt<TapeInterpolation::Hermite>(20.0, noise) == noise(20));
+        CHECK(std::abs(interpolateAt<TapeInterpolation::Lagrange<6>>(20.0, noise) - noise(20)) < 1.0e-12);
+        CHECK(std::abs(interpolateAt<TapeInterpolation::WindowedSinc>(20.0, noise) - noise(20)) < 1.0e-5);
+    }
+
+    SECTION ("Lagrange is exact on polynomials of its order")
+    {
+        const auto cubic = [](int n) { return 0.1 * n * n * n - n * n + 3.0 * n - 2.0; };
+        const auto quintic = [](int n) { const double x = n * 0.1; return x * x * x * x * x - 2.0 * x * x * x + x; };
+
+        for (double position : { 5.3, 7.77 })
+        {
+            const double expectedCubic = 0.1 * position * position * position - position * position + 3.0 * position - 2.0;
+            const double x = position * 0.1;
+            const double expectedQuintic = x * x * x * x * x - 2.0 * x * x * x + x;
+
+            CHECK(std::abs(interpolateAt<TapeInterpolation::Lagrange<4>>(position, cubic) - expectedCubic) < 1.0e-9);
+            CHECK(std::abs(interpolateAt<TapeInterpolation::Lagrange<6>>(position, quintic) - expectedQuintic) < 1.0e-9);
+        }
+    }
+
+    SECTION ("higher orders keep more of the top end")
+    {
+        // ~9.6 kHz at 48 kHz, where linear interpolation audibly dulls the echo
+        const double cyclesPerSample = 0.2;
+        const auto linear = sineError<TapeInterpolation::Linear>(cyclesPerSample);
+        const auto hermite = sineError<TapeInterpolation::Hermite>(cyclesPerSample);
+        const auto lagrange4 = sineError<TapeInterpolation::Lagrange<4>>(cyclesPerSample);
+        const auto lagrange6 = sineError<TapeInterpolation::Lagrange<6>>(cyclesPerSample);
+        const auto sinc = sineError<TapeInterpolation::WindowedSinc>(cyclesPerSample);
+
+        CHECK(hermite < linear);
+        CHECK(lagrange4 < linear);
+        CHECK(lagrange6 < lagrange4);
+        CHECK(sinc < lagrange6);
+        CHECK(sinc < 1.0e-3);
+    }
+}
+
+TEST_CASE ("Tape read kernel interpolation", "[dsp][interpolation]")
+{
+    SECTION ("every policy gathers the right taps across the tape end")
+    {
+        CHECK(kernelError<TapeInterpolation::Linear>() < 1.0e-5);
+        CHECK(kernelError<TapeInterpolation::Hermite>() < 1.0e-5);
+        CHECK(kernelError<TapeInterpolation::Lagrange<4>>() < 1.0e-5);
+        CHECK(kernelError<TapeInterpolation::Lagrange<6>>() < 1.0e-5);
+        CHECK(kernelError<TapeInterpolation::WindowedSinc>() < 1.0e-5);
+    }
+
+    SECTION ("a compact tape is widened in the gather")
+    {
+        constexpr auto compact = TapeRingBuffer<float>::Storage::compact16;
+        CHECK(kernelError<TapeInterpolation::Linear>(compact) < 1.0e-5);
+        CHECK(kernelError<TapeInterpolation::Lagrange<6>>(compact) < 1.0e-5);
+        CHECK(kernelError<TapeInterpolation::WindowedSinc>(compact) < 1.0e-5);
+    }
+
+    SECTION ("wider interpolators read in shorter runs")
+    {
+        TapeReadKernel<float> kernel;
+        kernel.prepare(512);
+        for (int i = 0; i < 512; ++i)
+        {
+            kernel.getDelayArray()[i] = 100.0f;
+            kernel.getModulationArray()[i] = 0.0f;
+        }
+
+        kernel.computeHeadPositions({ { { 1.0f, 1.0f }, {}, {} } }, 0, 1023, 512); // head 1 reads 36.4 samples back
+
+        const int linear = kernel.getSafeRunLength(512, TapeInterpolation::Linear::numTaps);
+        const int lagrange6 = kernel.getSafeRunLength(512, TapeInterpolation::Lagrange<6>::numTaps);
+        const int sinc = kernel.getSafeRunLength(512, TapeInterpolation::WindowedSinc::numTaps);
+
+        CHECK(linear == 32);
+        CHECK(lagrange6 == 32);
+        CHECK(sinc == 28);
+        CHECK(kernel.getNumTaps(TapeInterpolation::Quality::sinc) == TapeInterpolation::maxTaps);
+    }
+}
@@ -0,0 +1,110 @@
+#include <TapeReadKernel.h>
+#include <TapeRingBuffer.h>
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+
+namespace
+{
+    using Kernel = TapeReadKernel<float>;
+    using Gains = std::array<Kernel::HeadGain, Kernel::numHeads>;
+
+    constexpr int numSamples = 256;
+
+    struct Fixture
+    {
+        Fixture()
+        {
+            tape.prepare(1, 20000, TapeInterpolation::maxTaps);
+            juce::Random random(3);
+            for (int i = 0; i < tape.getCapacity(); ++i)
+                tape.write(0, i, random.nextFloat() - 0.5f);
+            tape.advance(777);
+
+            kernel.prepare(numSamples);
+        }
+
+        // Echo of one slice with the given head gains
+        std::vector<float> read(const Gains& gains)
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                kernel.getDelayArray()[i] = 9000.0f;
+                kernel.getModulationArray()[i] = 3.0f * std::sin(0.05f * static_cast<float>(i));
+            }
+
+            kernel.computeHeadPositions(gains, tape.getWritePosition(), tape.getMask(), numSamples);
+            const float* echo = kernel.readHeads(TapeInterpolation::Quality::hermite, tape.getReadPointer(0), 0, numSamples);
+            return { echo, echo + numSamples };
+        }
+
+        TapeRingBuffer<float> tape;
+        Kernel kernel;
+    };
+}
+
+TEST_CASE ("Tape read kernel head masks", "[dsp]")
+{
+    Fixture fixture;
+
+    const Kernel::HeadGain on { 0.5f, 0.5f };
+    std::array<std::vector<float>, Kernel::numHeads> single;
+    for (size_t head = 0; head < single.size(); ++head)
+    {
+        Gains gains {};
+        gains[head] = on;
+        single[head] = fixture.read(gains);
+        CHECK(fixture.kernel.getActiveHeads() == 1 << head);
+    }
+
+    SECTION ("every combination is the sum of its heads")
+    {
+        for (int mask = 1; mask < 1 << Kernel::numHeads; ++mask)
+        {
+            Gains gains {};
+            for (size_t head = 0; head < gains.size(); ++head)
+                if ((mask >> head) & 1)
+                    gains[head] = on;
+
+            const auto echo = fixture.read(gains);
+            CHECK(fixture.kernel.getActiveHeads() == mask);
+
+            float maxError = 0.0f;
+            for (int i = 0; i < numSamples; ++i)
+            {
+                float expected = 0.0f;
+                for (size_t head = 0; head < single.size(); ++head)
+                    if ((mask >> head) & 1)
+                        expected += single[head][static_cast<size_t>(i)];
+
+                maxError = juce::jmax(maxError, std::abs(echo[static_cast<size_t>(i)] - expected));
+            }
+
+            CHECK(maxError < 1.0e-6f);
+        }
+    }
+
+    SECTION ("no heads reads silence")
+    {
+        const auto echo = fixture.read({});
+        CHECK(fixture.kernel.getActiveHeads() == 0);
+        for (auto sample : echo)
+            CHECK(sample == 0.0f);
+    }
+
+    SECTION ("a head switched off fades out across the slice")
+    {
+        Gains gains {};
+        gains[1] = { 0.5f, 0.0f };
+        const auto echo = fixture.read(gains);
+        CHECK(fixture.kernel.getActiveHeads() == 2);
+
+        float maxError = 0.0f;
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float fade = 1.0f - static_cast<float>(i) / static_cast<float>(numSamples);
+            maxError = juce::jmax(maxError, std::abs(echo[static_cast<size_t>(i)] - fade * single[1][static_cast<size_t>(i)]));
+        }
+
+        CHECK(maxError < 1.0e-6f);
+    }
+}
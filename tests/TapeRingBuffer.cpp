@@ -0,0 +1,118 @@
+#include <TapeRingBuffer.h>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <vector>
+
+TEST_CASE ("Tape ring buffer", "[dsp]")
+{
+    TapeRingBuffer<float> tape;
+    tape.prepare(2, 1000, 4);
+
+    SECTION ("capacity is rounded up to a power of two")
+    {
+        CHECK(tape.getCapacity() == 1024);
+        CHECK(tape.getMask() == 1023);
+        CHECK(tape.wrap(1024 + 5) == 5);
+        CHECK(tape.wrap(-1) == 1023);
+    }
+
+    SECTION ("guard region mirrors the start of the tape")
+    {
+        for (int i = 0; i < tape.getCapacity(); ++i)
+            tape.write(1, i, static_cast<float>(i));
+
+        const float* data = tape.getReadPointer(1);
+        for (int k = 0; k < tape.getGuardSamples(); ++k)
+            CHECK(data[tape.getCapacity() + k] == static_cast<float>(k));
+
+        // Reading across the end never needs a wrap
+        CHECK(data[tape.getCapacity() - 1] == 1023.0f);
+        CHECK(data[tape.getCapacity()] == 0.0f);
+    }
+
+    SECTION ("write position wraps with the mask")
+    {
+        tape.advance(1000);
+        tape.advance(100);
+        CHECK(tape.getWritePosition() == 76);
+
+        tape.clear();
+        CHECK(tape.getWritePosition() == 0);
+    }
+
+    SECTION ("block writes wrap and keep the guard in sync")
+    {
+        std::vector<float> block(64);
+        for (size_t i = 0; i < block.size(); ++i)
+            block[i] = static_cast<float>(i);
+
+        tape.write(0, 1000, block.data(), 64); // 24 samples to the end, 40 from the start
+
+        const float* data = tape.getReadPointer(0);
+        CHECK(data[1000] == 0.0f);
+        CHECK(data[1023] == 23.0f);
+        CHECK(data[0] == 24.0f);
+        CHECK(data[39] == 63.0f);
+        for (int k = 0; k < tape.getGuardSamples(); ++k)
+            CHECK(data[tape.getCapacity() + k] == data[k]);
+    }
+}
+
+TEST_CASE ("Compact tape storage", "[dsp]")
+{
+    using Tape = TapeRingBuffer<double>;
+
+    Tape native, compact;
+    native.prepare(2, 1000, 4);
+    compact.prepare(2, 1000, 4, Tape::Storage::compact16);
+
+    SECTION ("takes a quarter of a double tape")
+    {
+        CHECK(compact.isCompact());
+        CHECK(compact.getCapacity() == native.getCapacity());
+        CHECK(compact.getSizeInBytes() * 4 == native.getSizeInBytes());
+    }
+
+    SECTION ("stores within a bit of the input, with the guard mirrored")
+    {
+        std::vector<double> block(static_cast<size_t>(compact.getCapacity()));
+        for (size_t i = 0; i < block.size(); ++i)
+            block[i] = 0.9 * std::sin(0.01 * static_cast<double>(i));
+
+        compact.write(1, 0, block.data(), compact.getCapacity());
+
+        double maxError = 0.0;
+        for (int i = 0; i < compact.getCapacity(); ++i)
+            maxError = std::max(maxError, std::abs(compact.read(1, i) - block[static_cast<size_t>(i)]));
+
+        // Rounding plus triangular dither: at most 1.5 LSB
+        CHECK(maxError <= 1.5 / 32767.0);
+
+        const auto* data = compact.getCompactReadPointer(1);
+        for (int k = 0; k < compact.getGuardSamples(); ++k)
+            CHECK(data[compact.getCapacity() + k] == data[k]);
+    }
+
+    SECTION ("dither decorrelates the error from the signal")
+    {
+        // A constant between two steps: plain rounding would always err the same way
+        const double level = 0.25 + 0.37 / 32767.0;
+        std::vector<double> block(1024, level);
+        compact.write(0, 0, block.data(), 1024);
+
+        double mean = 0.0;
+        for (int i = 0; i < 1024; ++i)
+            mean += compact.read(0, i);
+        mean /= 1024.0;
+
+        CHECK(std::abs(mean - level) < 0.1 / 32767.0);
+    }
+
+    SECTION ("clips at full scale")
+    {
+        compact.write(0, 5, 1.5);
+        compact.write(0, 6, -1.5);
+        CHECK(compact.read(0, 5) == 1.0);
+        CHECK(compact.read(0, 6) == -1.0);
+    }
+}
@@ -0,0 +1,156 @@
+#include <OversampledSaturator.h>
+#include <TapeSaturator.h>
+#include <juce_dsp/juce_dsp.h>
+#include <catch2/catch_test_macros.hpp>
+
+namespace
+{
+    // Energy in every bin that is not a harmonic of `fundamentalBin`, relative to the total.
+    // With a bin-centred sine, whatever lands elsewhere can only be aliasing.
+    template <typename Saturator>
+    float measureAliasing(Saturator& saturator, int fundamentalBin, float drive)
+    {
+        constexpr int order = 13;
+        constexpr int size = 1 << order;
+
+        // Two periods through the saturator so ADAA state has settled, keep the second
+        std::vector<float> processed(2 * size);
+        for (int i = 0; i < 2 * size; ++i)
+            processed[static_cast<size_t>(i)] = 0.9f * std::sin(juce::MathConstants<float>::twoPi * static_cast<float>((fundamentalBin * i) % size) / size);
+
+        saturator.process(0, processed.data(), 2 * size, drive);
+
+        std::vector<float> signal(2 * size, 0.0f); // FFT works in place on 2 * size floats
+        std::copy(processed.begin() + size, processed.end(), signal.begin());
+
+        juce::dsp::FFT fft(order);
+        fft.performFrequencyOnlyForwardTransform(signal.data(), true);
+
+        double total = 0.0, aliased = 0.0;
+        for (int bin = 1; bin < size / 2; ++bin)
+        {
+            const double energy = static_cast<double>(signal[static_cast<size_t>(bin)]) * signal[static_cast<size_t>(bin)];
+            total += energy;
+            if (bin % fundamentalBin != 0)
+                aliased += energy;
+        }
+
+        return static_cast<float>(aliased / total);
+    }
+}
+
+TEST_CASE ("Fast tanh stays within its error bound", "[saturation]")
+{
+    float maxError = 0.0f;
+    for (float x = -20.0f; x <= 20.0f; x += 0.001f)
+    {
+        const float y = TapeSaturator::fastTanh(x);
+        maxError = juce::jmax(maxError, std::abs(y - std::tanh(x)));
+
+        CHECK(std::abs(y) <= 1.0f);
+        CHECK(TapeSaturator::fastTanh(-x) == -y);
+    }
+
+    CHECK(maxError < 2.0e-4f);
+}
+
+TEST_CASE ("Fast tanh is monotonic", "[saturation]")
+{
+    float previous = TapeSaturator::fastTanh(-10.0f);
+    for (float x = -10.0f; x <= 10.0f; x += 0.0005f)
+    {
+        const float y = TapeSaturator::fastTanh(x);
+        CHECK(y >= previous - 2.0e-7f); // up to float rounding near +-1
+        previous = y;
+    }
+}
+
+TEST_CASE ("Block processing matches the scalar function", "[saturation]")
+{
+    std::vector<float> data(1000);
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = static_cast<float>(i) * 0.004f - 2.0f;
+
+    auto expected = data;
+    for (auto& x : expected)
+        x = TapeSaturator::fastTanh(x * 3.0f);
+
+    TapeSaturator saturator;
+    saturator.prepare(1);
+    saturator.process(0, data.data(), static_cast<int>(data.size()), 3.0f);
+
+    float maxDifference = 0.0f;
+    for (size_t i = 0; i < data.size(); ++i)
+        maxDifference = juce::jmax(maxDifference, std::abs(data[i] - expected[i]));
+
+    // Vectorised and scalar code may contract to FMA differently
+    CHECK(maxDifference < 1.0e-6f);
+}
+
+TEST_CASE ("ADAA tracks tanh on slowly varying input", "[saturation]")
+{
+    TapeSaturator saturator;
+    saturator.prepare(2);
+    saturator.setMode(TapeSaturator::Mode::antialiased);
+
+    // Constant input: the midpoint fallback gives tanh exactly
+    std::vector<float> constant(64, 0.5f);
+    saturator.process(1, constant.data(), 64, 2.0f);
+    CHECK(std::abs(constant.back() - std::tanh(1.0f)) < 2.0e-4f);
+
+    // A slow ramp: ADAA is tanh of the half-sample-delayed input
+    std::vector<float> ramp(512);
+    for (size_t i = 0; i < ramp.size(); ++i)
+        ramp[i] = static_cast<float>(i) / 256.0f - 1.0f;
+
+    auto input = ramp;
+    saturator.reset();
+    saturator.process(0, ramp.data(), static_cast<int>(ramp.size()), 2.0f);
+
+    float maxError = 0.0f;
+    for (size_t i = 1; i < ramp.size(); ++i)
+    {
+        const float midpoint = 0.5f * (input[i] + input[i - 1]) * 2.0f;
+        maxError = juce::jmax(maxError, std::abs(ramp[i] - std::tanh(midpoint)));
+    }
+    CHECK(maxError < 1.0e-4f);
+}
+
+TEST_CASE ("ADAA reduces aliasing at high drive", "[saturation]")
+{
+    // ~5 kHz at 48 kHz: plenty of odd harmonics fold back below Nyquist
+    constexpr int fundamentalBin = 853;
+    constexpr float drive = 6.0f; // maximum saturation
+
+    TapeSaturator fast;
+    fast.prepare(1);
+
+    TapeSaturator antialiased;
+    antialiased.prepare(1);
+    antialiased.setMode(TapeSaturator::Mode::antialiased);
+
+    const float fastAliasing = measureAliasing(fast, fundamentalBin, drive);
+    const float adaaAliasing = measureAliasing(antialiased, fundamentalBin, drive);
+
+    // At least 3 dB less aliased energy (first-order ADAA measures around 5 dB here)
+    CHECK(adaaAliasing < fastAliasing * 0.5f);
+}
+
+TEST_CASE ("Oversampled saturation aliases far less", "[saturation]")
+{
+    constexpr int fundamentalBin = 853;
+    constexpr float drive = 6.0f;
+
+    TapeSaturator fast;
+    fast.prepare(1);
+
+    OversampledSaturator<float> oversampled;
+    oversampled.prepare(1, 2 << 13);
+
+    const float fastAliasing = measureAliasing(fast, fundamentalBin, drive);
+    const float oversampledAliasing = measureAliasing(oversampled, fundamentalBin, drive);
+
+    // Only the 5th harmonic, right at Nyquist, still reaches the half-band transitions
+    CHECK(oversampledAliasing < fastAliasing * 0.25f);
+    CHECK(oversampled.getLatencyInSamples() > 0.0f);
+}
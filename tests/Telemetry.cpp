@@ -0,0 +1,110 @@
+#include <SpectrumAnalyser.h>
+#include <Telemetry.h>
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+
+TEST_CASE ("Telemetry frames", "[telemetry]")
+{
+    TelemetryFifo fifo;
+    TelemetryAccumulator accumulator;
+    accumulator.prepare(48000.0); // 240-sample frames
+
+    std::vector<float> samples(64, 0.0f);
+    const float* channels[] = { samples.data() };
+
+    SECTION ("short slices are merged and a transient survives decimation")
+    {
+        for (int slice = 0; slice < 4; ++slice)
+        {
+            std::fill(samples.begin(), samples.end(), 0.0f);
+            if (slice == 1)
+                samples[10] = 0.9f; // one-sample spike in one slice
+
+            accumulator.addInput(channels, 1, 64);
+            accumulator.addOutput(channels, 1, 64);
+            accumulator.endSlice(64, fifo);
+        }
+
+        // 256 samples in: exactly one frame out
+        std::vector<TelemetryFrame> frames;
+        CHECK(fifo.popAll([&](const TelemetryFrame& f) { frames.push_back(f); }) == 1);
+        REQUIRE(frames.size() == 1);
+        CHECK(frames[0].numSamples == 256);
+        CHECK(frames[0].inputPeak == 0.9f);
+        CHECK(std::abs(frames[0].inputRms - 0.9f / 16.0f) < 1.0e-6f);
+    }
+
+    SECTION ("head levels keep the loudest slice")
+    {
+        accumulator.addHeadLevels({ 0.1f, 0.5f, 0.0f });
+        accumulator.addHeadLevels({ 0.3f, 0.2f, 0.0f });
+        accumulator.setFeedbackGain(0.7f);
+        accumulator.endSlice(480, fifo);
+
+        TelemetryFrame frame;
+        fifo.popAll([&](const TelemetryFrame& f) { frame = f; });
+        CHECK(frame.headLevels[0] == 0.3f);
+        CHECK(frame.headLevels[1] == 0.5f);
+        CHECK(frame.headLevels[2] == 0.0f);
+        CHECK(frame.feedbackGain == 0.7f);
+    }
+
+    SECTION ("a full FIFO drops new frames instead of blocking")
+    {
+        TelemetryFrame frame;
+        int pushed = 0;
+        for (int i = 0; i < TelemetryFifo::capacity + 10; ++i)
+            pushed += fifo.push(frame) ? 1 : 0;
+
+        CHECK(pushed == TelemetryFifo::capacity - 1);
+        CHECK(fifo.getNumDropped() == 11);
+        CHECK(fifo.popAll([](const TelemetryFrame&) {}) == pushed);
+        CHECK(fifo.push(frame));
+    }
+}
+
+TEST_CASE ("Wet spectrum analyser", "[telemetry]")
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int bin = 64; // 1500 Hz, right on a bin
+
+    SpectrumAnalyser analyser;
+    analyser.prepare(sampleRate);
+
+    std::vector<float> block(512);
+    const float* channels[] = { block.data() };
+
+    // Nothing is queued while the analyser is inactive
+    analyser.pushSamples(channels, 1, 512);
+
+    analyser.setActive(true);
+
+    SpectrumAnalyser::Spectrum spectrum {};
+    juce::uint32 version = 0;
+    int sampleIndex = 0;
+
+    for (int attempt = 0; attempt < 200 && version < 3; ++attempt)
+    {
+        for (auto& sample : block)
+        {
+            sample = 0.5f * std::sin(juce::MathConstants<float>::twoPi * static_cast<float>((bin * sampleIndex) % SpectrumAnalyser::fftSize) / static_cast<float>(SpectrumAnalyser::fftSize));
+            ++sampleIndex;
+        }
+
+        analyser.pushSamples(channels, 1, 512);
+        juce::Thread::sleep(5);
+        analyser.getLatestSpectrum(spectrum, version);
+    }
+
+    analyser.setActive(false);
+    REQUIRE(version > 0);
+
+    // A -6 dBFS sine reads close to -6 dB in its bin, and far below that elsewhere
+    CHECK(std::abs(spectrum[bin] - (-6.02f)) < 0.5f);
+    CHECK(spectrum[bin * 4] < -60.0f);
+
+    // Nothing new to show: the version stays put
+    const auto settled = version;
+    CHECK_FALSE(analyser.getLatestSpectrum(spectrum, version));
+    CHECK(version == settled);
+}